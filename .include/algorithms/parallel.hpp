@@ -0,0 +1,333 @@
+#ifndef ALGORITHMS_PARALLEL_HPP
+#define ALGORITHMS_PARALLEL_HPP
+
+#include "../rt/thread_pool.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace asl::algorithms::parallel {
+
+    // Contiguous ranges: `containers::vector<T>`, `containers::basic_string<C>`, `std::vector<T>`, `std::span<T>`, arrays...
+    template<typename R>
+    concept a_contiguous_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>;
+
+    // A contiguous range that can be written to
+    template<typename R>
+    concept an_output_range = a_contiguous_range<R> && !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal {
+
+        // Elements per job: `grain` if given, otherwise about 8 jobs per worker so stealing can even things out
+        inline std::size_t grain_of(const std::size_t grain, const std::size_t n, const rt::thread_pool& pool, const std::size_t at_least = 1) noexcept {
+            if (grain) return grain;
+            return std::max(n / (8 * pool.size()), at_least);
+        }
+
+        // Whether the pool is worth it at all
+        inline bool sequential(const std::size_t n, const std::size_t grain, const rt::thread_pool& pool) noexcept {
+            return n <= grain || pool.size() < 2;
+        }
+
+        // Call `f(begin, end)` on pieces of [begin, end) of at most `grain`, halving recursively through `invoke()`
+        template<typename F>
+        void split(rt::thread_pool& pool, const std::size_t begin, const std::size_t end, const std::size_t grain, F& f) {
+            if (end - begin <= grain) {
+                f(begin, end);
+                return;
+            }
+            const std::size_t mid = begin + (end - begin) / 2;
+            pool.invoke([&] { split(pool, begin, mid, grain, f); }, [&] { split(pool, mid, end, grain, f); });
+        }
+
+        // Same, from anywhere: on the pool when it is worth it, inline otherwise
+        template<typename F>
+        void chunks(rt::thread_pool& pool, const std::size_t n, const std::size_t grain, F&& f) {
+            if (n == 0) return;
+            if (sequential(n, grain, pool)) {
+                f(std::size_t(0), n);
+                return;
+            }
+            pool.run([&] { split(pool, 0, n, grain, f); });
+        }
+
+        template<typename R>
+        inline void same_size(const char* where, const std::size_t n, const R& r) {
+            if (std::ranges::size(r) != n)
+                throw std::runtime_error(std::string("asl::algorithms::parallel::") + where + "(): Sizes differ.");
+        }
+
+        // Reduce [p, p + n) without an initial value (n > 0)
+        template<typename T, typename E, typename Op>
+        T fold(const E* p, const std::size_t n, Op& op) {
+            T acc = static_cast<T>(p[0]);
+            for (std::size_t i = 1; i < n; ++i) acc = op(std::move(acc), p[i]);
+            return acc;
+        }
+
+        template<typename T, typename E, typename Op>
+        T reduce(rt::thread_pool& pool, const E* p, const std::size_t n, const std::size_t grain, Op& op) {
+            if (n <= grain) return fold<T>(p, n, op);
+
+            const std::size_t half = n / 2;
+            std::optional<T> left, right;
+            pool.invoke([&] { left.emplace(reduce<T>(pool, p, half, grain, op)); },
+                        [&] { right.emplace(reduce<T>(pool, p + half, n - half, grain, op)); });
+            return op(std::move(*left), std::move(*right));
+        }
+
+        // Scratch space as big as [p, p + n): left uninitialized when `T` allows it, otherwise the elements are moved into it (then `moved`)
+        template<typename T>
+        struct scratch {
+            static constexpr bool raw = std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>;
+
+            std::unique_ptr<T[]> raw_;
+            std::vector<T> moved_;
+            T* data;
+            bool moved = !raw;
+
+            scratch(T* p, const std::size_t n) {
+                if constexpr (raw) {
+                    raw_ = std::make_unique_for_overwrite<T[]>(n);
+                    data = raw_.get();
+                } else {
+                    moved_.assign(std::make_move_iterator(p), std::make_move_iterator(p + n));
+                    data = moved_.data();
+                }
+            }
+        };
+
+        // Merge [a, a_end) and [b, b_end) into `out`, splitting the larger one at its middle (stable: ties go to `a` first)
+        template<typename T, typename Compare>
+        void merge(rt::thread_pool& pool, T* a, T* a_end, T* b, T* b_end, T* out, const std::size_t grain, Compare& comp) {
+            const std::size_t na = static_cast<std::size_t>(a_end - a), nb = static_cast<std::size_t>(b_end - b);
+            if (na + nb <= grain) {
+                std::merge(std::make_move_iterator(a), std::make_move_iterator(a_end), std::make_move_iterator(b), std::make_move_iterator(b_end), out, comp);
+                return;
+            }
+
+            T *a_mid, *b_mid;
+            if (na >= nb) {
+                a_mid = a + na / 2;
+                b_mid = std::lower_bound(b, b_end, *a_mid, comp);
+            } else {
+                b_mid = b + nb / 2;
+                a_mid = std::upper_bound(a, a_end, *b_mid, comp);
+            }
+
+            T* out_mid = out + (a_mid - a) + (b_mid - b);
+            pool.invoke([&] { merge(pool, a, a_mid, b, b_mid, out, grain, comp); },
+                        [&] { merge(pool, a_mid, a_end, b_mid, b_end, out_mid, grain, comp); });
+        }
+
+        // Sort [src, src + n), leaving the result in `dst` if `to_dst` (in `src` otherwise), the other one is scratch
+        template<typename T, typename Compare>
+        void merge_sort(rt::thread_pool& pool, T* src, T* dst, const std::size_t n, const bool to_dst, const std::size_t grain, Compare& comp) {
+            if (n <= grain) {
+                std::sort(src, src + n, comp);
+                if (to_dst) std::move(src, src + n, dst);
+                return;
+            }
+
+            const std::size_t half = n / 2;
+            pool.invoke([&] { merge_sort(pool, src, dst, half, !to_dst, grain, comp); },
+                        [&] { merge_sort(pool, src + half, dst + half, n - half, !to_dst, grain, comp); });
+
+            T* from = to_dst ? src : dst;
+            T* into = to_dst ? dst : src;
+            merge(pool, from, from + half, from + half, from + n, into, grain, comp);
+        }
+
+        // Inclusive / exclusive scan in three steps: chunk totals in parallel, their prefix in order, then each chunk from its carry
+        // @note Every element is read before its output is written, so `in` and `out` may be the same
+        template<typename T, typename E, typename O, typename Op>
+        void scan(rt::thread_pool& pool, const E* in, O* out, const std::size_t n, std::size_t grain, std::optional<T> carry, Op& op) {
+            const bool inclusive = !carry.has_value();
+            const auto chunk = [&](const std::size_t begin, const std::size_t end, std::optional<T> c) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    T v = static_cast<T>(in[i]);
+                    if (inclusive) {
+                        c = c ? op(std::move(*c), std::move(v)) : std::move(v);
+                        out[i] = *c;
+                    } else {
+                        out[i] = *c;
+                        c = op(std::move(*c), std::move(v));
+                    }
+                }
+            };
+
+            if (sequential(n, grain, pool)) {
+                chunk(0, n, std::move(carry));
+                return;
+            }
+
+            const std::size_t count = (n + grain - 1) / grain;
+            grain = (n + count - 1) / count;
+            std::vector<std::optional<T>> carries(count);
+
+            pool.run([&] {
+                auto totals = [&](const std::size_t first, const std::size_t last) {
+                    for (std::size_t k = first; k < last; ++k) {
+                        const std::size_t begin = k * grain;
+                        if (k + 1 < count) carries[k + 1].emplace(fold<T>(in + begin, std::min(grain, n - begin), op));
+                    }
+                };
+                split(pool, 0, count, 1, totals);
+
+                carries[0] = std::move(carry);
+                for (std::size_t k = 1; k < count; ++k)
+                    if (carries[k - 1]) carries[k] = op(*carries[k - 1], std::move(*carries[k]));
+
+                auto apply = [&](const std::size_t first, const std::size_t last) {
+                    for (std::size_t k = first; k < last; ++k) {
+                        const std::size_t begin = k * grain;
+                        chunk(begin, std::min(begin + grain, n), std::move(carries[k]));
+                    }
+                };
+                split(pool, 0, count, 1, apply);
+            });
+        }
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region Element-wise
+
+    // Call `f(element)` on every element, in parallel
+    // @param grain Elements per job (default: about 8 jobs per worker)
+    // @param pool Where to run (default: the shared pool)
+    template<a_contiguous_range R, typename F>
+    void for_each(R&& r, F f, const std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        const std::size_t n = std::ranges::size(r);
+        auto* p = std::ranges::data(r);
+        _internal::chunks(pool, n, _internal::grain_of(grain, n, pool), [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) f(p[i]);
+        });
+    }
+
+    // Call `f(span)` on consecutive pieces of at most `grain` elements, in parallel
+    // @note For kernels that want a whole slice at once (the `math::` batch functions, say)
+    template<a_contiguous_range R, typename F>
+    void for_each_chunk(R&& r, F f, const std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        const std::size_t n = std::ranges::size(r);
+        auto* p = std::ranges::data(r);
+        _internal::chunks(pool, n, _internal::grain_of(grain, n, pool), [&](const std::size_t begin, const std::size_t end) {
+            f(std::span(p + begin, end - begin));
+        });
+    }
+
+    // out[i] = f(in[i]), in parallel
+    // @note `in` and `out` may be the same range
+    template<a_contiguous_range In, an_output_range Out, typename F>
+    void transform(const In& in, Out&& out, F f, const std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        const std::size_t n = std::ranges::size(in);
+        _internal::same_size("transform", n, out);
+
+        const auto* src = std::ranges::data(in);
+        auto* dst = std::ranges::data(out);
+        _internal::chunks(pool, n, _internal::grain_of(grain, n, pool), [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) dst[i] = f(src[i]);
+        });
+    }
+
+    #pragma endregion
+
+
+
+
+
+    #pragma region Reductions
+
+    // `init` combined with every element through `op`, in parallel
+    // @note `op` must be associative (not commutative): chunks are combined in order, but grouped differently than a loop would
+    // @note Floating-point sums may then differ from a sequential loop in the last bits
+    template<a_contiguous_range R, typename T, typename Op = std::plus<>>
+    T reduce(const R& r, T init, Op op = {}, std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        const std::size_t n = std::ranges::size(r);
+        if (n == 0) return init;
+
+        const auto* p = std::ranges::data(r);
+        grain = _internal::grain_of(grain, n, pool);
+        if (_internal::sequential(n, grain, pool))
+            return op(std::move(init), _internal::fold<T>(p, n, op));
+
+        std::optional<T> total;
+        pool.run([&] { total.emplace(_internal::reduce<T>(pool, p, n, grain, op)); });
+        return op(std::move(init), std::move(*total));
+    }
+
+    // Inclusive scan: out[i] = in[0] `op` ... `op` in[i], in parallel
+    // @note `in` and `out` may be the same range, `op` must be associative
+    template<a_contiguous_range In, an_output_range Out, typename Op = std::plus<>>
+    void scan(const In& in, Out&& out, Op op = {}, const std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        using T = std::ranges::range_value_t<Out>;
+        const std::size_t n = std::ranges::size(in);
+        _internal::same_size("scan", n, out);
+        if (n == 0) return;
+
+        _internal::scan<T>(pool, std::ranges::data(in), std::ranges::data(out), n, _internal::grain_of(grain, n, pool, 1024), std::optional<T>(), op);
+    }
+
+    // Exclusive scan: out[0] = init, out[i] = init `op` in[0] `op` ... `op` in[i - 1], in parallel
+    // @note `in` and `out` may be the same range, `op` must be associative
+    template<a_contiguous_range In, an_output_range Out, typename T = std::ranges::range_value_t<Out>, typename Op = std::plus<>>
+    void exclusive_scan(const In& in, Out&& out, T init, Op op = {}, const std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        const std::size_t n = std::ranges::size(in);
+        _internal::same_size("exclusive_scan", n, out);
+        if (n == 0) return;
+
+        _internal::scan<T>(pool, std::ranges::data(in), std::ranges::data(out), n, _internal::grain_of(grain, n, pool, 1024), std::optional<T>(std::move(init)), op);
+    }
+
+    #pragma endregion
+
+
+
+
+
+    #pragma region Sort
+
+    // Sort in parallel: pieces of `grain` go through `std::sort`, then get merged pairwise (merges are split in parallel too)
+    // @note Not stable (the pieces are not), needs scratch space as big as the range
+    template<an_output_range R, typename Compare = std::less<>>
+    void sort(R&& r, Compare comp = {}, std::size_t grain = 0, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(r);
+        T* p = std::ranges::data(r);
+
+        grain = _internal::grain_of(grain, n, pool, 4096);
+        if (_internal::sequential(n, grain, pool)) {
+            std::sort(p, p + n, comp);
+            return;
+        }
+
+        _internal::scratch<T> tmp(p, n);
+        pool.run([&] {
+            if (tmp.moved) _internal::merge_sort(pool, tmp.data, p, n, true, grain, comp);
+            else _internal::merge_sort(pool, p, tmp.data, n, false, grain, comp);
+        });
+    }
+
+    #pragma endregion
+}
+
+#endif
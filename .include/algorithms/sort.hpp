@@ -0,0 +1,581 @@
+#ifndef ALGORITHMS_SORT_HPP
+#define ALGORITHMS_SORT_HPP
+
+#include "../types/object.hpp"
+#include "../rt/thread_pool.hpp"
+#include "./parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace asl::algorithms::sort {
+
+    // Keys `radix()` sorts: integers (not bool), float and double
+    template<typename T>
+    concept a_radix_key = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float> || std::same_as<T, double>;
+
+    // Contiguous ranges of radix keys: `containers::vector<std::uint64_t>`, `std::vector<double>`, `std::span<int>`...
+    template<typename R>
+    concept a_key_range = parallel::an_output_range<R> && a_radix_key<std::ranges::range_value_t<R>>;
+
+    // Character types
+    template<typename C>
+    concept a_char = std::same_as<C, char> || std::same_as<C, signed char> || std::same_as<C, unsigned char> || std::same_as<C, wchar_t> ||
+                     std::same_as<C, char8_t> || std::same_as<C, char16_t> || std::same_as<C, char32_t>;
+
+    // Something holding characters contiguously: `containers::basic_string<C>`, `std::basic_string<C>`, `std::basic_string_view<C>`...
+    template<typename S>
+    concept a_string_like = std::ranges::contiguous_range<const S> && std::ranges::sized_range<const S> &&
+                            a_char<std::remove_cv_t<std::ranges::range_value_t<const S>>>;
+
+    // Contiguous ranges of strings
+    template<typename R>
+    concept a_string_range = parallel::an_output_range<R> && a_string_like<std::ranges::range_value_t<R>>;
+
+
+
+    // Reusable scratch memory for the sorts below, for when many batches get sorted one after another
+    // @note Only grows (up to the largest batch seen), `release()` gives it back
+    class arena final : private types::object<arena> {
+        struct free_ {
+            void operator()(std::byte* p) const noexcept {
+                ::operator delete(p, std::align_val_t(64));
+            }
+        };
+
+        std::unique_ptr<std::byte, free_> memory_;
+        std::size_t size_ = 0;
+
+    public:
+        arena() noexcept = default;
+
+        // @param bytes Reserved up front
+        explicit arena(const std::size_t bytes) {
+            take<std::byte>(bytes);
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        // Room for `n` objects of `T`, cache-line aligned, uninitialized
+        // @note What an earlier `take()` returned is gone
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        T* take(const std::size_t n) {
+            const std::size_t bytes = n * sizeof(T);
+            if (bytes > size_) {
+                memory_.reset();
+                size_ = 0;
+                memory_.reset(static_cast<std::byte*>(::operator new(bytes, std::align_val_t(64))));
+                size_ = bytes;
+            }
+            return reinterpret_cast<T*>(memory_.get());
+        }
+
+        std::size_t capacity() const noexcept {
+            return size_;
+        }
+
+        void release() noexcept {
+            memory_.reset();
+            size_ = 0;
+        }
+    };
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal {
+
+        // Scratch for `n` trivially copyable `T`: the container's spare capacity if it has enough, then the arena, then a new allocation
+        template<typename T>
+        struct scratch {
+            std::unique_ptr<T[]> owned_;
+            T* data;
+
+            template<typename R>
+            scratch(R& r, arena* a, const std::size_t n) {
+                if constexpr (requires { { r.slot() } -> std::convertible_to<std::size_t>; }) {
+                    // contiguous_storage: the slots past size() are allocated, just unused
+                    if (r.slot() - std::ranges::size(r) >= n) {
+                        data = std::ranges::data(r) + std::ranges::size(r);
+                        return;
+                    }
+                }
+                if (a) {
+                    data = a->take<T>(n);
+                    return;
+                }
+                owned_ = std::make_unique_for_overwrite<T[]>(n);
+                data = owned_.get();
+            }
+
+            scratch(arena* a, const std::size_t n) {
+                if (a) data = a->take<T>(n);
+                else {
+                    owned_ = std::make_unique_for_overwrite<T[]>(n);
+                    data = owned_.get();
+                }
+            }
+        };
+
+
+
+        #pragma region Radix
+        // Keys as unsigned integers in the same order: sign bit flipped for signed ones, all bits flipped for negative floats
+        template<typename T>
+        struct radix_key {
+            using type = std::make_unsigned_t<std::conditional_t<std::is_floating_point_v<T>, std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>, T>>;
+            static constexpr type sign = type(1) << (sizeof(T) * 8 - 1);
+
+            static type of(const T x) noexcept {
+                if constexpr (std::is_floating_point_v<T>) {
+                    const type u = std::bit_cast<type>(x);
+                    return (u & sign) ? ~u : (u | sign);
+                } else if constexpr (std::is_signed_v<T>) return static_cast<type>(x) ^ sign;
+                else return x;
+            }
+        };
+
+        using histogram = std::array<std::size_t, 256>;
+
+        template<typename T>
+        inline std::size_t digit(const T x, const unsigned shift) noexcept {
+            return static_cast<std::size_t>((radix_key<T>::of(x) >> shift) & 0xFF);
+        }
+
+        // Below this, the staging buffers cost more than they save
+        inline constexpr std::size_t buffered_scatter = std::size_t(1) << 14;
+
+        // Staged elements per digit: 8 cache lines, so 128 KiB for all 256 digits (about L2)
+        template<typename T>
+        inline constexpr std::size_t staged = 512 / sizeof(T);
+
+        template<typename T>
+        using staging = std::unique_ptr<T[]>;
+
+        template<typename T>
+        staging<T> make_staging() {
+            return std::make_unique_for_overwrite<T[]>(256 * staged<T>);
+        }
+
+        // Move [src, src + n) to `dst` by digit, `offsets` being where each digit goes next
+        // @note Elements gather in a few cache lines per digit first (`lines`, from `make_staging()`), then go out together:
+        //       256 streams of single stores thrash the cache and above all the TLB, one page walk per 8 lines does not
+        template<typename T>
+        void scatter(const T* src, const std::size_t n, T* dst, histogram& offsets, const unsigned shift, T* lines) noexcept {
+            if (n < buffered_scatter) {
+                for (std::size_t i = 0; i < n; ++i) dst[offsets[digit(src[i], shift)]++] = src[i];
+                return;
+            }
+
+            constexpr std::size_t per_digit = staged<T>;
+            std::array<std::uint32_t, 256> filled{};
+
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t d = digit(src[i], shift);
+                T* line = lines + d * per_digit;
+                line[filled[d]] = src[i];
+                if (++filled[d] == per_digit) {
+                    std::memcpy(dst + offsets[d], line, per_digit * sizeof(T));
+                    offsets[d] += per_digit;
+                    filled[d] = 0;
+                }
+            }
+            for (std::size_t d = 0; d < 256; ++d) {
+                std::memcpy(dst + offsets[d], lines + d * per_digit, filled[d] * sizeof(T));
+                offsets[d] += filled[d];
+            }
+        }
+
+        // One pass per byte, least significant first; all histograms come from one read, and passes where every key has the same byte are skipped
+        template<typename T>
+        void radix_sequential(T* data, T* tmp, const std::size_t n) {
+            constexpr unsigned passes = sizeof(T);
+            std::array<histogram, passes> counts{};
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto key = radix_key<T>::of(data[i]);
+                for (unsigned p = 0; p < passes; ++p) ++counts[p][(key >> (8 * p)) & 0xFF];
+            }
+
+            const staging<T> lines = n < buffered_scatter ? nullptr : make_staging<T>();
+            T* src = data;
+            T* dst = tmp;
+            for (unsigned p = 0; p < passes; ++p) {
+                if (counts[p][digit(src[0], 8 * p)] == n) continue;
+
+                histogram offsets;
+                std::size_t sum = 0;
+                for (std::size_t d = 0; d < 256; ++d) {
+                    offsets[d] = sum;
+                    sum += counts[p][d];
+                }
+                scatter(src, n, dst, offsets, 8 * p, lines.get());
+                std::swap(src, dst);
+            }
+            if (src != data) std::memcpy(data, src, n * sizeof(T));
+        }
+
+        // Same passes, each one split in blocks: every block counts its digits, then scatters to its own offsets (digit-major, block-minor, so it stays stable)
+        template<typename T>
+        void radix_parallel(T* data, T* tmp, const std::size_t n, const std::size_t blocks, rt::thread_pool& pool) {
+            const std::size_t per_block = (n + blocks - 1) / blocks;
+            std::vector<histogram> counts(blocks);
+
+            T* src = data;
+            T* dst = tmp;
+            for (unsigned p = 0; p < sizeof(T); ++p) {
+                const unsigned shift = 8 * p;
+                parallel::_internal::chunks(pool, blocks, 1, [&](const std::size_t first, const std::size_t last) {
+                    for (std::size_t b = first; b < last; ++b) {
+                        histogram& c = counts[b];
+                        c.fill(0);
+                        const std::size_t begin = b * per_block, end = std::min(begin + per_block, n);
+                        for (std::size_t i = begin; i < end; ++i) ++c[digit(src[i], shift)];
+                    }
+                });
+
+                std::size_t sum = 0;
+                bool trivial = false;
+                for (std::size_t d = 0; d < 256; ++d) {
+                    std::size_t total = 0;
+                    for (std::size_t b = 0; b < blocks; ++b) {
+                        const std::size_t c = counts[b][d];
+                        counts[b][d] = sum + total;
+                        total += c;
+                    }
+                    trivial |= total == n;
+                    sum += total;
+                }
+                if (trivial) continue;
+
+                parallel::_internal::chunks(pool, blocks, 1, [&](const std::size_t first, const std::size_t last) {
+                    const staging<T> lines = make_staging<T>();
+                    for (std::size_t b = first; b < last; ++b) {
+                        const std::size_t begin = b * per_block, end = std::min(begin + per_block, n);
+                        if (begin < end) scatter(src + begin, end - begin, dst, counts[b], shift, lines.get());
+                    }
+                });
+                std::swap(src, dst);
+            }
+
+            if (src != data)
+                parallel::_internal::chunks(pool, blocks, 1, [&](const std::size_t first, const std::size_t last) {
+                    const std::size_t begin = first * per_block, end = std::min(last * per_block, n);
+                    if (begin < end) std::memcpy(data + begin, src + begin, (end - begin) * sizeof(T));
+                });
+        }
+        #pragma endregion
+
+
+
+        #pragma region Strings
+        // A string as the sort sees it: the next few characters packed in one word, where the rest is, and where it came from
+        // @note Partitioning only ever reads `word`: the characters themselves are touched once per `per_word` of them, not once per comparison
+        template<typename C>
+        struct string_key {
+            std::uint64_t word;
+            const C* chars;
+            std::size_t size;
+            std::size_t index;
+        };
+
+        template<typename C>
+        inline constexpr std::size_t per_word = 8 / sizeof(C);
+
+        // Characters [d, d + per_word) of `k` as an unsigned number in the same order (big-endian, zeros past the end)
+        template<typename C>
+        inline void load_word(string_key<C>& k, const std::size_t d) noexcept {
+            using U = std::make_unsigned_t<C>;
+            const std::size_t left = std::min(k.size - d, per_word<C>);
+            if constexpr (sizeof(C) == 1) {
+                std::uint64_t w = 0;
+                std::memcpy(&w, k.chars + d, left);
+                if constexpr (std::endian::native == std::endian::little) w = __builtin_bswap64(w);
+                k.word = w;
+            } else {
+                std::uint64_t w = 0;
+                for (std::size_t i = 0; i < left; ++i)
+                    w |= static_cast<std::uint64_t>(static_cast<U>(k.chars[d + i])) << (64 - 8 * sizeof(C) * (i + 1));
+                k.word = w;
+            }
+        }
+
+        // Characters of `k` left in its word at depth d: equal words still differ when one string ends early (zeros vs real '\0's)
+        template<typename C>
+        inline std::size_t left_at(const string_key<C>& k, const std::size_t d) noexcept {
+            return std::min(k.size - d, per_word<C>);
+        }
+
+        template<typename C>
+        inline bool word_less(const string_key<C>& a, const string_key<C>& b, const std::size_t d) noexcept {
+            return a.word != b.word ? a.word < b.word : left_at(a, d) < left_at(b, d);
+        }
+
+        template<typename C>
+        inline bool word_equal(const string_key<C>& a, const string_key<C>& b, const std::size_t d) noexcept {
+            return a.word == b.word && left_at(a, d) == left_at(b, d);
+        }
+
+        // Whether a < b, knowing their first `d` characters are equal
+        template<typename C>
+        inline bool less_from(const string_key<C>& a, const string_key<C>& b, const std::size_t d) noexcept {
+            const std::size_t n = std::min(a.size, b.size);
+            for (std::size_t i = d; i < n; ++i)
+                if (a.chars[i] != b.chars[i])
+                    return static_cast<std::make_unsigned_t<C>>(a.chars[i]) < static_cast<std::make_unsigned_t<C>>(b.chars[i]);
+            return a.size < b.size;
+        }
+
+        inline constexpr std::size_t string_insertion = 16;
+
+        // Multikey quicksort (Bentley & Sedgewick) a word of characters at a time: three-way partition on the words at depth d,
+        // the smaller / larger parts keep their words, only the equal part loads the next ones (at d + per_word)
+        // @note Runs off an explicit stack, so long common prefixes cannot overflow the real one
+        template<typename C>
+        void multikey(string_key<C>* keys, const std::size_t count) {
+            struct part {
+                std::size_t begin, size, depth;
+                bool loaded;
+            };
+            std::vector<part> stack{ {0, count, 0, false} };
+
+            while (!stack.empty()) {
+                const auto [begin, n, d, loaded] = stack.back();
+                stack.pop_back();
+                string_key<C>* a = keys + begin;
+
+                if (n < string_insertion) {
+                    for (std::size_t i = 1; i < n; ++i) {
+                        const string_key<C> k = a[i];
+                        std::size_t j = i;
+                        for (; j > 0 && less_from(k, a[j - 1], d); --j) a[j] = a[j - 1];
+                        a[j] = k;
+                    }
+                    continue;
+                }
+
+                // The only reads of the strings' memory, random: keep a few in flight
+                if (!loaded)
+                    for (std::size_t i = 0; i < n; ++i) {
+                        if (i + 8 < n) __builtin_prefetch(a[i + 8].chars + d);
+                        load_word(a[i], d);
+                    }
+
+                // Median of three as the pivot (of three medians of three for large parts)
+                const auto median = [&](const std::size_t x, const std::size_t y, const std::size_t z) {
+                    return word_less(a[x], a[y], d) ? (word_less(a[y], a[z], d) ? y : (word_less(a[x], a[z], d) ? z : x))
+                                                    : (word_less(a[z], a[y], d) ? y : (word_less(a[z], a[x], d) ? z : x));
+                };
+                std::size_t m = median(0, n / 2, n - 1);
+                if (n > 1024) {
+                    const std::size_t s = n / 8;
+                    m = median(median(0, s, 2 * s), median(n / 2 - s, n / 2, n / 2 + s), median(n - 1 - 2 * s, n - 1 - s, n - 1));
+                }
+                const string_key<C> pivot = a[m];
+
+                // [0, lt) < pivot, [lt, i) == pivot, [gt, n) > pivot
+                std::size_t lt = 0, i = 0, gt = n;
+                while (i < gt) {
+                    if (word_less(a[i], pivot, d)) std::swap(a[lt++], a[i++]);
+                    else if (word_less(pivot, a[i], d)) std::swap(a[i], a[--gt]);
+                    else ++i;
+                }
+
+                if (lt > 1) stack.push_back({ begin, lt, d, true });
+                if (n - gt > 1) stack.push_back({ begin + gt, n - gt, d, true });
+                // Fewer than a full word left: these all ended, the same way
+                if (gt - lt > 1 && left_at(pivot, d) == per_word<C>) stack.push_back({ begin + lt, gt - lt, d + per_word<C>, false });
+            }
+        }
+
+        // Put the strings in key order: gathered into a new array (the next sources are prefetched), then moved back in one sweep
+        // @note Following the permutation's cycles in place would need no memory, but chases one cache miss at a time
+        template<typename R, typename C>
+        void permute(R& r, const string_key<C>* keys, const std::size_t n) {
+            using S = std::ranges::range_value_t<R>;
+            auto* p = std::ranges::data(r);
+
+            std::vector<S> sorted;
+            sorted.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (i + 16 < n) __builtin_prefetch(p + keys[i + 16].index);
+                sorted.push_back(std::move(p[keys[i].index]));
+            }
+            std::move(sorted.begin(), sorted.end(), p);
+        }
+        #pragma endregion
+
+
+
+        #pragma region Sample sort
+        // Sample sort: splitters from a sorted sample, then every block sends its elements to buckets, then buckets get sorted independently
+        // @param src Where the elements are (they are moved out of it)
+        // @param dst Where they end up, sorted
+        template<typename T, typename Compare>
+        void sample(T* src, T* dst, const std::size_t n, Compare& comp, rt::thread_pool& pool) {
+            const std::size_t workers = pool.size();
+            const std::size_t buckets = std::min<std::size_t>(std::bit_ceil(4 * workers), 1024);
+            const std::size_t blocks = 4 * workers;
+            const std::size_t per_block = (n + blocks - 1) / blocks;
+            constexpr std::size_t oversampling = 16;
+
+            // Splitters: every `oversampling`-th of a sorted pseudo-random sample
+            std::vector<T> splitters;
+            {
+                std::vector<T> picked;
+                const std::size_t samples = buckets * oversampling;
+                picked.reserve(samples);
+                std::uint64_t seed = 0x9E3779B97F4A7C15ull ^ n;
+                for (std::size_t i = 0; i < samples; ++i) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 7;
+                    seed ^= seed << 17;
+                    picked.push_back(src[seed % n]);
+                }
+                std::sort(picked.begin(), picked.end(), comp);
+                splitters.reserve(buckets - 1);
+                for (std::size_t b = 1; b < buckets; ++b) splitters.push_back(picked[b * oversampling]);
+            }
+
+            // Bucket of every element, and how many each block has in each bucket
+            std::unique_ptr<std::uint16_t[]> bucket_of = std::make_unique_for_overwrite<std::uint16_t[]>(n);
+            std::vector<std::size_t> counts(blocks * buckets, 0);
+            parallel::_internal::chunks(pool, blocks, 1, [&](const std::size_t first, const std::size_t last) {
+                for (std::size_t b = first; b < last; ++b) {
+                    std::size_t* c = counts.data() + b * buckets;
+                    const std::size_t begin = b * per_block, end = std::min(begin + per_block, n);
+                    for (std::size_t i = begin; i < end; ++i) {
+                        const auto at = std::upper_bound(splitters.begin(), splitters.end(), src[i], comp) - splitters.begin();
+                        bucket_of[i] = static_cast<std::uint16_t>(at);
+                        ++c[at];
+                    }
+                }
+            });
+
+            // Bucket-major offsets, block-minor
+            std::vector<std::size_t> starts(buckets + 1);
+            std::size_t sum = 0;
+            for (std::size_t k = 0; k < buckets; ++k) {
+                starts[k] = sum;
+                for (std::size_t b = 0; b < blocks; ++b) {
+                    const std::size_t c = counts[b * buckets + k];
+                    counts[b * buckets + k] = sum;
+                    sum += c;
+                }
+            }
+            starts[buckets] = n;
+
+            parallel::_internal::chunks(pool, blocks, 1, [&](const std::size_t first, const std::size_t last) {
+                for (std::size_t b = first; b < last; ++b) {
+                    std::size_t* next = counts.data() + b * buckets;
+                    const std::size_t begin = b * per_block, end = std::min(begin + per_block, n);
+                    for (std::size_t i = begin; i < end; ++i) dst[next[bucket_of[i]]++] = std::move(src[i]);
+                }
+            });
+            bucket_of.reset();
+
+            // Buckets much larger than their share (many equal keys) get the parallel merge sort, the rest `std::sort`
+            const std::size_t fair = n / buckets;
+            parallel::_internal::chunks(pool, buckets, 1, [&](const std::size_t first, const std::size_t last) {
+                for (std::size_t k = first; k < last; ++k) {
+                    const std::size_t size = starts[k + 1] - starts[k];
+                    if (size > 4 * fair) parallel::sort(std::span(dst + starts[k], size), comp, 0, pool);
+                    else std::sort(dst + starts[k], dst + starts[k + 1], comp);
+                }
+            });
+        }
+        #pragma endregion
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region Sorts
+
+    // LSD radix sort: one pass per key byte (fewer when some byte is the same in every key), stable
+    // @param scratch Used for the second buffer when the container has no spare capacity for it (default: allocate one)
+    // @param pool Splits passes in blocks across workers for large inputs (default: the shared pool)
+    // @note Negative floats go before positive ones, -0 before +0, NaNs at the ends by their sign
+    template<a_key_range R>
+    void radix(R&& r, arena* scratch = nullptr, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(r);
+        T* p = std::ranges::data(r);
+        if (n < 256) {
+            std::sort(p, p + n, [](const T a, const T b) { return _internal::radix_key<T>::of(a) < _internal::radix_key<T>::of(b); });
+            return;
+        }
+
+        _internal::scratch<T> tmp(r, scratch, n);
+        const std::size_t blocks = std::min(pool.size() * 4, n / (std::size_t(1) << 16));
+        if (blocks < 2 || pool.size() < 2) _internal::radix_sequential(p, tmp.data, n);
+        else _internal::radix_parallel(p, tmp.data, n, blocks, pool);
+    }
+
+    // Sort strings by their characters (compared as unsigned, shorter first on a common prefix)
+    // @note Multikey quicksort on small keys holding 8 bytes of characters each: no character is compared twice,
+    //       the strings' own memory is read once per 8 bytes, and they are moved once at the end
+    // @param scratch Used for the keys (default: allocate them)
+    template<a_string_range R>
+    void strings(R&& r, arena* scratch = nullptr) {
+        using S = std::ranges::range_value_t<R>;
+        using C = std::remove_cv_t<std::ranges::range_value_t<const S>>;
+        using K = _internal::string_key<C>;
+
+        const std::size_t n = std::ranges::size(r);
+        if (n < 2) return;
+
+        const S* p = std::ranges::data(r);
+        _internal::scratch<K> keys(scratch, n);
+        for (std::size_t i = 0; i < n; ++i) keys.data[i] = { 0, std::ranges::data(p[i]), std::ranges::size(p[i]), i };
+
+        _internal::multikey(keys.data, n);
+        _internal::permute(r, keys.data, n);
+    }
+
+    // Parallel sample sort for any comparator
+    // @note The bucket of every element is found once (binary search over the splitters), then the pool sorts buckets independently
+    // @note Not stable, needs scratch space as big as the range (the container's spare capacity, then `scratch`, for trivially copyable `T`)
+    template<parallel::an_output_range R, typename Compare = std::less<>>
+    void sample(R&& r, Compare comp = {}, arena* scratch = nullptr, rt::thread_pool& pool = rt::thread_pool::shared()) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(r);
+        T* p = std::ranges::data(r);
+        if (n < (std::size_t(1) << 16) || pool.size() < 2) {
+            std::sort(p, p + n, comp);
+            return;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            _internal::scratch<T> tmp(r, scratch, n);
+            parallel::_internal::chunks(pool, n, n / (4 * pool.size()) + 1, [&](const std::size_t begin, const std::size_t end) {
+                std::memcpy(static_cast<void*>(tmp.data + begin), p + begin, (end - begin) * sizeof(T));
+            });
+            pool.run([&] { _internal::sample(tmp.data, p, n, comp, pool); });
+        } else {
+            std::vector<T> moved(std::make_move_iterator(p), std::make_move_iterator(p + n));
+            pool.run([&] { _internal::sample(moved.data(), p, n, comp, pool); });
+        }
+    }
+
+    #pragma endregion
+}
+
+#endif
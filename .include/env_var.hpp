@@ -1,17 +1,349 @@
 #ifndef PROC_ENV_VAR_HPP
 #define PROC_ENV_VAR_HPP
 
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __unix__
 #include <unistd.h>
+
+extern char** environ;
 #elif _WIN32
 #include <windows.h>
 #endif
 
 // Where u manipulate environment variables
+// @note A hash-indexed snapshot of `environ` is built on first use, so lookups do not scan it like `getenv` does
+// @note Changes go through here to stay in sync (`set()` / `unset()` also call `setenv` / `unsetenv`).
+//       After changing `environ` behind its back, call `refresh()`
+// @note Thread-safe among its own functions. Like `setenv`, not against other code reading `environ` meanwhile
 namespace asl::env_var {
-    // TODO: Implement functions that manipulates `extern char** environ`
+
+    namespace _internal {
+
+        // One immutable version of the environment, shared while in use (copy-on-write)
+        struct snapshot {
+            std::vector<const std::string*> entries;                   // "NAME=value", owned by `state::arena`
+            std::unordered_map<std::string_view, std::size_t> index;  // Name -> position in `entries`
+            std::vector<char*> envp;                                   // NULL-terminated
+        };
+
+        struct state {
+            std::shared_mutex lock;
+            std::shared_ptr<const snapshot> current;
+            std::atomic<uint64_t> version{ 0 }; // Bumped on every new snapshot
+
+            // Every entry ever made. Never shrinks, so views handed out stay valid (as with `setenv`, which leaks too)
+            std::deque<std::string> arena;
+        };
+
+        inline state& get_state() {
+            static state s;
+            return s;
+        }
+
+        inline std::shared_ptr<snapshot> build(state& s) {
+            auto snap = std::make_shared<snapshot>();
+            #ifdef __unix__
+            for (char** e = environ; e && *e; ++e) {
+                const std::string_view entry(*e);
+                const std::size_t eq = entry.find('=');
+                if (eq == std::string_view::npos || eq == 0) continue;
+
+                // Unchanged since the last snapshot: share its entry
+                const std::string* text = nullptr;
+                if (s.current) {
+                    const auto old = s.current->index.find(entry.substr(0, eq));
+                    if (old != s.current->index.end() && *s.current->entries[old->second] == entry) text = s.current->entries[old->second];
+                }
+                if (!text) text = &s.arena.emplace_back(entry);
+
+                const auto [it, added] = snap->index.try_emplace(std::string_view(*text).substr(0, eq), snap->entries.size());
+                if (added) snap->entries.push_back(text);
+                else snap->entries[it->second] = text; // Duplicate name, the last one wins
+            }
+            #endif
+            return snap;
+        }
+
+        inline void finish(snapshot& snap) {
+            snap.envp.clear();
+            snap.envp.reserve(snap.entries.size() + 1);
+            for (const std::string* e : snap.entries) snap.envp.push_back(const_cast<char*>(e->c_str()));
+            snap.envp.push_back(nullptr);
+        }
+
+        // The current snapshot (built on first use)
+        inline std::shared_ptr<const snapshot> current() {
+            state& s = get_state();
+            {
+                std::shared_lock read(s.lock);
+                if (s.current) return s.current;
+            }
+            std::unique_lock write(s.lock);
+            if (!s.current) {
+                auto snap = build(s);
+                finish(*snap);
+                s.current = std::move(snap);
+                s.version.fetch_add(1, std::memory_order_release);
+            }
+            return s.current;
+        }
+
+        // This thread's copy of the current snapshot, refreshed when the version moved: no lock on the read path
+        inline const snapshot& local() {
+            thread_local uint64_t seen = 0;
+            thread_local std::shared_ptr<const snapshot> cached;
+
+            const uint64_t version = get_state().version.load(std::memory_order_acquire);
+            if (!cached || version != seen) {
+                cached = current();
+                seen = version;
+            }
+            return *cached;
+        }
+
+        inline std::optional<std::string_view> find(const snapshot& snap, const std::string_view name) noexcept {
+            const auto it = snap.index.find(name);
+            if (it == snap.index.end()) return std::nullopt;
+            return std::string_view(*snap.entries[it->second]).substr(name.size() + 1);
+        }
+
+        inline std::string_view trim(std::string_view v) noexcept {
+            while (!v.empty() && std::isspace(static_cast<unsigned char>(v.front()))) v.remove_prefix(1);
+            while (!v.empty() && std::isspace(static_cast<unsigned char>(v.back()))) v.remove_suffix(1);
+            return v;
+        }
+
+        inline bool iequals(const std::string_view a, const std::string_view b) noexcept {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); ++i)
+                if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+            return true;
+        }
+    }
+
+
+
+
+
+    #pragma region Read
+
+    // Value of a variable
+    // @return Nothing if it is not set. The view stays valid for the whole program
+    inline std::optional<std::string_view> get(const std::string_view name) {
+        return _internal::find(_internal::local(), name);
+    }
+
+    // Value of a variable, or `fallback` if it is not set
+    inline std::string_view get_or(const std::string_view name, const std::string_view fallback) {
+        return get(name).value_or(fallback);
+    }
+
+    // Whether a variable is set
+    inline bool has(const std::string_view name) {
+        return get(name).has_value();
+    }
+
+    // A variable as an integer: decimal, or hex with "0x"
+    // @return Nothing if it is not set or not an integer
+    inline std::optional<int64_t> get_int(const std::string_view name) {
+        const auto value = get(name);
+        if (!value) return std::nullopt;
+
+        std::string_view v = _internal::trim(*value);
+        const bool negative = !v.empty() && v[0] == '-';
+        if (!v.empty() && (v[0] == '-' || v[0] == '+')) v.remove_prefix(1);
+
+        int base = 10;
+        if (v.size() > 2 && v[0] == '0' && (v[1] == 'x' || v[1] == 'X')) {
+            v.remove_prefix(2);
+            base = 16;
+        }
+
+        uint64_t magnitude = 0;
+        const auto [end, error] = std::from_chars(v.data(), v.data() + v.size(), magnitude, base);
+        if (v.empty() || error != std::errc() || end != v.data() + v.size()) return std::nullopt;
+        if (magnitude > static_cast<uint64_t>(INT64_MAX) + negative) return std::nullopt;
+        return negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    }
+
+    // A variable as a boolean: 1 / true / yes / y / on, or 0 / false / no / n / off (any case)
+    // @return Nothing if it is not set or none of those
+    inline std::optional<bool> get_bool(const std::string_view name) {
+        const auto value = get(name);
+        if (!value) return std::nullopt;
+
+        const std::string_view v = _internal::trim(*value);
+        for (const std::string_view yes : { "1", "true", "yes", "on", "y" })
+            if (_internal::iequals(v, yes)) return true;
+        for (const std::string_view no : { "0", "false", "no", "off", "n" })
+            if (_internal::iequals(v, no)) return false;
+        return std::nullopt;
+    }
+
+    // A variable as a duration: a number (decimals allowed) and a unit, ns / us / ms / s / m / h / d
+    // @note No unit means seconds, e.g., "1.5" is 1.5 s
+    // @return Nothing if it is not set or not a duration
+    inline std::optional<std::chrono::nanoseconds> get_duration(const std::string_view name) {
+        const auto value = get(name);
+        if (!value) return std::nullopt;
+
+        const std::string_view v = _internal::trim(*value);
+        double amount = 0;
+        const auto [end, error] = std::from_chars(v.data(), v.data() + v.size(), amount);
+        if (error != std::errc() || !std::isfinite(amount) || amount < 0) return std::nullopt; // `from_chars` takes "nan" and "inf" too
+
+        const std::string_view unit = _internal::trim(std::string_view(end, static_cast<std::size_t>(v.data() + v.size() - end)));
+        double scale;
+        if (unit.empty() || unit == "s") scale = 1e9;
+        else if (unit == "ms") scale = 1e6;
+        else if (unit == "us" || unit == "\xC2\xB5s") scale = 1e3;
+        else if (unit == "ns") scale = 1;
+        else if (unit == "m" || unit == "min") scale = 60e9;
+        else if (unit == "h") scale = 3600e9;
+        else if (unit == "d") scale = 86400e9;
+        else return std::nullopt;
+
+        // Rounded below 2^63, so it fits in `int64_t`
+        const double ns = amount * scale + 0.5;
+        if (!(ns < 9223372036854775808.0)) return std::nullopt;
+        return std::chrono::nanoseconds(static_cast<int64_t>(ns));
+    }
+
+    // How many variables are set
+    inline std::size_t size() {
+        return _internal::current()->entries.size();
+    }
+
+    // Visit every variable, as (name, value)
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        const auto snap = _internal::current();
+        for (const std::string* e : snap->entries) {
+            const std::string_view entry(*e);
+            const std::size_t eq = entry.find('=');
+            fn(entry.substr(0, eq), entry.substr(eq + 1));
+        }
+    }
+
+    // The whole environment as a NULL-terminated `envp` array (e.g., for `execve` / `posix_spawn`)
+    // @note Kept alive by the returned pointer, even if variables change meanwhile. Nothing is copied unless they did
+    inline std::shared_ptr<char* const> envp() {
+        auto snap = _internal::current();
+        char* const* data = snap->envp.data();
+        return std::shared_ptr<char* const>(std::move(snap), data);
+    }
+
+    #pragma endregion
+
+
+
+
+
+    #pragma region Write
+
+    // Set a variable, here and in the real environment
+    // @param overwrite False: keep the current value if it is set
+    // @note Copy-on-write: the new version shares every other entry with the old one
+    inline void set(const std::string_view name, const std::string_view value, const bool overwrite = true) {
+        if (name.empty() || name.find('=') != std::string_view::npos)
+            throw std::runtime_error("asl::env_var::set(): Invalid variable name.");
+
+        _internal::current(); // Make sure there is one
+        _internal::state& s = _internal::get_state();
+        std::unique_lock write(s.lock);
+
+        const auto it = s.current->index.find(name);
+        if (it != s.current->index.end() && !overwrite) return;
+
+        std::string& text = s.arena.emplace_back();
+        text.reserve(name.size() + value.size() + 1);
+        text.append(name).append(1, '=').append(value);
+
+        #ifdef __unix__
+        if (setenv(text.substr(0, name.size()).c_str(), text.c_str() + name.size() + 1, 1) != 0)
+            throw std::runtime_error("asl::env_var::set(): setenv failed.");
+        #elif _WIN32
+        throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+        #endif
+
+        auto snap = std::make_shared<_internal::snapshot>(*s.current);
+        if (it != s.current->index.end()) {
+            const std::size_t at = it->second;
+            snap->index.erase(name);
+            snap->entries[at] = &text;
+            snap->index.emplace(std::string_view(text).substr(0, name.size()), at);
+            snap->envp[at] = const_cast<char*>(text.c_str());
+        } else {
+            snap->index.emplace(std::string_view(text).substr(0, name.size()), snap->entries.size());
+            snap->entries.push_back(&text);
+            snap->envp.back() = const_cast<char*>(text.c_str());
+            snap->envp.push_back(nullptr);
+        }
+        s.current = std::move(snap);
+        s.version.fetch_add(1, std::memory_order_release);
+    }
+
+    // Remove a variable, here and in the real environment
+    inline void unset(const std::string_view name) {
+        _internal::current();
+        _internal::state& s = _internal::get_state();
+        std::unique_lock write(s.lock);
+
+        const auto it = s.current->index.find(name);
+        if (it == s.current->index.end()) return;
+
+        #ifdef __unix__
+        if (unsetenv(std::string(name).c_str()) != 0)
+            throw std::runtime_error("asl::env_var::unset(): unsetenv failed.");
+        #elif _WIN32
+        throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+        #endif
+
+        // Move the last entry into the hole
+        auto snap = std::make_shared<_internal::snapshot>(*s.current);
+        const std::size_t at = it->second;
+        const std::size_t last = snap->entries.size() - 1;
+        snap->index.erase(name);
+        if (at != last) {
+            const std::string* moved = snap->entries[last];
+            snap->entries[at] = moved;
+            const std::string_view moved_entry(*moved);
+            snap->index[moved_entry.substr(0, moved_entry.find('='))] = at;
+        }
+        snap->entries.pop_back();
+        _internal::finish(*snap);
+        s.current = std::move(snap);
+        s.version.fetch_add(1, std::memory_order_release);
+    }
+
+    // Rebuild the snapshot from `environ` (after someone changed it directly)
+    inline void refresh() {
+        _internal::state& s = _internal::get_state();
+        std::unique_lock write(s.lock);
+        auto snap = _internal::build(s);
+        _internal::finish(*snap);
+        s.current = std::move(snap);
+        s.version.fetch_add(1, std::memory_order_release);
+    }
+
+    #pragma endregion
 }
 
-#endif
\ No newline at end of file
+#endif
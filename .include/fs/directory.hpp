@@ -3,29 +3,73 @@
 
 #include "../types/object.hpp"
 #include "./file.hpp"
+#include "../rt/trace_points.hpp"
 #include <string>
 #include <string_view>
 #include <vector>
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <utility>
+
+#ifdef __unix__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 namespace asl::fs {
 
     // A wrapper around a directory
-    class directory final : private types::object {
+    class directory final : private types::object<directory> {
     private:
         sfs::path path_;
 
         std::vector<sfs::path> children_;
 
+        #ifdef __unix__
+        // Visit every entry under `dir_fd` with one `statx` each (relative to the open directory)
+        // @param follow Report what symlinks point to (never walks into linked directories)
+        // @note Takes ownership of `dir_fd`
+        template<typename Fn>
+        static void walk_(const int dir_fd, const sfs::path& prefix, const unsigned int fields, const bool recursive, const bool follow, Fn&& visit) {
+            DIR* dir = fdopendir(dir_fd);
+            if (!dir) {
+                close(dir_fd);
+                return;
+            }
+
+            while (const dirent* entry = readdir(dir)) {
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+
+                const fs::metadata snapshot = stat_at(dir_fd, name, fields | field_type, false);
+                if (follow && snapshot.type == sfs::file_type::symlink) {
+                    visit(prefix / name, stat_at(dir_fd, name, fields | field_type, true));
+                    continue;
+                }
+                visit(prefix / name, snapshot);
+
+                if (recursive && snapshot.type == sfs::file_type::directory) {
+                    const int child_fd = openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                    if (child_fd != -1)
+                        walk_(child_fd, prefix / name, fields, recursive, follow, visit);
+                }
+            }
+
+            closedir(dir); // Closes `dir_fd` too
+        }
+        #endif
+
     public:
 
         #pragma region Setups
 
         // Wraps around a directory (create if not present or is a regular file)
         explicit directory(const sfs::path name) noexcept : path_(name) {
+            ASL_TRACE_SPAN("fs::directory::scan");
             const sfs::path& p = name;
 
             if (sfs::exists(p) && sfs::is_directory(p)) {
@@ -45,7 +89,7 @@ namespace asl::fs {
         ~directory() = default;
 
 
-        basl operator==(const directory& b) const noexcept {
+        bool operator==(const directory& b) const noexcept {
             return this->path() == b.path();
         }
 
@@ -70,9 +114,19 @@ namespace asl::fs {
 
         // The size of the directory (default unit: KB)
         std::uintmax_t size(const memory_unit unit = KB) const noexcept {
+            ASL_TRACE_SPAN("fs::directory::size");
             std::uintmax_t byte_size_ = 0;
+
+            #ifdef __unix__
+            const int dir_fd = open(path_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir_fd != -1)
+                walk_(dir_fd, path_, field_size, true, true, [&](const sfs::path&, const fs::metadata& each) {
+                    if (each.type == sfs::file_type::regular) byte_size_ += each.size;
+                });
+            #else
             for (const auto& each : sfs::recursive_directory_iterator(path_))
                 if (sfs::is_regular_file(each.path())) byte_size_ += each.file_size();
+            #endif
 
             return byte_size_ / unit;
         }
@@ -92,6 +146,29 @@ namespace asl::fs {
             return children_;
         }
 
+        // Enumerate children with their metadata, one `statx` per entry
+        // @param fields What to fetch (default: everything)
+        // @param recursive Walk into sub-directories (default: false)
+        // @note Symlinks are not followed
+        std::vector<std::pair<sfs::path, fs::metadata>> entries(const unsigned int fields = field_all, const bool recursive = false) const {
+            ASL_TRACE_SPAN("fs::directory::entries");
+            std::vector<std::pair<sfs::path, fs::metadata>> found;
+
+            #ifdef __unix__
+            const int dir_fd = open(path_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir_fd == -1)
+                throw std::runtime_error("asl::fs::directory::entries(): Failed to open directory.");
+
+            walk_(dir_fd, path_, fields, recursive, false, [&](const sfs::path& p, const fs::metadata& each) {
+                found.emplace_back(p, each);
+            });
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+
+            return found;
+        }
+
         #pragma endregion
 
 
@@ -139,6 +216,7 @@ namespace asl::fs {
                 throw std::runtime_error("asl::fs::directory::remove_child(): Failed to remove child.");
 
             children_.erase(it);
+            return *this;
         }
     };
 }
@@ -2,22 +2,23 @@
 #define FS_FILE_HPP
 
 #include "../types/object.hpp"
+#include "./mapping.hpp"
+#include "./metadata.hpp"
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include <string_view>
 
 namespace asl::fs {
-        
-    namespace sfs = std::filesystem; // Alias for std::filesystem
-
-    enum memory_unit { B = 1, KB = 1'000, MB = 1'000'000, GB = 1'000'000'000 };
 
     // A wrapper around a file
-    class file final : private types::object {
+    class file final : private types::object<file> {
     private:
         sfs::path path_;
 
+        mutable fs::metadata metadata_; // Cached snapshot, see `metadata()`
+        mutable unsigned int fetched_ = 0; // Fields asked for in the cached snapshot
+
     public:
 
         #pragma region Setup
@@ -38,7 +39,7 @@ namespace asl::fs {
         ~file() = default;
 
 
-        basl operator==(const file& b) const noexcept {
+        bool operator==(const file& b) const noexcept {
             return this->path() == b.path();
         }
 
@@ -74,6 +75,41 @@ namespace asl::fs {
             return sfs::last_write_time(path_);
         }
 
+        // Size, permission, mtime, inode and type, in one syscall
+        // @param fields What to fetch (default: everything)
+        // @note Cached after the first call, use `refresh()` to take a new snapshot
+        const fs::metadata& metadata(const unsigned int fields = field_all) const {
+            if ((fetched_ & fields) != fields)
+                refresh(fields);
+            return metadata_;
+        }
+
+        // Take a new metadata snapshot
+        // @param fields What to fetch (default: everything)
+        const file& refresh(const unsigned int fields = field_all) const {
+            metadata_ = fs::stat(path_, fields);
+            fetched_ = metadata_.fields; // Nothing if it failed, so the next `metadata()` tries again
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Content
+
+        // Map the file into memory (zero-copy access)
+        // @param mode Read-only or read-write (default: read-only)
+        // @param offset Where the view starts (default: beginning of file)
+        // @param length How many bytes (default: 0, until the end of file)
+        // @param populate Pre-fault every page up front (default: false)
+        // @note Map a range at a time for files bigger than the address space you can spare
+        mapping map(const map_mode mode = read_only, const std::uint64_t offset = 0, const std::size_t length = 0, const bool populate = false) const {
+            return mapping(path_.string(), mode, offset, length, populate);
+        }
+
         #pragma endregion
     };
 }
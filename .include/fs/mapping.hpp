@@ -0,0 +1,264 @@
+#ifndef FS_MAPPING_HPP
+#define FS_MAPPING_HPP
+
+#include "../types/object.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace asl::fs {
+
+    #pragma region Enums
+    // How a file is mapped
+    enum map_mode {
+        read_only,
+        read_write // Writes go back to the file (shared mapping)
+    };
+
+
+    // Access pattern hints
+    // @note Enumerators represent the `madvise` advices
+    enum map_advice {
+        #ifdef __unix__
+        normal     = MADV_NORMAL,
+        sequential = MADV_SEQUENTIAL,
+        random     = MADV_RANDOM,
+        willneed   = MADV_WILLNEED,
+        #ifdef MADV_HUGEPAGE
+        hugepage   = MADV_HUGEPAGE
+        #else
+        hugepage   = MADV_NORMAL
+        #endif
+        #else
+        normal, sequential, random, willneed, hugepage
+        #endif
+    };
+    #pragma endregion
+
+
+
+
+    // A memory-mapped view over (a range of) a file
+    // @note Move-only, unmapped on destruction
+    class mapping final : private types::object<mapping> {
+    private:
+        void* base_ = nullptr;      // Page-aligned address given by `mmap`
+        std::size_t base_size_ = 0; // Length actually mapped
+
+        std::byte* data_ = nullptr; // First byte asked for (may not be page-aligned)
+        std::size_t size_ = 0;      // Bytes asked for
+
+        map_mode mode_ = read_only;
+
+        void release() noexcept {
+            #ifdef __unix__
+            if (base_) munmap(base_, base_size_);
+            #endif
+            base_ = nullptr;
+            data_ = nullptr;
+            base_size_ = size_ = 0;
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // Maps `length` bytes of the file at `path` starting from `offset`
+        // @param path The file to map
+        // @param mode Read-only or read-write
+        // @param offset Where the view starts (needs not to be page-aligned)
+        // @param length How many bytes (0: until the end of file)
+        // @param populate Pre-fault the whole range (`MAP_POPULATE`)
+        mapping(const std::string& path, const map_mode mode = read_only, const std::uint64_t offset = 0, std::size_t length = 0, const bool populate = false) : mode_(mode) {
+            #ifdef __unix__
+            const int fd = open(path.c_str(), (mode == read_write ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+            if (fd == -1)
+                throw std::runtime_error("asl::fs::mapping::mapping(): Failed to open file.");
+
+            struct stat st;
+            if (fstat(fd, &st) == -1) {
+                close(fd);
+                throw std::runtime_error("asl::fs::mapping::mapping(): fstat failed.");
+            }
+
+            const std::uint64_t file_size = static_cast<std::uint64_t>(st.st_size);
+            if (offset > file_size) {
+                close(fd);
+                throw std::out_of_range("asl::fs::mapping::mapping(): Offset is past the end of file.");
+            }
+
+            if (length == 0 || length > file_size - offset)
+                length = static_cast<std::size_t>(file_size - offset);
+
+            // Nothing to map (e.g., empty file), a valid empty view
+            if (length == 0) {
+                close(fd);
+                return;
+            }
+
+            // `mmap` wants a page-aligned offset, so map a bit more and hide the head
+            const std::uint64_t page = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+            const std::uint64_t aligned_offset = offset - offset % page;
+            const std::size_t head = static_cast<std::size_t>(offset - aligned_offset);
+
+            int flags = MAP_SHARED;
+            #ifdef MAP_POPULATE
+            if (populate) flags |= MAP_POPULATE;
+            #endif
+
+            void* p = mmap(nullptr, length + head, mode == read_write ? PROT_READ | PROT_WRITE : PROT_READ, flags, fd, static_cast<off_t>(aligned_offset));
+            close(fd); // The mapping keeps its own reference
+
+            if (p == MAP_FAILED)
+                throw std::runtime_error("asl::fs::mapping::mapping(): mmap failed.");
+
+            base_ = p;
+            base_size_ = length + head;
+            data_ = static_cast<std::byte*>(p) + head;
+            size_ = length;
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        // Empty view
+        mapping() = default;
+
+        mapping(const mapping&) = delete;
+        mapping& operator=(const mapping&) = delete;
+
+        // Move ctor
+        mapping(mapping&& other) noexcept :
+            base_(std::exchange(other.base_, nullptr)),
+            base_size_(std::exchange(other.base_size_, 0)),
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0)),
+            mode_(other.mode_) {}
+
+        // Move assign
+        mapping& operator=(mapping&& other) noexcept {
+            if (this != &other) {
+                release();
+                base_ = std::exchange(other.base_, nullptr);
+                base_size_ = std::exchange(other.base_size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                mode_ = other.mode_;
+            }
+            return *this;
+        }
+
+        // Unmaps
+        ~mapping() {
+            release();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Access
+
+        // Raw bytes of the view
+        std::span<const std::byte> bytes() const noexcept {
+            return { data_, size_ };
+        }
+
+        // Raw bytes of the view, to write through
+        // @note Throws unless mapped with `read_write` (writing a read-only map would crash)
+        std::span<std::byte> writable_bytes() {
+            if (mode_ != read_write)
+                throw std::runtime_error("asl::fs::mapping::writable_bytes(): The mapping is read-only.");
+            return { data_, size_ };
+        }
+
+        // The view as characters, to write through
+        // @note Throws unless mapped with `read_write` (writing a read-only map would crash)
+        std::span<char> writable_chars() {
+            if (mode_ != read_write)
+                throw std::runtime_error("asl::fs::mapping::writable_chars(): The mapping is read-only.");
+            return { reinterpret_cast<char*>(data_), size_ };
+        }
+
+        // The view as text
+        std::string_view text() const noexcept {
+            return { reinterpret_cast<const char*>(data_), size_ };
+        }
+
+        // @note Writable only if mapped with `read_write`
+        std::byte* data() noexcept {
+            return data_;
+        }
+
+        const std::byte* data() const noexcept {
+            return data_;
+        }
+
+        std::size_t size() const noexcept {
+            return size_;
+        }
+
+        bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        map_mode mode() const noexcept {
+            return mode_;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Hints
+
+        // Tell the kernel how this view will be accessed
+        // @param advice The access pattern
+        // @param offset Start of the hinted range, relative to the view (default: whole view)
+        // @param length Length of the hinted range (0: until the end of the view)
+        // @note Hints are best-effort, failures are ignored (e.g., no THP support)
+        mapping& advise(const map_advice advice, const std::size_t offset = 0, std::size_t length = 0) noexcept {
+            #ifdef __unix__
+            if (!base_ || offset >= size_) return *this;
+            if (length == 0 || offset + length > size_) length = size_ - offset;
+
+            // `madvise` wants a page-aligned address too
+            const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+            const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(data_ + offset);
+            const std::uintptr_t aligned = first - first % page;
+
+            madvise(reinterpret_cast<void*>(aligned), length + (first - aligned), advice);
+            #endif
+            return *this;
+        }
+
+        // Flush the modified pages back to the file
+        // @param wait Block until written (`MS_SYNC`) or just schedule it (`MS_ASYNC`)
+        mapping& sync(const bool wait = true) {
+            #ifdef __unix__
+            if (base_ && mode_ == read_write && msync(base_, base_size_, wait ? MS_SYNC : MS_ASYNC) == -1)
+                throw std::runtime_error("asl::fs::mapping::sync(): msync failed.");
+            #endif
+            return *this;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef FS_METADATA_HPP
+#define FS_METADATA_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+namespace asl::fs {
+
+    namespace sfs = std::filesystem; // Alias for std::filesystem
+
+    enum memory_unit { B = 1, KB = 1'000, MB = 1'000'000, GB = 1'000'000'000 };
+
+
+    // Fields to fetch in a metadata snapshot
+    // @note Enumerators represent the `statx` mask bits. Use `operator|` to combine them
+    enum metadata_fields : unsigned int {
+        #ifdef __unix__
+        field_type  = STATX_TYPE,
+        field_perms = STATX_MODE,
+        field_size  = STATX_SIZE,
+        field_mtime = STATX_MTIME,
+        field_inode = STATX_INO,
+        #else
+        field_type  = 1 << 0,
+        field_perms = 1 << 1,
+        field_size  = 1 << 2,
+        field_mtime = 1 << 3,
+        field_inode = 1 << 4,
+        #endif
+        field_all = field_type | field_perms | field_size | field_mtime | field_inode
+    };
+
+
+
+    // A snapshot of a file's metadata, taken with one syscall
+    // @note Only the fields in `fields` are meaningful, check with `has()`
+    struct metadata {
+        std::uintmax_t size = 0;
+        sfs::perms perms = sfs::perms::unknown;
+        sfs::file_type type = sfs::file_type::none;
+        sfs::file_time_type mtime{};
+        std::uint64_t inode = 0;
+
+        unsigned int fields = 0; // Fields the kernel actually filled
+
+        // Whether a field was filled
+        bool has(const metadata_fields field) const noexcept {
+            return (fields & field) == static_cast<unsigned int>(field);
+        }
+
+        // The size in a given unit (default unit: KB)
+        std::uintmax_t size_in(const memory_unit unit = KB) const noexcept {
+            return size / unit;
+        }
+    };
+
+
+
+    #ifdef __unix__
+    // Takes a snapshot of `path`, relative to the directory `dir_fd`
+    // @param dir_fd An open directory, or `AT_FDCWD`
+    // @param path The file (absolute paths ignore `dir_fd`)
+    // @param fields What to fetch (default: everything)
+    // @param follow Follow the symlink (default: true)
+    // @note `.fields == 0` if the file cannot be stat'ed
+    inline metadata stat_at(const int dir_fd, const char* path, const unsigned int fields = field_all, const bool follow = true) noexcept {
+        metadata snapshot;
+        struct statx stx;
+
+        if (::statx(dir_fd, path, AT_STATX_SYNC_AS_STAT | (follow ? 0 : AT_SYMLINK_NOFOLLOW), fields, &stx) == -1)
+            return snapshot;
+
+        snapshot.fields = stx.stx_mask & fields;
+
+        if (stx.stx_mask & STATX_SIZE) snapshot.size = stx.stx_size;
+        if (stx.stx_mask & STATX_MODE) snapshot.perms = static_cast<sfs::perms>(stx.stx_mode & 07777);
+        if (stx.stx_mask & STATX_INO) snapshot.inode = stx.stx_ino;
+
+        if (stx.stx_mask & STATX_TYPE) {
+            switch (stx.stx_mode & S_IFMT) {
+                case S_IFREG:  snapshot.type = sfs::file_type::regular; break;
+                case S_IFDIR:  snapshot.type = sfs::file_type::directory; break;
+                case S_IFLNK:  snapshot.type = sfs::file_type::symlink; break;
+                case S_IFBLK:  snapshot.type = sfs::file_type::block; break;
+                case S_IFCHR:  snapshot.type = sfs::file_type::character; break;
+                case S_IFIFO:  snapshot.type = sfs::file_type::fifo; break;
+                case S_IFSOCK: snapshot.type = sfs::file_type::socket; break;
+                default:       snapshot.type = sfs::file_type::unknown; break;
+            }
+        }
+
+        if (stx.stx_mask & STATX_MTIME) {
+            const auto since_epoch = std::chrono::seconds(stx.stx_mtime.tv_sec) + std::chrono::nanoseconds(stx.stx_mtime.tv_nsec);
+            snapshot.mtime = std::chrono::file_clock::from_sys(std::chrono::sys_time<std::chrono::nanoseconds>(since_epoch));
+        }
+
+        return snapshot;
+    }
+    #endif
+
+
+
+    // Takes a snapshot of a file
+    // @param path The file
+    // @param fields What to fetch (default: everything)
+    inline metadata stat(const sfs::path& path, const unsigned int fields = field_all) {
+        #ifdef __unix__
+        return stat_at(AT_FDCWD, path.c_str(), fields);
+        #elif _WIN32
+        throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+        #endif
+    }
+
+
+
+    // Takes snapshots of many files in the same directory, sharing one directory fd
+    // @param dir The parent directory
+    // @param names Names relative to `dir`
+    // @param fields What to fetch (default: everything)
+    // @return One snapshot per name, in the same order
+    inline std::vector<metadata> stat_batch(const sfs::path& dir, std::span<const std::string> names, const unsigned int fields = field_all) {
+        std::vector<metadata> snapshots;
+        snapshots.reserve(names.size());
+
+        #ifdef __unix__
+        const int dir_fd = open(dir.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd == -1)
+            throw std::runtime_error("asl::fs::stat_batch(): Failed to open directory.");
+
+        for (const auto& name : names)
+            snapshots.push_back(stat_at(dir_fd, name.c_str(), fields));
+
+        close(dir_fd);
+        #elif _WIN32
+        throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+        #endif
+
+        return snapshots;
+    }
+}
+
+#endif
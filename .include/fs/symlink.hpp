@@ -9,7 +9,7 @@
 namespace asl::fs {
     
     // A wrapper around a symlink
-    class symlink final : private types::object {
+    class symlink final : private types::object<symlink> {
     public:
         // TODO: Finish symlink
     };
@@ -13,13 +13,13 @@ namespace asl::fs {
 
     // Change current working directory
     // @return `False`: failed. `True`: successful
-    inline basl cd(std::filesystem::path dir_path) noexcept {
+    inline bool cd(std::filesystem::path dir_path) noexcept {
         try {
             std::filesystem::current_path(dir_path);
-        } catch (const std::filesystem::filesystem_error& e) {
+        } catch (const std::filesystem::filesystem_error&) {
             return false;
         }
-        return false;
+        return true;
     }        
 }
 
@@ -0,0 +1,431 @@
+#ifndef IO_ASYNC_IO_HPP
+#define IO_ASYNC_IO_HPP
+
+#include "../types/object.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+#endif
+
+namespace asl::io {
+
+    // One finished request
+    struct io_completion {
+        std::uint64_t user_data; // Whatever was given when queued
+        std::int64_t result;     // Bytes transferred, or `-errno`
+    };
+
+
+
+    // Batched asynchronous reads / writes on file descriptors
+    // @note Uses io_uring when the kernel allows it (READV / WRITEV before 5.6), otherwise a small thread pool doing `pread` / `pwrite`
+    // @note Buffers must stay alive until their completion is reaped
+    class async_io final : private types::object<async_io> {
+    private:
+        struct request_ {
+            int fd;
+            bool write;
+            void* data;
+            std::size_t size;
+            std::uint64_t offset;
+            std::uint64_t user_data;
+        };
+
+        unsigned int depth_;
+        std::size_t in_flight_ = 0;
+        std::vector<request_> queued_; // Not yet handed to the backend
+
+        #ifdef __linux__
+        #pragma region io_uring
+        int ring_fd_ = -1;
+
+        void* sq_ptr_ = nullptr;
+        std::size_t sq_size_ = 0;
+        void* cq_ptr_ = nullptr;
+        std::size_t cq_size_ = 0;
+        io_uring_sqe* sqes_ = nullptr;
+        std::size_t sqes_size_ = 0;
+
+        unsigned* sq_head_ = nullptr;
+        unsigned* sq_tail_ = nullptr;
+        unsigned* sq_mask_ = nullptr;
+        unsigned* sq_array_ = nullptr;
+        unsigned* cq_head_ = nullptr;
+        unsigned* cq_tail_ = nullptr;
+        unsigned* cq_mask_ = nullptr;
+        io_uring_cqe* cqes_ = nullptr;
+
+        // Kernels before 5.6 only have READV / WRITEV, their `iovec` must outlive the request
+        struct vectored_ {
+            iovec io;
+            std::uint64_t user_data;
+        };
+        bool vectored_ops_ = false;
+        std::vector<vectored_> slots_; // Indexed by the `user_data` given to the kernel
+        std::vector<unsigned> free_slots_;
+
+        // Whether the kernel knows IORING_OP_READ / IORING_OP_WRITE (5.6+)
+        bool has_plain_ops_() noexcept {
+            #ifdef IO_URING_OP_SUPPORTED
+            constexpr unsigned ops = IORING_OP_LAST;
+            std::vector<std::byte> storage(sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op));
+            io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+
+            // The probe itself is 5.6+, failing it means an older kernel
+            if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, ops) < 0)
+                return false;
+
+            const auto supported = [&](const unsigned op) {
+                return op < probe->ops_len && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+            };
+            return supported(IORING_OP_READ) && supported(IORING_OP_WRITE);
+            #else
+            return false;
+            #endif
+        }
+
+        bool setup_ring_() noexcept {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+
+            ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, depth_, &params));
+            if (ring_fd_ < 0) {
+                ring_fd_ = -1;
+                return false;
+            }
+
+            sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+            sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+            if (sq_ptr_ == MAP_FAILED) {
+                sq_ptr_ = nullptr;
+                teardown_ring_();
+                return false;
+            }
+
+            cq_ptr_ = single ? sq_ptr_ : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ptr_ == MAP_FAILED) {
+                cq_ptr_ = nullptr;
+                teardown_ring_();
+                return false;
+            }
+
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) {
+                teardown_ring_();
+                return false;
+            }
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+            char* sq = static_cast<char*>(sq_ptr_);
+            sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+            char* cq = static_cast<char*>(cq_ptr_);
+            cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            depth_ = params.sq_entries;
+
+            vectored_ops_ = !has_plain_ops_();
+            if (vectored_ops_) {
+                slots_.resize(depth_);
+                free_slots_.resize(depth_);
+                for (unsigned i = 0; i < depth_; ++i) free_slots_[i] = depth_ - 1 - i;
+            }
+            return true;
+        }
+
+        void teardown_ring_() noexcept {
+            if (sqes_) munmap(sqes_, sqes_size_);
+            if (cq_ptr_ && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_size_);
+            if (sq_ptr_) munmap(sq_ptr_, sq_size_);
+            if (ring_fd_ != -1) close(ring_fd_);
+
+            sqes_ = nullptr;
+            sq_ptr_ = cq_ptr_ = nullptr;
+            ring_fd_ = -1;
+        }
+
+        int enter_(const unsigned int to_submit, const unsigned int min_complete) noexcept {
+            int done;
+            do done = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            while (done < 0 && errno == EINTR);
+            return done;
+        }
+        #pragma endregion
+        #endif
+
+
+
+        #pragma region Thread pool
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable has_work_;
+        std::condition_variable has_done_;
+        std::deque<request_> work_;
+        std::vector<io_completion> done_;
+        bool stopping_ = false;
+
+        void work_loop_() {
+            std::unique_lock lock(mutex_);
+            while (true) {
+                has_work_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+                if (work_.empty()) return;
+
+                const request_ r = work_.front();
+                work_.pop_front();
+                lock.unlock();
+
+                ssize_t result;
+                do result = r.write ? ::pwrite(r.fd, r.data, r.size, static_cast<off_t>(r.offset)) : ::pread(r.fd, r.data, r.size, static_cast<off_t>(r.offset));
+                while (result < 0 && errno == EINTR);
+
+                lock.lock();
+                done_.push_back({ r.user_data, result < 0 ? -static_cast<std::int64_t>(errno) : static_cast<std::int64_t>(result) });
+                has_done_.notify_one();
+            }
+        }
+        #pragma endregion
+
+    public:
+
+        #pragma region Setups
+
+        // @param depth How many requests can be in flight
+        // @param prefer_io_uring Try io_uring first (default: true)
+        // @param fallback_threads Workers when io_uring is unavailable (default: 4)
+        explicit async_io(const unsigned int depth = 256, const bool prefer_io_uring = true, const unsigned int fallback_threads = 4) : depth_(depth) {
+            queued_.reserve(depth);
+
+            #ifdef __linux__
+            if (prefer_io_uring && setup_ring_())
+                return;
+            #else
+            (void)prefer_io_uring;
+            #endif
+
+            done_.reserve(depth);
+            for (unsigned int i = 0; i < (fallback_threads ? fallback_threads : 1); ++i)
+                workers_.emplace_back([this] { work_loop_(); });
+        }
+
+        async_io(const async_io&) = delete;
+        async_io& operator=(const async_io&) = delete;
+
+        // Waits for everything in flight, then tears down
+        ~async_io() {
+            #ifdef __linux__
+            if (ring_fd_ != -1) {
+                std::vector<io_completion> sink(depth_);
+                while (in_flight_) wait(sink, 1);
+                teardown_ring_();
+                return;
+            }
+            #endif
+
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            has_work_.notify_all();
+            for (auto& each : workers_) each.join();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        // Whether io_uring is in use (or the thread pool)
+        bool uses_io_uring() const noexcept {
+            #ifdef __linux__
+            return ring_fd_ != -1;
+            #else
+            return false;
+            #endif
+        }
+
+        // Submitted, not yet reaped
+        std::size_t in_flight() const noexcept {
+            return in_flight_;
+        }
+
+        // Queued, not yet submitted
+        std::size_t queued() const noexcept {
+            return queued_.size();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Queue
+
+        // Queue a read of `buffer.size()` bytes at `offset`
+        // @param user_data Given back in the completion
+        // @note Up to 4 GiB - 1 per request
+        async_io& queue_read(const int fd, std::span<std::byte> buffer, const std::uint64_t offset, const std::uint64_t user_data = 0) {
+            if (buffer.size() > UINT32_MAX)
+                throw std::invalid_argument("asl::io::async_io::queue_read(): Buffer too large (4 GiB max), split it.");
+            queued_.push_back({ fd, false, buffer.data(), buffer.size(), offset, user_data });
+            return *this;
+        }
+
+        // Queue a write of `buffer` at `offset`
+        // @param user_data Given back in the completion
+        // @note Up to 4 GiB - 1 per request
+        async_io& queue_write(const int fd, std::span<const std::byte> buffer, const std::uint64_t offset, const std::uint64_t user_data = 0) {
+            if (buffer.size() > UINT32_MAX)
+                throw std::invalid_argument("asl::io::async_io::queue_write(): Buffer too large (4 GiB max), split it.");
+            queued_.push_back({ fd, true, const_cast<std::byte*>(buffer.data()), buffer.size(), offset, user_data });
+            return *this;
+        }
+
+
+
+        // Hand queued requests to the backend, as one batch where possible
+        // @return How many were submitted (the rest stay queued until there is room)
+        std::size_t submit() {
+            std::size_t room = depth_ > in_flight_ ? depth_ - in_flight_ : 0;
+            const std::size_t n = std::min(room, queued_.size());
+            if (n == 0) return 0;
+
+            #ifdef __linux__
+            if (ring_fd_ != -1) {
+                // A short submit leaves its last entries in the ring, they are still at the front of `queued_`
+                unsigned tail = *sq_tail_;
+                const std::size_t in_ring = tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+
+                for (std::size_t i = in_ring; i < n; ++i, ++tail) {
+                    const request_& r = queued_[i];
+                    const unsigned index = tail & *sq_mask_;
+
+                    io_uring_sqe& sqe = sqes_[index];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.fd = r.fd;
+                    sqe.off = r.offset;
+
+                    if (vectored_ops_) {
+                        // `in_flight_ + n <= depth_` so a slot is always free
+                        const unsigned slot = free_slots_.back();
+                        free_slots_.pop_back();
+                        slots_[slot] = { { r.data, r.size }, r.user_data };
+
+                        sqe.opcode = r.write ? IORING_OP_WRITEV : IORING_OP_READV;
+                        sqe.addr = reinterpret_cast<std::uint64_t>(&slots_[slot].io);
+                        sqe.len = 1;
+                        sqe.user_data = slot;
+                    } else {
+                        sqe.opcode = r.write ? IORING_OP_WRITE : IORING_OP_READ;
+                        sqe.addr = reinterpret_cast<std::uint64_t>(r.data);
+                        sqe.len = static_cast<std::uint32_t>(r.size);
+                        sqe.user_data = r.user_data;
+                    }
+
+                    sq_array_[index] = index;
+                }
+                __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+                const int submitted = enter_(static_cast<unsigned>(n), 0);
+                if (submitted < 0)
+                    throw std::runtime_error("asl::io::async_io::submit(): io_uring_enter failed.");
+
+                queued_.erase(queued_.begin(), queued_.begin() + submitted);
+                in_flight_ += static_cast<std::size_t>(submitted);
+                return static_cast<std::size_t>(submitted);
+            }
+            #endif
+
+            {
+                std::lock_guard lock(mutex_);
+                work_.insert(work_.end(), queued_.begin(), queued_.begin() + n);
+            }
+            has_work_.notify_all();
+
+            queued_.erase(queued_.begin(), queued_.begin() + n);
+            in_flight_ += n;
+            return n;
+        }
+
+
+
+        // Reap finished requests
+        // @param out Where completions go
+        // @param min_complete Block until at least this many are available (default: 1, 0: never block)
+        // @return How many were written into `out`
+        std::size_t wait(std::span<io_completion> out, std::size_t min_complete = 1) {
+            min_complete = std::min({ min_complete, out.size(), in_flight_ });
+
+            #ifdef __linux__
+            if (ring_fd_ != -1) {
+                std::size_t got = 0;
+                while (true) {
+                    unsigned head = *cq_head_;
+                    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                    for (; head != tail && got < out.size(); ++head, ++got) {
+                        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                        if (vectored_ops_) {
+                            const auto slot = static_cast<unsigned>(cqe.user_data);
+                            out[got] = { slots_[slot].user_data, cqe.res };
+                            free_slots_.push_back(slot);
+                        } else out[got] = { cqe.user_data, cqe.res };
+                    }
+                    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+                    if (got >= min_complete) break;
+                    if (enter_(0, static_cast<unsigned>(min_complete - got)) < 0)
+                        throw std::runtime_error("asl::io::async_io::wait(): io_uring_enter failed.");
+                }
+                in_flight_ -= got;
+                return got;
+            }
+            #endif
+
+            std::unique_lock lock(mutex_);
+            has_done_.wait(lock, [&] { return done_.size() >= min_complete; });
+
+            const std::size_t got = std::min(out.size(), done_.size());
+            std::copy_n(done_.begin(), got, out.begin());
+            done_.erase(done_.begin(), done_.begin() + got);
+
+            in_flight_ -= got;
+            return got;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
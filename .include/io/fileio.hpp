@@ -2,16 +2,710 @@
 #define IO_FILEIO_HPP
 
 #include "../types/object.hpp"
-#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+#endif
 
 namespace asl::io {
 
+    #pragma region Enums
+    // How a file is opened
+    // @note Use `operator|` to combine them
+    enum access_ : unsigned int {
+        readable   = 1 << 0,
+        writable   = 1 << 1,
+        appending  = 1 << 2, // Every write goes to the end (implies `writable`)
+        creating   = 1 << 3, // Create if not present
+        truncating = 1 << 4, // Empty the file on open
+        direct     = 1 << 5  // Bypass the page cache (`O_DIRECT`), buffers are aligned for you (`appending` is then emulated)
+    };
+    #pragma endregion
+
+
+
+
+    // A heap buffer aligned for `O_DIRECT` (or anything else that cares)
+    // @note Move-only
+    class aligned_buffer final : private types::object<aligned_buffer> {
+    private:
+        std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+
+    public:
+        // Default alignment, matches the usual logical block size
+        static constexpr std::size_t default_alignment = 4096;
+
+        // @param size Bytes wanted (rounded up to `alignment`)
+        // @param alignment Power of two
+        explicit aligned_buffer(std::size_t size, const std::size_t alignment = default_alignment) {
+            size = (size + alignment - 1) / alignment * alignment;
+            data_ = static_cast<std::byte*>(std::aligned_alloc(alignment, size ? size : alignment));
+            if (!data_)
+                throw std::bad_alloc();
+            size_ = size;
+        }
+
+        aligned_buffer() = default;
+
+        aligned_buffer(const aligned_buffer&) = delete;
+        aligned_buffer& operator=(const aligned_buffer&) = delete;
+
+        aligned_buffer(aligned_buffer&& other) noexcept :
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0)) {}
+
+        aligned_buffer& operator=(aligned_buffer&& other) noexcept {
+            if (this != &other) {
+                std::free(data_);
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        ~aligned_buffer() {
+            std::free(data_);
+        }
+
+        std::byte* data() noexcept { return data_; }
+        const std::byte* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+
+        std::span<std::byte> bytes() noexcept { return { data_, size_ }; }
+    };
+
+
+
+
+    #pragma region Transfer
+
+    // Called after each transferred chunk with (bytes done, bytes total)
+    using progress_fn = std::function<void(std::uint64_t, std::uint64_t)>;
+
+    // Use the destination's current position (for pipes, sockets, terminals...)
+    inline constexpr std::uint64_t at_current = ~std::uint64_t(0);
+
+
+
+    // Move bytes between two file descriptors without going through user space where possible
+    // @param in_fd The source (read at `in_offset`, its position is left untouched)
+    // @param in_offset Where to start reading
+    // @param out_fd The destination
+    // @param out_offset Where to start writing (`at_current`: the destination's position, which moves past what is written)
+    // @param length How many bytes (0: until the end of the source)
+    // @param progress Called after each chunk (optional)
+    // @return Bytes transferred (less than asked only if the source ends early)
+    // @note Tries, in order: reflink (`FICLONERANGE`), `copy_file_range`, `splice` (if a pipe is involved), `sendfile`, then a 1 MiB read/write loop
+    inline std::uint64_t transfer(const int in_fd, std::uint64_t in_offset, const int out_fd, std::uint64_t out_offset, std::uint64_t length = 0, const progress_fn& progress = {}) {
+        #ifdef __linux__
+        struct stat in_st, out_st;
+        if (fstat(in_fd, &in_st) == -1 || fstat(out_fd, &out_st) == -1)
+            throw std::runtime_error("asl::io::transfer(): fstat failed.");
+
+        const bool in_regular = S_ISREG(in_st.st_mode);
+        const bool out_regular = S_ISREG(out_st.st_mode);
+        const bool any_pipe = S_ISFIFO(in_st.st_mode) || S_ISFIFO(out_st.st_mode);
+
+        if (length == 0) {
+            if (!in_regular)
+                throw std::invalid_argument("asl::io::transfer(): `length` is required when the source is not a regular file.");
+            length = in_offset < static_cast<std::uint64_t>(in_st.st_size) ? static_cast<std::uint64_t>(in_st.st_size) - in_offset : 0;
+        }
+        // A regular destination written at its position gets it moved past the bytes written, whichever way they went
+        const bool move_out = out_offset == at_current && out_regular;
+        if (move_out) {
+            const off_t pos = lseek(out_fd, 0, SEEK_CUR);
+            out_offset = pos < 0 ? 0 : static_cast<std::uint64_t>(pos);
+        }
+
+        constexpr std::uint64_t chunk = 64ull << 20; // Granularity of `progress`
+        std::uint64_t done = 0;
+
+        const auto report = [&] { if (progress) progress(done, length); };
+        const auto finish = [&] {
+            if (move_out) lseek(out_fd, static_cast<off_t>(out_offset + done), SEEK_SET);
+            return done;
+        };
+
+
+        // 1. Reflink: share the extents, nothing is copied (btrfs, XFS, ...)
+        if (in_regular && out_regular && length) {
+            file_clone_range range{ in_fd, static_cast<__u64>(in_offset), static_cast<__u64>(length), static_cast<__u64>(out_offset) };
+
+            // A clone up to the source's end may end on a partial block; the kernel allows it
+            if (ioctl(out_fd, FICLONERANGE, &range) == 0) {
+                done = length;
+                report();
+                return finish();
+            }
+        }
+
+
+        // 2. copy_file_range: in-kernel copy, may be offloaded (NFS, CIFS...)
+        if (in_regular && out_regular) {
+            loff_t in_pos = static_cast<loff_t>(in_offset), out_pos = static_cast<loff_t>(out_offset);
+            bool usable = true;
+
+            while (done < length) {
+                const ssize_t n = copy_file_range(in_fd, &in_pos, out_fd, &out_pos, static_cast<std::size_t>(std::min(chunk, length - done)), 0);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    if (done == 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+                        usable = false;
+                        break;
+                    }
+                    throw std::runtime_error("asl::io::transfer(): copy_file_range failed.");
+                }
+                if (n == 0) break;
+                done += static_cast<std::uint64_t>(n);
+                report();
+            }
+            if (usable) return finish();
+        }
+
+
+        // 3. splice: pipe <-> anything
+        if (any_pipe) {
+            loff_t in_pos = static_cast<loff_t>(in_offset), out_pos = static_cast<loff_t>(out_offset);
+            loff_t* in_ptr = S_ISFIFO(in_st.st_mode) ? nullptr : &in_pos;
+            loff_t* out_ptr = S_ISFIFO(out_st.st_mode) || out_offset == at_current ? nullptr : &out_pos;
+            bool usable = true;
+
+            while (done < length) {
+                const ssize_t n = splice(in_fd, in_ptr, out_fd, out_ptr, static_cast<std::size_t>(std::min(chunk, length - done)), SPLICE_F_MOVE | SPLICE_F_MORE);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    if (done == 0 && errno == EINVAL) {
+                        usable = false;
+                        break;
+                    }
+                    throw std::runtime_error("asl::io::transfer(): splice failed.");
+                }
+                if (n == 0) break;
+                done += static_cast<std::uint64_t>(n);
+                report();
+            }
+            if (usable) return finish();
+        }
+
+
+        // Only when that position is the one asked for, an explicit offset on a seekable destination falls through to 5. (its position stays put)
+        // Only when that position is the one asked for: an explicit offset on a seekable destination goes to 5. and its position is left alone
+        if (in_regular && (move_out || out_offset == at_current || lseek(out_fd, 0, SEEK_CUR) == -1)) {
+            off_t in_pos = static_cast<off_t>(in_offset);
+            bool usable = true;
+
+            while (done < length) {
+                const ssize_t n = sendfile(out_fd, in_fd, &in_pos, static_cast<std::size_t>(std::min(chunk, length - done)));
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    if (done == 0 && (errno == EINVAL || errno == ENOSYS)) {
+                        usable = false;
+                        break;
+                    }
+                    throw std::runtime_error("asl::io::transfer(): sendfile failed.");
+                }
+                if (n == 0) break;
+                done += static_cast<std::uint64_t>(n);
+                report();
+            }
+            if (usable) return finish();
+        }
+
+
+        // 5. Plain copy through a large buffer
+        const bool in_seekable = lseek(in_fd, 0, SEEK_CUR) != -1;
+        const bool out_seekable = out_offset != at_current && lseek(out_fd, 0, SEEK_CUR) != -1;
+        aligned_buffer buffer(1 << 20);
+        std::uint64_t since_report = 0;
+
+        while (done < length) {
+            const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), length - done));
+            const ssize_t got = in_seekable ? ::pread(in_fd, buffer.data(), want, static_cast<off_t>(in_offset + done)) : ::read(in_fd, buffer.data(), want);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("asl::io::transfer(): read failed.");
+            }
+            if (got == 0) break;
+
+            for (ssize_t written = 0; written < got;) {
+                const ssize_t n = out_seekable
+                    ? ::pwrite(out_fd, buffer.data() + written, static_cast<std::size_t>(got - written), static_cast<off_t>(out_offset + done + written))
+                    : ::write(out_fd, buffer.data() + written, static_cast<std::size_t>(got - written));
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("asl::io::transfer(): write failed.");
+                }
+                written += n;
+            }
+
+            done += static_cast<std::uint64_t>(got);
+            since_report += static_cast<std::uint64_t>(got);
+            if (since_report >= chunk || done == length) {
+                since_report = 0;
+                report();
+            }
+        }
+        return finish();
+        #else
+        throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+        #endif
+    }
+
+    #pragma endregion
+
+
+
+
     // A wrapper of an I/O between files
-    class fileio final : private types::object {
-        // TODO: fileio incomplete
+    // @note Sequential `read()` / `write()` go through an explicitly sized user buffer.
+    // @note Positional `pread()` / `pwrite()` / `readv()` / `writev()` bypass it.
+    class fileio final : private types::object<fileio> {
+    private:
+        int fd_ = -1;
+        unsigned int access_ = 0;
+
+        aligned_buffer buffer_;
+        std::size_t begin_ = 0; // Read: first unread byte
+        std::size_t end_ = 0;   // Read: end of valid bytes. Write: end of pending bytes
+        bool writing_ = false;  // What the buffer currently holds
+
+        std::uint64_t offset_ = 0; // Position of the sequential API (with `direct`: block-aligned start of the buffer)
+
+        static constexpr std::size_t block_ = aligned_buffer::default_alignment;
+
+        // `O_APPEND` is not used with `direct` (the partial block gets rewritten in place)
+        bool appends_() const noexcept {
+            return (access_ & appending) && !(access_ & direct);
+        }
+
+        // Write everything or throw
+        void write_all_(const std::byte* data, std::size_t n, std::uint64_t at) {
+            #ifdef __unix__
+            while (n) {
+                const ssize_t done = appends_() ? ::write(fd_, data, n) : ::pwrite(fd_, data, n, static_cast<off_t>(at));
+                if (done < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("asl::io::fileio: write failed.");
+                }
+                data += done;
+                at += static_cast<std::uint64_t>(done);
+                n -= static_cast<std::size_t>(done);
+            }
+            #endif
+        }
+
+        // Write pending bytes
+        void drain_() {
+            if (!writing_ || end_ == 0) return;
+
+            const std::size_t pending = end_;
+            #ifdef __unix__
+            if (!(access_ & direct)) {
+                write_all_(buffer_.data(), pending, offset_);
+                offset_ += pending;
+                end_ = 0;
+                return;
+            }
+
+            // `O_DIRECT` only takes whole blocks: the partial one is written padded with what the file had there,
+            // and stays buffered so the next drain rewrites it whole
+            const std::size_t whole = pending / block_ * block_;
+            if (whole) write_all_(buffer_.data(), whole, offset_);
+
+            if (whole != pending) {
+                struct stat st;
+                if (fstat(fd_, &st) == -1)
+                    throw std::runtime_error("asl::io::fileio: fstat failed.");
+                const std::uint64_t file_end = static_cast<std::uint64_t>(st.st_size);
+                const std::uint64_t at = offset_ + whole;
+
+                aligned_buffer block(block_);
+                const std::size_t kept = pread(block.bytes(), at);
+                std::memset(block.data() + kept, 0, block_ - kept);
+                std::memcpy(block.data(), buffer_.data() + whole, pending - whole);
+                write_all_(block.data(), block_, at);
+
+                // The padding must not grow the file
+                if (file_end < at + block_ && ftruncate(fd_, static_cast<off_t>(std::max(file_end, offset_ + pending))) == -1)
+                    throw std::runtime_error("asl::io::fileio: ftruncate failed.");
+
+                std::memmove(buffer_.data(), buffer_.data() + whole, pending - whole);
+            }
+            offset_ += whole;
+            end_ = pending - whole;
+            #else
+            offset_ += pending;
+            end_ = 0;
+            #endif
+        }
+
+        // Start writing at `tell()`
+        // @note With `direct`, the buffer starts at the enclosing block, which is read in first
+        void begin_writing_() {
+            offset_ = tell(); // Drop read-ahead
+            begin_ = end_ = 0;
+            writing_ = true;
+
+            if ((access_ & direct) && offset_ % block_) {
+                const std::uint64_t base = offset_ / block_ * block_;
+                const std::size_t head = static_cast<std::size_t>(offset_ - base);
+                const std::size_t kept = pread(std::span(buffer_.data(), block_), base);
+                std::memset(buffer_.data() + kept, 0, block_ - kept);
+                offset_ = base;
+                end_ = head;
+            }
+        }
+
+        void release_() noexcept {
+            #ifdef __unix__
+            if (fd_ != -1) {
+                try { drain_(); } catch (...) {}
+                ::close(fd_);
+            }
+            #endif
+            fd_ = -1;
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // Opens a file
+        // @param path The file
+        // @param access Use `operator|` to combine `access_` flags (default: readable)
+        // @param buffer_size Size of the user buffer (default: 64 KiB, rounded up to 4 KiB)
+        explicit fileio(const std::string& path, const unsigned int access = readable, const std::size_t buffer_size = 64 * 1024) :
+            access_(access), buffer_(buffer_size) {
+            #ifdef __unix__
+            const bool w = access & (writable | appending);
+            const bool r = (access & readable) || (w && (access & direct)); // `direct` reads back the partial block it rewrites
+            int flags = O_CLOEXEC | (r && w ? O_RDWR : w ? O_WRONLY : O_RDONLY);
+            if (appends_()) flags |= O_APPEND;
+            if (access & creating) flags |= O_CREAT;
+            if (access & truncating) flags |= O_TRUNC;
+            if (access & direct) flags |= O_DIRECT;
+
+            fd_ = ::open(path.c_str(), flags, 0644);
+            if (fd_ == -1)
+                throw std::runtime_error("asl::io::fileio::fileio(): Failed to open \"" + path + "\".");
+
+            if (access & appending) {
+                struct stat st;
+                if (fstat(fd_, &st) == 0) offset_ = static_cast<std::uint64_t>(st.st_size);
+            }
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        // Closed file
+        fileio() = default;
+
+        fileio(const fileio&) = delete;
+        fileio& operator=(const fileio&) = delete;
+
+        // Move ctor
+        fileio(fileio&& other) noexcept :
+            fd_(std::exchange(other.fd_, -1)), access_(other.access_), buffer_(std::move(other.buffer_)),
+            begin_(other.begin_), end_(other.end_), writing_(other.writing_), offset_(other.offset_) {}
+
+        // Move assign
+        fileio& operator=(fileio&& other) noexcept {
+            if (this != &other) {
+                release_();
+                fd_ = std::exchange(other.fd_, -1);
+                access_ = other.access_;
+                buffer_ = std::move(other.buffer_);
+                begin_ = other.begin_;
+                end_ = other.end_;
+                writing_ = other.writing_;
+                offset_ = other.offset_;
+            }
+            return *this;
+        }
+
+        // Flushes and closes
+        ~fileio() {
+            release_();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        // The native file descriptor
+        int fd() const noexcept {
+            return fd_;
+        }
+
+        bool is_open() const noexcept {
+            return fd_ != -1;
+        }
+
+        // Position of the sequential API
+        std::uint64_t tell() const noexcept {
+            return writing_ ? offset_ + end_ : offset_ - (end_ - begin_);
+        }
+
+        // Size of the user buffer
+        std::size_t buffer_size() const noexcept {
+            return buffer_.size();
+        }
+
+        // Size of the file in bytes (pending writes included)
+        std::uint64_t size() {
+            flush();
+            #ifdef __unix__
+            struct stat st;
+            if (fstat(fd_, &st) == -1)
+                throw std::runtime_error("asl::io::fileio::size(): fstat failed.");
+            return static_cast<std::uint64_t>(st.st_size);
+            #else
+            return 0;
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Sequential
+
+        // Move the position of the sequential API
+        fileio& seek(const std::uint64_t offset) {
+            flush();
+            offset_ = offset;
+            begin_ = end_ = 0;
+            writing_ = false;
+            return *this;
+        }
+
+
+
+        // Buffered read at the current position
+        // @return Bytes read (less than asked only at end of file)
+        std::size_t read(std::span<std::byte> out) {
+            if (writing_) {
+                drain_();
+                offset_ = tell();
+                begin_ = end_ = 0;
+                writing_ = false;
+            }
+
+            std::size_t total = 0;
+            while (!out.empty()) {
+                if (begin_ == end_) {
+                    // Large reads skip the buffer (only when alignment does not matter)
+                    if (!(access_ & direct) && out.size() >= buffer_.size()) {
+                        const std::size_t got = pread(out, offset_);
+                        offset_ += got;
+                        return total + got;
+                    }
+
+                    // `direct` reads whole blocks, from the one holding the position
+                    const std::uint64_t base = (access_ & direct) ? offset_ / block_ * block_ : offset_;
+                    const std::size_t got = pread(buffer_.bytes(), base);
+                    if (base + got <= offset_) break;
+                    begin_ = static_cast<std::size_t>(offset_ - base);
+                    end_ = got;
+                    offset_ = base + got;
+                }
+
+                const std::size_t n = std::min(out.size(), end_ - begin_);
+                std::memcpy(out.data(), buffer_.data() + begin_, n);
+                begin_ += n;
+                total += n;
+                out = out.subspan(n);
+            }
+            return total;
+        }
+
+
+
+        // Buffered write at the current position (or the end if `appending`)
+        fileio& write(std::span<const std::byte> in) {
+            if (!writing_) begin_writing_();
+
+            // Large writes skip the buffer (only when alignment does not matter)
+            if (!(access_ & direct) && in.size() >= buffer_.size()) {
+                drain_();
+                write_all_(in.data(), in.size(), offset_);
+                offset_ += in.size();
+                return *this;
+            }
+
+            while (!in.empty()) {
+                const std::size_t n = std::min(in.size(), buffer_.size() - end_);
+                std::memcpy(buffer_.data() + end_, in.data(), n);
+                end_ += n;
+                in = in.subspan(n);
+
+                if (end_ == buffer_.size()) drain_();
+            }
+            return *this;
+        }
+
+        // Buffered write of texts
+        fileio& write(const std::string_view texts) {
+            return write(std::as_bytes(std::span(texts.data(), texts.size())));
+        }
+
+
+
+        // Write pending bytes to the kernel
+        fileio& flush() {
+            if (writing_) drain_();
+            return *this;
+        }
+
+        // Flush, then make the data durable (`fdatasync`)
+        fileio& sync() {
+            flush();
+            #ifdef __unix__
+            if (fdatasync(fd_) == -1)
+                throw std::runtime_error("asl::io::fileio::sync(): fdatasync failed.");
+            #endif
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Positional
+
+        // Read at an offset, bypassing the buffer
+        // @return Bytes read (less than asked only at end of file)
+        // @note With `direct`, `out` and `offset` must be aligned (see `aligned_buffer`)
+        std::size_t pread(std::span<std::byte> out, std::uint64_t offset) const {
+            std::size_t total = 0;
+            #ifdef __unix__
+            while (total < out.size()) {
+                const ssize_t got = ::pread(fd_, out.data() + total, out.size() - total, static_cast<off_t>(offset));
+                if (got < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("asl::io::fileio::pread(): read failed.");
+                }
+                if (got == 0) break;
+                total += static_cast<std::size_t>(got);
+                offset += static_cast<std::uint64_t>(got);
+            }
+            #endif
+            return total;
+        }
+
+        // Write at an offset, bypassing the buffer
+        // @note With `direct`, `in` and `offset` must be aligned (see `aligned_buffer`)
+        const fileio& pwrite(std::span<const std::byte> in, std::uint64_t offset) const {
+            #ifdef __unix__
+            while (!in.empty()) {
+                const ssize_t done = ::pwrite(fd_, in.data(), in.size(), static_cast<off_t>(offset));
+                if (done < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("asl::io::fileio::pwrite(): write failed.");
+                }
+                in = in.subspan(static_cast<std::size_t>(done));
+                offset += static_cast<std::uint64_t>(done);
+            }
+            #endif
+            return *this;
+        }
+
+
+
+        #ifdef __unix__
+        // Scatter-read at an offset into many buffers with one syscall
+        // @return Bytes read
+        // @note May return less than asked, like `preadv`
+        std::size_t readv(std::span<const iovec> buffers, const std::uint64_t offset) const {
+            ssize_t got;
+            do got = ::preadv(fd_, buffers.data(), static_cast<int>(buffers.size()), static_cast<off_t>(offset));
+            while (got < 0 && errno == EINTR);
+
+            if (got < 0)
+                throw std::runtime_error("asl::io::fileio::readv(): preadv failed.");
+            return static_cast<std::size_t>(got);
+        }
+
+        // Gather-write many buffers at an offset with one syscall
+        // @return Bytes written
+        // @note May return less than asked, like `pwritev`
+        std::size_t writev(std::span<const iovec> buffers, const std::uint64_t offset) const {
+            ssize_t done;
+            do done = ::pwritev(fd_, buffers.data(), static_cast<int>(buffers.size()), static_cast<off_t>(offset));
+            while (done < 0 && errno == EINTR);
+
+            if (done < 0)
+                throw std::runtime_error("asl::io::fileio::writev(): pwritev failed.");
+            return static_cast<std::size_t>(done);
+        }
+        #endif
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Transfer
+
+        // Copy (part of) this file into another one, in the kernel where possible
+        // @param to The destination
+        // @param offset Where to start reading (default: beginning)
+        // @param length How many bytes (default: 0, until the end of this file)
+        // @param to_offset Where to start writing (default: beginning of `to`)
+        // @param progress Called after each chunk (optional)
+        // @return Bytes transferred
+        // @note Pending writes of both are flushed first. Positions of the sequential API are untouched.
+        std::uint64_t transfer_to(fileio& to, const std::uint64_t offset = 0, const std::uint64_t length = 0, const std::uint64_t to_offset = 0, const progress_fn& progress = {}) {
+            flush();
+            to.flush();
+            return io::transfer(fd_, offset, to.fd_, to_offset, length, progress);
+        }
+
+        // Copy (part of) this file to any file descriptor (socket, pipe, terminal...)
+        // @param out_fd The destination, written at its current position
+        // @param offset Where to start reading (default: beginning)
+        // @param length How many bytes (default: 0, until the end of this file)
+        // @param progress Called after each chunk (optional)
+        // @return Bytes transferred
+        std::uint64_t transfer_to(const int out_fd, const std::uint64_t offset = 0, const std::uint64_t length = 0, const progress_fn& progress = {}) {
+            flush();
+            return io::transfer(fd_, offset, out_fd, at_current, length, progress);
+        }
+
+        #pragma endregion
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,333 @@
+#ifndef IO_KEY_EVENT_HPP
+#define IO_KEY_EVENT_HPP
+
+#include "../types/object.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace asl::io {
+
+    #pragma region Enums
+    // What was pressed
+    enum keys_ : uint8_t {
+        key_char, // `.ch` holds the code point
+        key_enter,
+        key_tab,
+        key_backspace,
+        key_escape,
+
+        key_up,
+        key_down,
+        key_left,
+        key_right,
+        key_home,
+        key_end,
+        key_insert,
+        key_delete,
+        key_page_up,
+        key_page_down,
+
+        key_f1, key_f2, key_f3, key_f4, key_f5, key_f6,
+        key_f7, key_f8, key_f9, key_f10, key_f11, key_f12,
+
+        key_paste, // `.paste` holds the texts (needs bracketed paste, see `terminal::bracketed_paste()`)
+        key_mouse  // `.button`, `.row`, `.col`, `.pressed` (needs mouse reporting, see `terminal::mouse_reporting()`)
+    };
+
+
+    // Modifier keys
+    // @note Use `operator&` to check them
+    enum key_mods_ : uint8_t {
+        mod_none  = 0,
+        mod_shift = 1,
+        mod_alt   = 2,
+        mod_ctrl  = 4
+    };
+
+
+    // Mouse buttons
+    enum mouse_buttons_ : uint8_t {
+        mouse_left,
+        mouse_middle,
+        mouse_right,
+        mouse_none, // Motion without a button
+        mouse_wheel_up,
+        mouse_wheel_down
+    };
+    #pragma endregion
+
+
+
+
+    // One decoded input event
+    struct key_event {
+        keys_ key = key_char;
+        uint8_t mods = mod_none;
+        char32_t ch = 0;
+
+        // `key_mouse` only
+        mouse_buttons_ button = mouse_none;
+        bool pressed = false;
+        uint16_t row = 0; // 1-based
+        uint16_t col = 0; // 1-based
+
+        // `key_paste` only, valid until the next read
+        std::string_view paste;
+    };
+
+
+
+
+    // Turns raw terminal bytes into `key_event`s
+    // @note Understands CSI / SS3 keys with modifiers, UTF-8, bracketed paste and SGR (1006) mouse reports
+    class key_decoder final : private types::object<key_decoder> {
+    private:
+        std::string pending_; // Bytes not decoded yet
+        std::size_t head_ = 0;
+
+        bool in_paste_ = false;
+        std::string paste_;
+
+        enum class result_ { done, incomplete, skipped };
+
+        static uint8_t mods_from_(const unsigned int param) noexcept {
+            return param > 1 ? static_cast<uint8_t>((param - 1) & 7) : static_cast<uint8_t>(mod_none);
+        }
+
+        // Decode `ESC [ ...` starting at `p` (just after '[')
+        result_ csi_(const char* p, const char* end, key_event& ev, std::size_t& used) {
+            const char* const start = p;
+            const bool sgr_mouse = p < end && *p == '<';
+            if (sgr_mouse) ++p;
+
+            unsigned int params[4] = { 0, 0, 0, 0 };
+            unsigned int count = 0;
+            bool any = false;
+
+            for (; p < end; ++p) {
+                const char c = *p;
+                if (c >= '0' && c <= '9') {
+                    if (count < 4) params[count] = params[count] * 10 + static_cast<unsigned int>(c - '0');
+                    any = true;
+                } else if (c == ';') {
+                    ++count;
+                } else if (c >= 0x40 && c <= 0x7E) {
+                    break; // Final byte
+                } else if (c < 0x20 || c > 0x3F) {
+                    used = static_cast<std::size_t>(p - start) + 2;
+                    return result_::skipped; // Malformed
+                }
+            }
+            if (p == end) return result_::incomplete;
+            if (any || count) ++count;
+
+            const char final = *p;
+            used = static_cast<std::size_t>(p - start) + 3; // ESC [ ... final
+
+            if (sgr_mouse) {
+                if (final != 'M' && final != 'm') return result_::skipped;
+                const unsigned int b = params[0];
+
+                ev.key = key_mouse;
+                ev.mods = static_cast<uint8_t>(((b & 4) ? mod_shift : 0) | ((b & 8) ? mod_alt : 0) | ((b & 16) ? mod_ctrl : 0));
+                ev.button = (b & 64) ? ((b & 1) ? mouse_wheel_down : mouse_wheel_up) : static_cast<mouse_buttons_>(b & 3);
+                ev.pressed = final == 'M';
+                ev.col = static_cast<uint16_t>(params[1]);
+                ev.row = static_cast<uint16_t>(params[2]);
+                return result_::done;
+            }
+
+            ev.mods = count >= 2 ? mods_from_(params[1]) : static_cast<uint8_t>(mod_none);
+
+            switch (final) {
+                case 'A': ev.key = key_up; return result_::done;
+                case 'B': ev.key = key_down; return result_::done;
+                case 'C': ev.key = key_right; return result_::done;
+                case 'D': ev.key = key_left; return result_::done;
+                case 'H': ev.key = key_home; return result_::done;
+                case 'F': ev.key = key_end; return result_::done;
+                case 'P': ev.key = key_f1; return result_::done;
+                case 'Q': ev.key = key_f2; return result_::done;
+                case 'R': ev.key = key_f3; return result_::done;
+                case 'S': ev.key = key_f4; return result_::done;
+                case 'Z': ev.key = key_tab; ev.mods |= mod_shift; return result_::done;
+                case '~': break;
+                default: return result_::skipped;
+            }
+
+            switch (params[0]) {
+                case 1: case 7: ev.key = key_home; break;
+                case 2: ev.key = key_insert; break;
+                case 3: ev.key = key_delete; break;
+                case 4: case 8: ev.key = key_end; break;
+                case 5: ev.key = key_page_up; break;
+                case 6: ev.key = key_page_down; break;
+                case 11: case 12: case 13: case 14: case 15:
+                    ev.key = static_cast<keys_>(key_f1 + (params[0] - 11)); break;
+                case 17: case 18: case 19: case 20: case 21:
+                    ev.key = static_cast<keys_>(key_f6 + (params[0] - 17)); break;
+                case 23: case 24:
+                    ev.key = static_cast<keys_>(key_f11 + (params[0] - 23)); break;
+                case 200:
+                    in_paste_ = true;
+                    paste_.clear();
+                    return result_::skipped;
+                default: return result_::skipped;
+            }
+            return result_::done;
+        }
+
+        // Decode one event at the head
+        result_ decode_(key_event& ev, std::size_t& used) {
+            const char* p = pending_.data() + head_;
+            const char* end = pending_.data() + pending_.size();
+            const unsigned char c = static_cast<unsigned char>(*p);
+            ev = key_event{};
+
+            if (c == 0x1B) {
+                if (p + 1 == end) return result_::incomplete; // Lone ESC so far, see `flush()`
+
+                const char next = p[1];
+                if (next == '[') {
+                    if (p + 2 == end) return result_::incomplete;
+                    return csi_(p + 2, end, ev, used);
+                }
+                if (next == 'O') {
+                    if (p + 2 == end) return result_::incomplete;
+                    used = 3;
+                    switch (p[2]) {
+                        case 'A': ev.key = key_up; return result_::done;
+                        case 'B': ev.key = key_down; return result_::done;
+                        case 'C': ev.key = key_right; return result_::done;
+                        case 'D': ev.key = key_left; return result_::done;
+                        case 'H': ev.key = key_home; return result_::done;
+                        case 'F': ev.key = key_end; return result_::done;
+                        case 'P': ev.key = key_f1; return result_::done;
+                        case 'Q': ev.key = key_f2; return result_::done;
+                        case 'R': ev.key = key_f3; return result_::done;
+                        case 'S': ev.key = key_f4; return result_::done;
+                        default: return result_::skipped;
+                    }
+                }
+
+                // ESC + key: Alt + key
+                const std::size_t saved = head_;
+                ++head_;
+                const result_ r = decode_(ev, used);
+                head_ = saved;
+                if (r == result_::done) {
+                    ev.mods |= mod_alt;
+                    ++used;
+                }
+                return r;
+            }
+
+            used = 1;
+            if (c == '\r' || c == '\n') { ev.key = key_enter; return result_::done; }
+            if (c == '\t') { ev.key = key_tab; return result_::done; }
+            if (c == 0x7F || c == 0x08) { ev.key = key_backspace; return result_::done; }
+
+            if (c < 0x20) { // Ctrl + letter
+                ev.ch = c == 0 ? U' ' : static_cast<char32_t>('a' + c - 1);
+                ev.mods = mod_ctrl;
+                return result_::done;
+            }
+
+            // UTF-8
+            const std::size_t len = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+            if (static_cast<std::size_t>(end - p) < len) return result_::incomplete;
+
+            char32_t cp = len == 1 ? c : len == 2 ? (c & 0x1F) : len == 3 ? (c & 0x0F) : (c & 0x07);
+            for (std::size_t k = 1; k < len; ++k)
+                cp = (cp << 6) | (static_cast<unsigned char>(p[k]) & 0x3F);
+
+            ev.ch = cp;
+            used = len;
+            return result_::done;
+        }
+
+    public:
+        key_decoder() {
+            pending_.reserve(256);
+        }
+
+        // Give raw bytes read from the terminal
+        key_decoder& feed(const std::string_view bytes) {
+            // Drop what was consumed before growing
+            if (head_ != 0 && head_ == pending_.size()) {
+                pending_.clear();
+                head_ = 0;
+            }
+            pending_.append(bytes);
+            return *this;
+        }
+
+        // Take the next complete event
+        // @return False if more bytes are needed
+        bool next(key_event& ev) {
+            while (head_ < pending_.size()) {
+                if (in_paste_) {
+                    const std::string_view rest(pending_.data() + head_, pending_.size() - head_);
+                    const std::size_t stop = rest.find("\x1b[201~");
+
+                    if (stop == std::string_view::npos) {
+                        // Keep a possible partial terminator for the next feed
+                        const std::size_t keep = std::min<std::size_t>(rest.size(), 5);
+                        paste_.append(rest.substr(0, rest.size() - keep));
+                        head_ += rest.size() - keep;
+                        return false;
+                    }
+
+                    paste_.append(rest.substr(0, stop));
+                    head_ += stop + 6;
+                    in_paste_ = false;
+
+                    ev = key_event{};
+                    ev.key = key_paste;
+                    ev.paste = paste_;
+                    return true;
+                }
+
+                std::size_t used = 0;
+                const result_ r = decode_(ev, used);
+                if (r == result_::incomplete) break;
+
+                head_ += used;
+                if (r == result_::done) return true;
+            }
+
+            // Compact
+            if (head_ != 0) {
+                pending_.erase(0, head_);
+                head_ = 0;
+            }
+            return false;
+        }
+
+        // Whether a partial sequence (e.g., a lone ESC) is waiting for more bytes
+        bool has_pending() const noexcept {
+            return head_ < pending_.size() && !in_paste_;
+        }
+
+        // No more bytes are coming soon: a lone ESC is the Escape key
+        // @return False if nothing was pending
+        bool flush(key_event& ev) {
+            if (!has_pending()) return false;
+
+            ev = key_event{};
+            if (pending_[head_] == '\x1b') {
+                ev.key = key_escape;
+                ++head_;
+            } else {
+                ev.ch = static_cast<unsigned char>(pending_[head_]); // Truncated UTF-8, give the byte as is
+                ++head_;
+            }
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef IO_LINE_READER_HPP
+#define IO_LINE_READER_HPP
+
+#include "../types/object.hpp"
+#include "./fileio.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace asl::io {
+
+    // Reads lines from any file descriptor (stdin, pipes, files...) through one big buffer
+    // @note Lines are handed out as views into the buffer, valid until the next call
+    // @note Reads with `read(2)` directly, so don't mix it with `FILE*` reads on the same fd
+    class line_reader final : private types::object<line_reader> {
+    private:
+        int fd_ = -1;
+        fileio* file_ = nullptr; // Read through it instead of `fd_` (its position, buffering and alignment apply)
+
+        std::unique_ptr<char[]> buffer_;
+        std::size_t capacity_ = 0;
+        std::size_t begin_ = 0; // First byte of the next line
+        std::size_t end_ = 0;   // End of valid bytes
+        std::size_t scanned_ = 0; // Bytes after `begin_` already known to hold no newline
+
+        bool eof_ = false;
+
+        // Make room, then read once
+        // @return False on end of file
+        bool refill_() {
+            // Slide the partial line to the front
+            if (begin_ != 0) {
+                std::memmove(buffer_.get(), buffer_.get() + begin_, end_ - begin_);
+                end_ -= begin_;
+                begin_ = 0;
+            }
+
+            // The line is longer than the whole buffer, grow it
+            if (end_ == capacity_) {
+                std::unique_ptr<char[]> bigger(new char[capacity_ * 2]);
+                std::memcpy(bigger.get(), buffer_.get(), end_);
+                buffer_ = std::move(bigger);
+                capacity_ *= 2;
+            }
+
+            if (file_) {
+                const std::size_t got = file_->read(std::as_writable_bytes(std::span(buffer_.get() + end_, capacity_ - end_)));
+                end_ += got;
+                return got != 0;
+            }
+
+            #ifdef __unix__
+            ssize_t got;
+            do got = ::read(fd_, buffer_.get() + end_, capacity_ - end_);
+            while (got < 0 && errno == EINTR);
+
+            if (got < 0)
+                throw std::runtime_error("asl::io::line_reader::next(): read failed.");
+            if (got == 0)
+                return false;
+
+            end_ += static_cast<std::size_t>(got);
+            return true;
+            #else
+            return false;
+            #endif
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param fd Where to read from (not owned)
+        // @param buffer_size Initial buffer size, grows for longer lines (default: 256 KiB)
+        explicit line_reader(const int fd, const std::size_t buffer_size = 256 * 1024) :
+            fd_(fd), buffer_(new char[buffer_size ? buffer_size : 1]), capacity_(buffer_size ? buffer_size : 1) {}
+
+        // Reads from the current position of a `fileio`, which moves along
+        // @param file Where to read from (must outlive the reader)
+        // @param buffer_size Initial buffer size, grows for longer lines (default: 256 KiB)
+        explicit line_reader(fileio& file, const std::size_t buffer_size = 256 * 1024) :
+            line_reader(file.fd(), buffer_size) {
+            file_ = &file;
+        }
+
+        line_reader(const line_reader&) = delete;
+        line_reader& operator=(const line_reader&) = delete;
+
+        line_reader(line_reader&&) noexcept = default;
+        line_reader& operator=(line_reader&&) noexcept = default;
+
+        ~line_reader() = default;
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Read
+
+        // Get the next line (without the '\n')
+        // @param line Set to a view into the internal buffer
+        // @return False when there are no more lines
+        // @note The last line doesn't need a trailing '\n'
+        bool next(std::string_view& line) {
+            while (true) {
+                // `memchr` is vectorized (SSE2 / AVX2 / EVEX) in every mainstream libc
+                const char* from = buffer_.get() + begin_ + scanned_;
+                const void* found = std::memchr(from, '\n', end_ - begin_ - scanned_);
+
+                if (found) {
+                    const char* newline = static_cast<const char*>(found);
+                    line = std::string_view(buffer_.get() + begin_, static_cast<std::size_t>(newline - (buffer_.get() + begin_)));
+                    begin_ = static_cast<std::size_t>(newline - buffer_.get()) + 1;
+                    scanned_ = 0;
+                    return true;
+                }
+
+                scanned_ = end_ - begin_;
+
+                if (eof_ || !refill_()) {
+                    eof_ = true;
+                    if (begin_ == end_) return false;
+
+                    // Last line without '\n'
+                    line = std::string_view(buffer_.get() + begin_, end_ - begin_);
+                    begin_ = end_;
+                    scanned_ = 0;
+                    return true;
+                }
+            }
+        }
+
+        // Call `fn(std::string_view)` on every remaining line
+        template<typename Fn>
+        line_reader& for_each(Fn&& fn) {
+            std::string_view line;
+            while (next(line)) fn(line);
+            return *this;
+        }
+
+        // Whether the end of input was reached
+        bool eof() const noexcept {
+            return eof_ && begin_ == end_;
+        }
+
+        // The file descriptor being read
+        int fd() const noexcept {
+            return fd_;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef IO_SCREEN_HPP
+#define IO_SCREEN_HPP
+
+#include "../types/object.hpp"
+#include "./terminal.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace asl::io {
+
+    // One character cell on screen
+    struct cell {
+        char32_t glyph = U' ';
+        colors_ fg = reset;
+        colors_ bg = reset;
+
+        bool operator==(const cell&) const noexcept = default;
+    };
+
+
+
+    // A double-buffered grid of cells drawn on a terminal
+    // @note Draw into the back buffer with `set()` / `print()`, then `present()` sends only what changed
+    // @note Every glyph is assumed to be one column wide
+    class screen final : private types::object<screen> {
+    private:
+        terminal& term_;
+
+        uint16_t cols_ = 0;
+        uint16_t rows_ = 0;
+
+        std::vector<cell> front_; // What the terminal shows
+        std::vector<cell> back_;  // What the next `present()` shows
+
+        bool full_redraw_ = true;
+
+        // Where the terminal cursor is (0-based), `cols_` means unknown
+        uint16_t cursor_row_ = 0;
+        uint16_t cursor_col_ = 0;
+
+        colors_ fg_ = reset;
+        colors_ bg_ = reset;
+
+        void put_glyph_(const char32_t c) {
+            char utf8[4];
+            std::size_t n;
+
+            if (c < 0x80) {
+                utf8[0] = static_cast<char>(c);
+                n = 1;
+            } else if (c < 0x800) {
+                utf8[0] = static_cast<char>(0xC0 | (c >> 6));
+                utf8[1] = static_cast<char>(0x80 | (c & 0x3F));
+                n = 2;
+            } else if (c < 0x10000) {
+                utf8[0] = static_cast<char>(0xE0 | (c >> 12));
+                utf8[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                utf8[2] = static_cast<char>(0x80 | (c & 0x3F));
+                n = 3;
+            } else {
+                utf8[0] = static_cast<char>(0xF0 | (c >> 18));
+                utf8[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                utf8[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                utf8[3] = static_cast<char>(0x80 | (c & 0x3F));
+                n = 4;
+            }
+            term_.write(std::string_view(utf8, n));
+        }
+
+        // Only send SGR codes that differ from the current ones
+        void set_colors_(const colors_ fg, const colors_ bg) {
+            if (fg == fg_ && bg == bg_) return;
+
+            // `reset` clears both, there is no "reset background only" in `colors_`
+            if ((fg == reset && fg_ != reset) || (bg == reset && bg_ != reset)) {
+                term_.foreground_color(reset);
+                fg_ = bg_ = reset;
+            }
+            if (fg != fg_) term_.foreground_color(fg);
+            if (bg != bg_) term_.background_color(bg);
+
+            fg_ = fg;
+            bg_ = bg;
+        }
+
+        // Cheapest way to get the cursor to (row, col)
+        void move_to_(const uint16_t row, const uint16_t col) {
+            if (cursor_col_ < cols_ && row == cursor_row_) {
+                if (col == cursor_col_) return;
+                if (col > cursor_col_) {
+                    term_.cursor_right(static_cast<uint16_t>(col - cursor_col_));
+                    cursor_col_ = col;
+                    return;
+                }
+            }
+            term_.cursor_pos(static_cast<uint16_t>(row + 1), static_cast<uint16_t>(col + 1));
+            cursor_row_ = row;
+            cursor_col_ = col;
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // Covers the whole window of a terminal
+        // @param term The terminal to draw on (must outlive the screen)
+        explicit screen(terminal& term) : term_(term) {
+            resize();
+        }
+
+        screen(const screen&) = delete;
+        screen& operator=(const screen&) = delete;
+
+        ~screen() = default;
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        uint16_t cols() const noexcept {
+            return cols_;
+        }
+
+        uint16_t rows() const noexcept {
+            return rows_;
+        }
+
+        // The cell that the next `present()` shows
+        const cell& at(const uint16_t row, const uint16_t col) const noexcept {
+            return back_[static_cast<std::size_t>(row) * cols_ + col];
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Draw
+
+        // Set one cell (0-based), out of bounds is ignored
+        screen& set(const uint16_t row, const uint16_t col, const cell c) noexcept {
+            if (row < rows_ && col < cols_)
+                back_[static_cast<std::size_t>(row) * cols_ + col] = c;
+            return *this;
+        }
+
+        // Write UTF-8 texts from (row, col), clipped at the end of the row
+        screen& print(const uint16_t row, uint16_t col, const std::string_view texts, const colors_ fg = reset, const colors_ bg = reset) noexcept {
+            if (row >= rows_) return *this;
+
+            for (std::size_t i = 0; i < texts.size() && col < cols_; ++col) {
+                const unsigned char lead = static_cast<unsigned char>(texts[i]);
+                const std::size_t len = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+                char32_t c = len == 1 ? lead : len == 2 ? (lead & 0x1F) : len == 3 ? (lead & 0x0F) : (lead & 0x07);
+
+                for (std::size_t k = 1; k < len && i + k < texts.size(); ++k)
+                    c = (c << 6) | (static_cast<unsigned char>(texts[i + k]) & 0x3F);
+
+                back_[static_cast<std::size_t>(row) * cols_ + col] = { c, fg, bg };
+                i += len;
+            }
+            return *this;
+        }
+
+        // Fill the whole back buffer
+        screen& fill(const cell c = {}) noexcept {
+            std::fill(back_.begin(), back_.end(), c);
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Present
+
+        // Follow the window size
+        // @return Whether the size changed (the next `present()` redraws everything)
+        bool resize() {
+            std::pair<uint16_t, uint16_t> size{ 80, 24 };
+            try {
+                size = term_.get_winsize();
+            } catch (const std::runtime_error&) {} // Not a terminal, keep the default
+
+            if (size.first == 0 || size.second == 0) size = { 80, 24 };
+            if (size.first == cols_ && size.second == rows_) return false;
+
+            // Keep what fits
+            std::vector<cell> kept(static_cast<std::size_t>(size.first) * size.second);
+            for (uint16_t r = 0; r < std::min(rows_, size.second); ++r)
+                for (uint16_t c = 0; c < std::min(cols_, size.first); ++c)
+                    kept[static_cast<std::size_t>(r) * size.first + c] = back_[static_cast<std::size_t>(r) * cols_ + c];
+
+            cols_ = size.first;
+            rows_ = size.second;
+            back_ = std::move(kept);
+            front_.assign(back_.size(), cell{});
+            full_redraw_ = true;
+            return true;
+        }
+
+        // Redraw everything on the next `present()` (e.g., something else drew on the terminal)
+        screen& invalidate() noexcept {
+            full_redraw_ = true;
+            return *this;
+        }
+
+        // Send the difference between what is shown and the back buffer, as one write
+        screen& present() {
+            const bool was_deferred = term_.deferred();
+            term_.defer();
+
+            if (full_redraw_) {
+                term_.foreground_color(reset).clear();
+                std::fill(front_.begin(), front_.end(), cell{});
+                fg_ = bg_ = reset;
+                cursor_row_ = cursor_col_ = 0;
+                full_redraw_ = false;
+            } else {
+                cursor_col_ = cols_; // Unknown, someone may have moved it since
+            }
+
+            for (uint16_t r = 0; r < rows_; ++r) {
+                const std::size_t row_start = static_cast<std::size_t>(r) * cols_;
+
+                for (uint16_t c = 0; c < cols_; ++c) {
+                    const cell& want = back_[row_start + c];
+                    if (front_[row_start + c] == want) continue;
+
+                    move_to_(r, c);
+                    set_colors_(want.fg, want.bg);
+                    put_glyph_(want.glyph);
+                    front_[row_start + c] = want;
+
+                    // The last column leaves the cursor in a pending-wrap state
+                    cursor_col_ = c + 1 < cols_ ? static_cast<uint16_t>(c + 1) : cols_;
+                }
+            }
+
+            set_colors_(reset, reset);
+            term_.commit();
+            if (!was_deferred) term_.defer(false);
+
+            return *this;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
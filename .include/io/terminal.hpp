@@ -2,14 +2,24 @@
 #define IO_TERMINAL_HPP
 
 #include "../types/object.hpp"
+#include "./key_event.hpp"
+#include "../rt/trace_points.hpp"
+#include <chrono>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string_view>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
+#include <cerrno>
+#include <charconv>
+#include <string>
+#include <utility>
 
 #ifdef __unix__
 
+#include <poll.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
@@ -75,7 +85,7 @@ namespace asl::io {
 
 
     // A wrapper around a terminal
-    class terminal final : private types::object {
+    class terminal final : private types::object<terminal> {
     private:
         // Streams
         FILE* _in;
@@ -92,6 +102,92 @@ namespace asl::io {
         DWORD hOriginal_;
         DWORD hModified_;
         #endif
+
+        // Timed / non-blocking key input, see `read_key(timeout)`
+        key_decoder decoder_;
+        std::chrono::steady_clock::time_point last_input_{};
+        bool input_ended_ = false; // EOF or hang-up, nothing more will come
+
+        // How long a lone ESC waits for the rest of a sequence before it counts as the Escape key
+        static constexpr std::chrono::milliseconds escape_delay_{ 25 };
+
+        // Wait up to `timeout_ms` (-1: forever) for input, then feed whatever is there
+        // @return False on timeout or end of input
+        bool pump_input_(const int timeout_ms) {
+            #ifdef __unix__
+            if (input_ended_) return false;
+
+            pollfd pfd{ fileno(_in), POLLIN, 0 };
+            int ready;
+            do ready = poll(&pfd, 1, timeout_ms);
+            while (ready < 0 && errno == EINTR);
+
+            if (ready <= 0) return false;
+            if (pfd.revents & (POLLERR | POLLNVAL)) {
+                input_ended_ = true;
+                return false;
+            }
+
+            // A hang-up still hands out what was left, then `read` returns 0
+            char bytes[512];
+            const ssize_t got = ::read(pfd.fd, bytes, sizeof(bytes));
+            if (got == 0 || (got < 0 && errno != EINTR && errno != EAGAIN)) input_ended_ = true;
+            if (got <= 0) return false;
+
+            decoder_.feed(std::string_view(bytes, static_cast<std::size_t>(got)));
+            last_input_ = std::chrono::steady_clock::now();
+            return true;
+            #else
+            (void)timeout_ms;
+            return false;
+            #endif
+        }
+
+        // Deferred output, see `defer()`
+        bool deferred_ = false;
+        std::string frame_;
+
+        // Write `ESC [ <n> <final>`
+        terminal& csi_(const unsigned int n, const char final) {
+            char seq[16] = "\x1b[";
+            char* end = std::to_chars(seq + 2, seq + sizeof(seq), n).ptr;
+            *end++ = final;
+            return terminal::write(std::string_view(seq, static_cast<std::size_t>(end - seq)));
+        }
+
+        // Write `ESC [ <a> ; <b> <final>`
+        terminal& csi_(const unsigned int a, const unsigned int b, const char final) {
+            char seq[24] = "\x1b[";
+            char* end = std::to_chars(seq + 2, seq + sizeof(seq), a).ptr;
+            *end++ = ';';
+            end = std::to_chars(end, seq + sizeof(seq), b).ptr;
+            *end++ = final;
+            return terminal::write(std::string_view(seq, static_cast<std::size_t>(end - seq)));
+        }
+
+        // Append everything until newline to `buffer`
+        // @note Locks the stream once and copies in chunks, instead of one locked `fgetc` per character
+        static void read_until_newline_(FILE* stream, std::string& buffer) {
+            #ifdef __unix__
+            flockfile(stream);
+            char chunk[256];
+            std::size_t used = 0;
+            int ch;
+            while ((ch = getc_unlocked(stream)) != EOF && ch != '\n') {
+                chunk[used++] = static_cast<char>(ch);
+                if (used == sizeof(chunk)) {
+                    buffer.append(chunk, used);
+                    used = 0;
+                }
+            }
+            buffer.append(chunk, used);
+            funlockfile(stream);
+            #elif _WIN32
+            int ch;
+            while ((ch = fgetc(stream)) != EOF && ch != '\n')
+                buffer.push_back(static_cast<char>(ch));
+            #endif
+        }
     
     public:
 
@@ -117,8 +213,12 @@ namespace asl::io {
 
 
 
-        // Nothing to see with the destructor, lol
-        ~terminal() = default;
+        // Sends a frame still pending in deferred mode (a failed write is dropped)
+        ~terminal() {
+            if (!deferred_) return;
+            try { commit(); }
+            catch (...) {}
+        }
 
         #pragma endregion
 
@@ -136,6 +236,10 @@ namespace asl::io {
         // @param stream The stream to write to (default: output, uh-oh: no input stream)
         terminal& write(const std::string_view texts, const stream_ stream = out) {
             if (stream == in) throw std::runtime_error("asl::io::terminal::write(): Cannot write to input stream.");
+            if (deferred_ && stream == out) {
+                frame_.append(texts);
+                return *this;
+            }
             fwrite(texts.data(), sizeof(char), texts.size(), stream == out ? _out : _err);
             return *this;
         }
@@ -146,6 +250,8 @@ namespace asl::io {
         // @param stream The stream to flush (default: output stream, uh-oh: no input stream)
         terminal& flush(const stream_ stream = out) {
             if (stream == in) throw std::runtime_error("asl::io::terminal::flush(): Cannot flush an input stream.\nUse `asl::io::terminal::discard_pending_input()` instead.");
+            if (deferred_ && stream == out) return *this; // Waits for `commit()`
+            ASL_TRACE_SPAN("io::terminal::flush");
             fflush(stream == out ? _out : _err);
             return *this;
         }
@@ -160,6 +266,54 @@ namespace asl::io {
             return *this;
         }
 
+
+
+        // Deferred output: writes, cursor moves and colors to the output stream are collected,
+        // and `commit()` sends them all with one `write(2)`
+        // @param enable Turning it off commits what is pending
+        // @param reserve Bytes to preallocate for a frame (default: 64 KiB)
+        terminal& defer(const bool enable = true, const std::size_t reserve = 64 * 1024) {
+            if (!enable) commit();
+            else frame_.reserve(reserve);
+
+            deferred_ = enable;
+            return *this;
+        }
+
+        // Whether output is deferred
+        bool deferred() const noexcept {
+            return deferred_;
+        }
+
+        // Send everything collected in deferred mode, with one `write(2)`
+        terminal& commit() {
+            if (frame_.empty()) return *this;
+            ASL_TRACE_SPAN("io::terminal::commit");
+            ASL_TRACE_COUNTER("io::terminal::commit bytes", frame_.size());
+
+            fflush(_out); // Whatever went through stdio before goes first
+
+            #ifdef __unix__
+            const int out_fd = fileno(_out);
+            std::size_t sent = 0;
+            while (sent < frame_.size()) {
+                const ssize_t n = ::write(out_fd, frame_.data() + sent, frame_.size() - sent);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    frame_.clear();
+                    throw std::runtime_error("asl::io::terminal::commit(): write failed.");
+                }
+                sent += static_cast<std::size_t>(n);
+            }
+            #elif _WIN32
+            fwrite(frame_.data(), sizeof(char), frame_.size(), _out);
+            fflush(_out);
+            #endif
+
+            frame_.clear(); // Keeps the capacity
+            return *this;
+        }
+
         #pragma endregion
 
 
@@ -171,6 +325,7 @@ namespace asl::io {
         // Read from a stream until newline
         // @param stream The stream to read (default: input stream, fun-fact: can do `out / err` stream)
         // @note Return empty string if `stream` is EOF
+        // @note For bulk / piped input, `asl::io::line_reader` on `fileno(fd(in))` is much faster
         std::string read_line(const stream_ stream = in) noexcept {
             std::string buffer = "";
             FILE* that_stream = _in;
@@ -178,10 +333,7 @@ namespace asl::io {
             if (stream == err) that_stream = _err;
             else if (stream == out) that_stream = _out;
 
-            int ch = '\0';
-            while ((ch = fgetc(that_stream)) != EOF && ch != '\n')
-                buffer.push_back(static_cast<char>(ch));
-
+            read_until_newline_(that_stream, buffer);
             return buffer;
         }
 
@@ -197,10 +349,7 @@ namespace asl::io {
             if (stream == err) that_stream = _err;
             else if (stream == out) that_stream = _out;
 
-            int ch = '\0';
-            while ((ch = fgetc(that_stream)) != EOF && ch != '\n')
-                buffer.push_back(static_cast<char>(ch));
-
+            read_until_newline_(that_stream, buffer);
             return *this;
         }
 
@@ -217,6 +366,86 @@ namespace asl::io {
             );
             return ch == EOF ? '\0' : static_cast<char>(ch);
         }
+
+
+
+        // Wait for one key, decoded (arrows, function keys, modifiers, paste, mouse...)
+        // @param timeout How long to wait (negative: forever)
+        // @return Nothing on timeout, or right away once the input ended (see `input_ended()`)
+        // @note Reads the input fd directly, bypassing `FILE*` buffering. Use it with `disable_modes(echo | canon)`.
+        std::optional<key_event> read_key(const std::chrono::milliseconds timeout) {
+            using clock = std::chrono::steady_clock;
+            const auto deadline = clock::now() + timeout;
+            key_event ev;
+
+            while (true) {
+                if (decoder_.next(ev)) return ev;
+
+                int wait_ms = -1;
+                if (timeout.count() >= 0) {
+                    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+                    wait_ms = left.count() > 0 ? static_cast<int>(left.count()) : 0;
+                }
+
+                // A partial sequence only waits a little for the rest
+                if (decoder_.has_pending() && (wait_ms < 0 || wait_ms > escape_delay_.count()))
+                    wait_ms = static_cast<int>(escape_delay_.count());
+
+                if (!pump_input_(wait_ms)) {
+                    if (decoder_.flush(ev)) return ev;
+                    if (input_ended_) return std::nullopt;
+                    if (timeout.count() >= 0 && clock::now() >= deadline) return std::nullopt;
+                }
+            }
+        }
+
+
+
+        // Whether the input reached its end (EOF, hang-up), no key will come anymore
+        bool input_ended() const noexcept {
+            return input_ended_;
+        }
+
+
+
+        // Decode every key that is available right now, without blocking
+        // @param out Where events go
+        // @return How many were written
+        // @note A paste ends the batch (its texts live in the decoder), so there is at most one, valid until the next read
+        std::size_t read_available(std::span<key_event> out) {
+            std::size_t count = 0;
+
+            while (count < out.size()) {
+                if (decoder_.next(out[count])) {
+                    if (out[count++].key == key_paste) break;
+                    continue;
+                }
+                if (pump_input_(0)) continue;
+
+                // Nothing new: a partial sequence that waited long enough is complete
+                const bool waited = input_ended_ || std::chrono::steady_clock::now() - last_input_ >= escape_delay_;
+                if (decoder_.has_pending() && waited && decoder_.flush(out[count])) {
+                    ++count;
+                    continue;
+                }
+                break;
+            }
+            return count;
+        }
+
+
+
+        // Ask the terminal to wrap pasted texts, so they come as one `key_paste` event
+        terminal& bracketed_paste(const bool enable = true) {
+            terminal::write(enable ? "\x1b[?2004h" : "\x1b[?2004l").flush();
+            return *this;
+        }
+
+        // Ask the terminal to report mouse buttons, wheel and drags (SGR encoding)
+        terminal& mouse_reporting(const bool enable = true) {
+            terminal::write(enable ? "\x1b[?1002h\x1b[?1006h" : "\x1b[?1002l\x1b[?1006l").flush();
+            return *this;
+        }
             
         #pragma endregion
 
@@ -243,14 +472,14 @@ namespace asl::io {
         // Move cursor up
         // @param rep Repetition (default: 1)
         terminal& cursor_up(const uint16_t rep = 1) noexcept {
-            terminal::write("\x1b[" + std::to_string(rep) + 'A').flush();
+            csi_(rep, 'A').flush();
             return *this;
         }
 
         // Move cursor down
         // @param rep Repetition (default: 1)
         terminal& cursor_down(const uint16_t rep = 1) noexcept {
-            terminal::write("\x1b[" + std::to_string(rep) + 'B').flush();
+            csi_(rep, 'B').flush();
             return *this;
         }
 
@@ -258,20 +487,20 @@ namespace asl::io {
         // Move cursor left
         // @param rep Repetition (default: 1)
         terminal& cursor_left(const uint16_t rep = 1) noexcept {
-            terminal::write("\x1b[" + std::to_string(rep) + 'D').flush();
+            csi_(rep, 'D').flush();
             return *this;
         }
 
         // Move cursor right
         // @param rep Repetition (default: 1)
         terminal& cursor_right(const uint16_t rep = 1) noexcept {
-            terminal::write("\x1b[" + std::to_string(rep) + 'C').flush();
+            csi_(rep, 'C').flush();
             return *this;
         }
 
         // Move cursor to a specific position
         terminal& cursor_pos(const uint16_t row, const uint16_t col) noexcept {
-            terminal::write("\x1b[" + std::to_string(row) + ";" + std::to_string(col) + "H").flush();
+            csi_(row, col, 'H').flush();
             return *this;
         }
 
@@ -300,14 +529,14 @@ namespace asl::io {
         // Set foreground color
         // @param known_color You knew this
         terminal& foreground_color(const colors_ color) noexcept {
-            terminal::write("\x1b[" + std::to_string(color) + "m").flush();
+            csi_(color, 'm').flush();
             return *this;
         }
 
         // Set background color
         // @param known_color You knew this
         terminal& background_color(const colors_ color) noexcept {
-            terminal::write("\x1b[" + std::to_string(color + 10) + "m").flush();
+            csi_(color + 10, 'm').flush();
             return *this;
         }
 
@@ -367,7 +596,7 @@ namespace asl::io {
         // Get the window size of a terminal
         // @note `.first`: no. of cols
         // @note `.second`: no. of rows
-        std::pair<uint8_t, uint8_t> get_winsize() const {
+        std::pair<uint16_t, uint16_t> get_winsize() const {
             #ifdef __unix__
             winsize w;
             if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w))
@@ -381,14 +610,14 @@ namespace asl::io {
 
             int cols = csbi.srWindow.Right - csbi.srWindow.Left + 1;
             int rows = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
-            return { cols, rows };
+            return { static_cast<uint16_t>(cols), static_cast<uint16_t>(rows) };
             #endif
         }
 
         // Set terminal buffer size
         // @param cols Number of columns
         // @param rows Number of rows
-        terminal& set_buffer_size(const uint8_t cols, const uint8_t rows) {
+        terminal& set_buffer_size(const uint16_t cols, const uint16_t rows) {
             #ifdef __unix__
             winsize w;
             w.ws_col = cols;
@@ -2,11 +2,719 @@
 #define MATH_ARITHMETIC_HPP
 
 #include "../types/object.hpp"
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ASL_MATH_HAS_X86 1
+#else
+#define ASL_MATH_HAS_X86 0
+#endif
 
 namespace asl::math::arithmetic {
-    // TODO: Arithmetic
-}
 
+    // Instruction sets the kernels are built for
+    // @note `isa_baseline` is 128-bit vectors: SSE2 on x86-64, NEON on ARM64
+    // @note `isa_avx2` needs FMA too, `isa_avx512` needs F + BW + DQ + VL (Skylake-X and later)
+    enum isa_ { isa_baseline, isa_avx2, isa_avx512 };
+
+    // How `sum()` adds floating-point numbers up (integers are exact anyway)
+    enum summation_ {
+        sum_lanes,    // Straight lane-wise accumulation: fastest, error grows with n
+        sum_pairwise, // Blocks added up as a tree: error grows with log(n), nearly as fast
+        sum_kahan     // Compensated in every lane: error does not grow with n, about 2x slower
+    };
+
+
+
+    // Element types the kernels work on (integers and float / double)
+    template<typename T>
+    concept a_lane = (std::integral<T> || std::floating_point<T>) && !std::same_as<T, bool> && sizeof(T) <= 8;
+
+    // Contiguous ranges of lanes: `containers::vector<T>`, `std::vector<T>`, `std::span<T>`, arrays...
+    template<typename R>
+    concept a_lane_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && a_lane<std::ranges::range_value_t<R>>;
+
+    // A lane range holding `T`
+    template<typename R, typename T>
+    concept a_range_of = a_lane_range<R> && std::same_as<std::ranges::range_value_t<R>, T>;
+
+    // A lane range holding `T` that can be written to
+    template<typename R, typename T>
+    concept an_output_of = a_range_of<R, T> && !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal {
+
+        // Integers are computed as unsigned, so they wrap instead of overflowing (UB)
+        template<typename T>
+        using arith = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::type_identity<T>>::type;
+
+        // `Bytes` worth of `T`, in one register of the chosen ISA
+        // @note Written with vector extensions once, then compiled for every ISA by `on_*()`
+        template<typename T, std::size_t Bytes>
+        struct lanes {
+            typedef T type __attribute__((vector_size(Bytes)));
+            static constexpr std::size_t count = Bytes / sizeof(T);
+        };
+
+        template<typename T, std::size_t Bytes>
+        using vec = typename lanes<T, Bytes>::type;
+
+        // Vectors go through references, never by value: their ABI depends on the ISA
+        template<typename V, typename T>
+        [[gnu::always_inline]] inline void load(V& v, const T* p) noexcept {
+            std::memcpy(&v, p, sizeof(V));
+        }
+
+        template<typename V, typename T>
+        [[gnu::always_inline]] inline void store(T* p, const V& v) noexcept {
+            std::memcpy(p, &v, sizeof(V));
+        }
+
+        // The first `count` lanes, the rest zeroed. Only for tails: it goes through the stack
+        template<typename V, typename T>
+        [[gnu::always_inline]] inline void load_partial(V& v, const T* p, const std::size_t count) noexcept {
+            v = V{};
+            std::memcpy(&v, p, count * sizeof(T));
+        }
+
+        template<typename V, typename T>
+        [[gnu::always_inline]] inline void store_partial(T* p, const V& v, const std::size_t count) noexcept {
+            std::memcpy(p, &v, count * sizeof(T));
+        }
+
+
+
+        #pragma region Operations
+        struct add_op {
+            template<typename V>
+            [[gnu::always_inline]] static void apply(V& r, const V& a, const V& b) noexcept { r = a + b; }
+        };
+
+        struct sub_op {
+            template<typename V>
+            [[gnu::always_inline]] static void apply(V& r, const V& a, const V& b) noexcept { r = a - b; }
+        };
+
+        struct mul_op {
+            template<typename V>
+            [[gnu::always_inline]] static void apply(V& r, const V& a, const V& b) noexcept { r = a * b; }
+        };
+
+        // Vectors are unsigned here, `T` tells whether to saturate as signed
+        template<typename T>
+        struct sat_add_op {
+            template<typename V>
+            [[gnu::always_inline]] static void apply(V& r, const V& a, const V& b) noexcept {
+                const V s = a + b;
+                if constexpr (std::is_unsigned_v<T>) {
+                    r = s | (V)(s < a); // Carried: all ones
+                } else {
+                    constexpr int sign = sizeof(T) * 8 - 1;
+                    const V limit = (a >> sign) + static_cast<arith<T>>(std::numeric_limits<T>::max()); // MAX, or MIN when a < 0
+                    const V overflow = V{} - (((a ^ s) & (b ^ s)) >> sign); // Same signs in, other sign out
+                    r = (limit & overflow) | (s & ~overflow);
+                }
+            }
+        };
+
+        template<typename T>
+        struct sat_sub_op {
+            template<typename V>
+            [[gnu::always_inline]] static void apply(V& r, const V& a, const V& b) noexcept {
+                const V s = a - b;
+                if constexpr (std::is_unsigned_v<T>) {
+                    r = s & (V)(s <= a); // Borrowed: zero
+                } else {
+                    constexpr int sign = sizeof(T) * 8 - 1;
+                    const V limit = (a >> sign) + static_cast<arith<T>>(std::numeric_limits<T>::max());
+                    const V overflow = V{} - (((a ^ b) & (a ^ s)) >> sign); // Other signs in, sign of b out
+                    r = (limit & overflow) | (s & ~overflow);
+                }
+            }
+        };
+
+        [[gnu::always_inline]] inline float fused(const float a, const float b, const float c) noexcept { return __builtin_fmaf(a, b, c); }
+        [[gnu::always_inline]] inline double fused(const double a, const double b, const double c) noexcept { return __builtin_fma(a, b, c); }
+        #pragma endregion
+
+
+
+        #pragma region Kernels
+        // out = a op b
+        template<typename Op, typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void binary(const T* a, const T* b, T* out, const std::size_t n) noexcept {
+            using V = vec<arith<T>, Bytes>;
+            constexpr std::size_t N = lanes<arith<T>, Bytes>::count;
+
+            std::size_t i = 0;
+            V x, y, r;
+            for (; i + 2 * N <= n; i += 2 * N) {
+                load(x, a + i); load(y, b + i);
+                Op::apply(r, x, y);
+                store(out + i, r);
+                load(x, a + i + N); load(y, b + i + N);
+                Op::apply(r, x, y);
+                store(out + i + N, r);
+            }
+            for (; i + N <= n; i += N) {
+                load(x, a + i); load(y, b + i);
+                Op::apply(r, x, y);
+                store(out + i, r);
+            }
+            if (i < n) {
+                load_partial(x, a + i, n - i); load_partial(y, b + i, n - i);
+                Op::apply(r, x, y);
+                store_partial(out + i, r, n - i);
+            }
+        }
+
+        // out = a * b + c, rounded once
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void fma(const T* a, const T* b, const T* c, T* out, const std::size_t n) noexcept {
+            using V = vec<arith<T>, Bytes>;
+            constexpr std::size_t N = lanes<arith<T>, Bytes>::count;
+
+            const auto apply = [](V& r, const V& x, const V& y, const V& z) __attribute__((always_inline)) {
+                if constexpr (std::is_integral_v<T>) {
+                    r = x * y + z;
+                } else {
+                    for (std::size_t k = 0; k < N; ++k) r[k] = fused(x[k], y[k], z[k]); // One vfmadd with FMA, libm without
+                }
+            };
+
+            std::size_t i = 0;
+            V x, y, z, r{};
+            for (; i + N <= n; i += N) {
+                load(x, a + i); load(y, b + i); load(z, c + i);
+                apply(r, x, y, z);
+                store(out + i, r);
+            }
+            if (i < n) {
+                load_partial(x, a + i, n - i); load_partial(y, b + i, n - i); load_partial(z, c + i, n - i);
+                apply(r, x, y, z);
+                store_partial(out + i, r, n - i);
+            }
+        }
+
+        // Sum of all lanes of `v`
+        template<typename V>
+        [[gnu::always_inline]] inline auto horizontal_sum(const V& v) noexcept {
+            auto s = v[0];
+            for (std::size_t k = 1; k < sizeof(V) / sizeof(s); ++k) s += v[k];
+            return s;
+        }
+
+        // Four accumulators, so the adds' latency is hidden
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline arith<T> sum_lanes(const T* p, const std::size_t n) noexcept {
+            using V = vec<arith<T>, Bytes>;
+            constexpr std::size_t N = lanes<arith<T>, Bytes>::count;
+
+            V s0{}, s1{}, s2{}, s3{}, x;
+            std::size_t i = 0;
+            for (; i + 4 * N <= n; i += 4 * N) {
+                load(x, p + i);         s0 += x;
+                load(x, p + i + N);     s1 += x;
+                load(x, p + i + 2 * N); s2 += x;
+                load(x, p + i + 3 * N); s3 += x;
+            }
+            for (; i + N <= n; i += N) {
+                load(x, p + i);
+                s0 += x;
+            }
+            if (i < n) {
+                load_partial(x, p + i, n - i);
+                s1 += x;
+            }
+            s0 += s1;
+            s2 += s3;
+            s0 += s2;
+            return horizontal_sum(s0);
+        }
+
+        // Blocks summed with `sum_lanes()`, then merged as a binary counter would carry: a pairwise tree without recursion
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline arith<T> sum_pairwise(const T* p, const std::size_t n) noexcept {
+            constexpr std::size_t block = 256;
+            if (n <= block) return sum_lanes<T, Bytes>(p, n);
+
+            arith<T> stack[64];
+            std::size_t depth = 0;
+            std::size_t blocks = 0;
+            for (std::size_t i = 0; i < n; i += block) {
+                stack[depth++] = sum_lanes<T, Bytes>(p + i, n - i < block ? n - i : block);
+                for (std::size_t carry = ++blocks; (carry & 1) == 0; carry >>= 1) {
+                    --depth;
+                    stack[depth - 1] += stack[depth];
+                }
+            }
+            arith<T> s = stack[--depth];
+            while (depth) s += stack[--depth];
+            return s;
+        }
+
+        // One Kahan step in every lane
+        template<typename V>
+        [[gnu::always_inline]] inline void kahan_add(V& s, V& c, const V& x) noexcept {
+            const V y = x - c;
+            const V t = s + y;
+            c = (t - s) - y;
+            s = t;
+        }
+
+        // Kahan in every lane (two sets, for latency), then Neumaier across lanes
+        // @note Breaks with -ffast-math, which is free to drop the compensation
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline T sum_kahan(const T* p, const std::size_t n) noexcept {
+            using V = vec<T, Bytes>;
+            constexpr std::size_t N = lanes<T, Bytes>::count;
+
+            V s0{}, c0{}, s1{}, c1{}, x;
+            std::size_t i = 0;
+            for (; i + 2 * N <= n; i += 2 * N) {
+                load(x, p + i);     kahan_add(s0, c0, x);
+                load(x, p + i + N); kahan_add(s1, c1, x);
+            }
+            for (; i + N <= n; i += N) {
+                load(x, p + i);
+                kahan_add(s0, c0, x);
+            }
+            if (i < n) {
+                load_partial(x, p + i, n - i);
+                kahan_add(s1, c1, x);
+            }
+
+            T total = 0, compensation = 0;
+            const auto add = [&](const T v) {
+                const T next = total + v;
+                compensation += (total >= 0 ? total : -total) >= (v >= 0 ? v : -v) ? (total - next) + v : (v - next) + total;
+                total = next;
+            };
+            for (std::size_t k = 0; k < N; ++k) {
+                add(s0[k]); add(-c0[k]);
+                add(s1[k]); add(-c1[k]);
+            }
+            return total + compensation;
+        }
+
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline arith<T> dot(const T* a, const T* b, const std::size_t n) noexcept {
+            using V = vec<arith<T>, Bytes>;
+            constexpr std::size_t N = lanes<arith<T>, Bytes>::count;
+
+            V s0{}, s1{}, s2{}, s3{}, x, y;
+            std::size_t i = 0;
+            for (; i + 4 * N <= n; i += 4 * N) {
+                load(x, a + i);         load(y, b + i);         s0 += x * y;
+                load(x, a + i + N);     load(y, b + i + N);     s1 += x * y;
+                load(x, a + i + 2 * N); load(y, b + i + 2 * N); s2 += x * y;
+                load(x, a + i + 3 * N); load(y, b + i + 3 * N); s3 += x * y;
+            }
+            for (; i + N <= n; i += N) {
+                load(x, a + i); load(y, b + i);
+                s0 += x * y;
+            }
+            if (i < n) {
+                load_partial(x, a + i, n - i); load_partial(y, b + i, n - i);
+                s1 += x * y;
+            }
+            s0 += s1;
+            s2 += s3;
+            s0 += s2;
+            return horizontal_sum(s0);
+        }
+
+        // Smallest (`Max == false`) or largest element, `n > 0`
+        template<bool Max, typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline T extremum(const T* p, const std::size_t n) noexcept {
+            using V = vec<T, Bytes>;
+            constexpr std::size_t N = lanes<T, Bytes>::count;
+
+            std::size_t i = 0;
+            T best = p[0];
+            if (n >= N) {
+                V m0, m1, x;
+                load(m0, p);
+                m1 = m0;
+                for (i = N; i + 2 * N <= n; i += 2 * N) {
+                    load(x, p + i);
+                    m0 = (Max ? x > m0 : x < m0) ? x : m0;
+                    load(x, p + i + N);
+                    m1 = (Max ? x > m1 : x < m1) ? x : m1;
+                }
+                m0 = (Max ? m1 > m0 : m1 < m0) ? m1 : m0;
+                best = m0[0];
+                for (std::size_t k = 1; k < N; ++k) best = (Max ? m0[k] > best : m0[k] < best) ? m0[k] : best;
+            }
+            for (; i < n; ++i) best = (Max ? p[i] > best : p[i] < best) ? p[i] : best;
+            return best;
+        }
+
+        // v += v shifted up by `K` lanes (zeros shifted in)
+        template<std::size_t K, typename V, std::size_t... I>
+        [[gnu::always_inline]] inline void shift_add(V& v, std::index_sequence<I...>) noexcept {
+            const V zero{};
+            v += __builtin_shufflevector(zero, v, (I < K ? 0 : sizeof...(I) + I - K)...);
+        }
+
+        // In-register inclusive scan, log2(N) shift-and-add steps
+        template<std::size_t K, std::size_t N, typename V>
+        [[gnu::always_inline]] inline void scan(V& v) noexcept {
+            if constexpr (K < N) {
+                shift_add<K>(v, std::make_index_sequence<N>{});
+                scan<K * 2, N>(v);
+            }
+        }
+
+        // Every lane set to the last one of `v`
+        template<std::size_t N, typename V, std::size_t... I>
+        [[gnu::always_inline]] inline void broadcast_last(V& out, const V& v, std::index_sequence<I...>) noexcept {
+            out = __builtin_shufflevector(v, v, (I * 0 + N - 1)...);
+        }
+
+        // Inclusive prefix sum, `out` may be `a`
+        // @note Only the carry is serial, so it runs at one vector per add latency instead of one element
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void prefix_sum(const T* a, T* out, const std::size_t n) noexcept {
+            using V = vec<arith<T>, Bytes>;
+            constexpr std::size_t N = lanes<arith<T>, Bytes>::count;
 
+            V x, carry{};
+            std::size_t i = 0;
+            for (; i + N <= n; i += N) {
+                load(x, a + i);
+                scan<1, N>(x);
+                x += carry;
+                store(out + i, x);
+                broadcast_last<N>(carry, x, std::make_index_sequence<N>{});
+            }
+            if (i < n) {
+                load_partial(x, a + i, n - i);
+                scan<1, N>(x);
+                x += carry;
+                store_partial(out + i, x, n - i);
+            }
+        }
+        #pragma endregion
+
+
+
+        #pragma region Dispatch
+        inline isa_ supported_isa() noexcept {
+            #if ASL_MATH_HAS_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+                return isa_avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return isa_avx2;
+            #endif
+            return isa_baseline;
+        }
+
+        // Chosen once, on first use
+        inline std::atomic<isa_>& chosen_isa() noexcept {
+            static std::atomic<isa_> chosen{ supported_isa() };
+            return chosen;
+        }
+
+        // The kernel, built for one ISA. `f` is a lambda templated on the vector size in bytes
+        #if ASL_MATH_HAS_X86
+        template<typename F>
+        [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")]] inline decltype(auto) on_avx512(F& f) {
+            return f.template operator()<64>();
+        }
+
+        template<typename F>
+        [[gnu::target("avx2,fma")]] inline decltype(auto) on_avx2(F& f) {
+            return f.template operator()<32>();
+        }
+        #endif
+
+        template<typename F>
+        inline decltype(auto) on_baseline(F& f) {
+            return f.template operator()<16>();
+        }
+
+        template<typename F>
+        [[gnu::always_inline]] inline decltype(auto) dispatch(F&& f) {
+            #if ASL_MATH_HAS_X86
+            switch (chosen_isa().load(std::memory_order_relaxed)) {
+            case isa_avx512: return on_avx512(f);
+            case isa_avx2: return on_avx2(f);
+            default: break;
+            }
+            #endif
+            return on_baseline(f);
+        }
+
+        template<typename R>
+        [[gnu::always_inline]] inline void same_size(const char* where, const std::size_t n, const R& r) {
+            if (std::ranges::size(r) != n)
+                throw std::runtime_error(std::string("asl::math::arithmetic::") + where + "(): Sizes differ.");
+        }
+        #pragma endregion
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region ISA
+
+    // The ISA the kernels run with (the best one the CPU has, unless changed by `use_isa()`)
+    inline isa_ isa() noexcept {
+        return _internal::chosen_isa().load(std::memory_order_relaxed);
+    }
+
+    // Run the kernels with `wanted` (or the best one the CPU has below it)
+    // @return The ISA actually used
+    // @note Meant for benchmarks and comparisons, not to be raced with running kernels
+    inline isa_ use_isa(const isa_ wanted) noexcept {
+        const isa_ best = _internal::supported_isa();
+        const isa_ chosen = wanted < best ? wanted : best;
+        _internal::chosen_isa().store(chosen, std::memory_order_relaxed);
+        return chosen;
+    }
+
+    inline const char* isa_name(const isa_ which) noexcept {
+        switch (which) {
+        case isa_avx512: return "avx512";
+        case isa_avx2: return "avx2";
+        default:
+            #if ASL_MATH_HAS_X86
+            return "sse2";
+            #else
+            return "baseline";
+            #endif
+        }
+    }
+
+    #pragma endregion
+
+
+
+
+
+    #pragma region Elementwise
+    // @note `out` must have the same size as the inputs. It may be one of them (in place), but not overlap them otherwise
+    // @note Integers wrap around, like unsigned arithmetic
+
+    // out = a + b
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, an_output_of<std::ranges::range_value_t<A>> Out>
+    inline void add(const A& a, const B& b, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("add", n, b);
+        _internal::same_size("add", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::binary<_internal::add_op, T, Bytes>(pa, pb, po, n);
+        });
+    }
+
+    // out = a - b
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, an_output_of<std::ranges::range_value_t<A>> Out>
+    inline void sub(const A& a, const B& b, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("sub", n, b);
+        _internal::same_size("sub", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::binary<_internal::sub_op, T, Bytes>(pa, pb, po, n);
+        });
+    }
+
+    // out = a * b
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, an_output_of<std::ranges::range_value_t<A>> Out>
+    inline void mul(const A& a, const B& b, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("mul", n, b);
+        _internal::same_size("mul", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::binary<_internal::mul_op, T, Bytes>(pa, pb, po, n);
+        });
+    }
+
+    // out = a * b + c
+    // @note Floats are rounded once, as `std::fma` does (slow without FMA hardware, like `std::fma`)
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, a_range_of<std::ranges::range_value_t<A>> C,
+             an_output_of<std::ranges::range_value_t<A>> Out>
+    inline void fma(const A& a, const B& b, const C& c, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("fma", n, b);
+        _internal::same_size("fma", n, c);
+        _internal::same_size("fma", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        const T* pc = std::ranges::data(c);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::fma<T, Bytes>(pa, pb, pc, po, n);
+        });
+    }
+
+    // out = a + b, clamped to the type's range instead of wrapping around
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, an_output_of<std::ranges::range_value_t<A>> Out>
+    requires std::integral<std::ranges::range_value_t<A>>
+    inline void saturating_add(const A& a, const B& b, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("saturating_add", n, b);
+        _internal::same_size("saturating_add", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::binary<_internal::sat_add_op<T>, T, Bytes>(pa, pb, po, n);
+        });
+    }
+
+    // out = a - b, clamped to the type's range instead of wrapping around
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B, an_output_of<std::ranges::range_value_t<A>> Out>
+    requires std::integral<std::ranges::range_value_t<A>>
+    inline void saturating_sub(const A& a, const B& b, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("saturating_sub", n, b);
+        _internal::same_size("saturating_sub", n, out);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::binary<_internal::sat_sub_op<T>, T, Bytes>(pa, pb, po, n);
+        });
+    }
+
+    #pragma endregion
+
+
+
+
+
+    #pragma region Reductions
+
+    // Sum of all elements (0 if empty)
+    // @param how How floats are added up (default: pairwise)
+    // @note Floats are added in another order than a plain loop would, so the last bits may differ from it
+    template<a_lane_range R>
+    inline std::ranges::range_value_t<R> sum(const R& a, const summation_ how = sum_pairwise) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(a);
+        const T* p = std::ranges::data(a);
+
+        if constexpr (std::is_integral_v<T>) {
+            return static_cast<T>(_internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                return _internal::sum_lanes<T, Bytes>(p, n);
+            }));
+        } else {
+            switch (how) {
+            case sum_lanes:
+                return _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                    return _internal::sum_lanes<T, Bytes>(p, n);
+                });
+            case sum_kahan:
+                return _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                    return _internal::sum_kahan<T, Bytes>(p, n);
+                });
+            default:
+                return _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                    return _internal::sum_pairwise<T, Bytes>(p, n);
+                });
+            }
+        }
+    }
+
+    // Sum of a[i] * b[i] (0 if empty)
+    template<a_lane_range A, a_range_of<std::ranges::range_value_t<A>> B>
+    inline std::ranges::range_value_t<A> dot(const A& a, const B& b) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("dot", n, b);
+
+        const T* pa = std::ranges::data(a);
+        const T* pb = std::ranges::data(b);
+        return static_cast<T>(_internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            return _internal::dot<T, Bytes>(pa, pb, n);
+        }));
+    }
+
+    // Smallest element
+    // @note Throws if `a` is empty. Unspecified with NaNs in it
+    template<a_lane_range R>
+    inline std::ranges::range_value_t<R> min(const R& a) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(a);
+        if (n == 0) throw std::runtime_error("asl::math::arithmetic::min(): Empty range.");
+
+        const T* p = std::ranges::data(a);
+        return _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            return _internal::extremum<false, T, Bytes>(p, n);
+        });
+    }
+
+    // Largest element
+    // @note Throws if `a` is empty. Unspecified with NaNs in it
+    template<a_lane_range R>
+    inline std::ranges::range_value_t<R> max(const R& a) {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(a);
+        if (n == 0) throw std::runtime_error("asl::math::arithmetic::max(): Empty range.");
+
+        const T* p = std::ranges::data(a);
+        return _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            return _internal::extremum<true, T, Bytes>(p, n);
+        });
+    }
+
+    // Inclusive prefix sum: out[i] = a[0] + ... + a[i]
+    // @note `out` may be `a` (in place)
+    // @note Floats are added in another order than a plain loop would, so the last bits may differ from it
+    template<a_lane_range A, an_output_of<std::ranges::range_value_t<A>> Out>
+    inline void prefix_sum(const A& a, Out&& out) {
+        using T = std::ranges::range_value_t<A>;
+        const std::size_t n = std::ranges::size(a);
+        _internal::same_size("prefix_sum", n, out);
+
+        const T* pa = std::ranges::data(a);
+        T* po = std::ranges::data(out);
+        _internal::dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+            _internal::prefix_sum<T, Bytes>(pa, po, n);
+        });
+    }
+
+    #pragma endregion
+}
 
-#endif
\ No newline at end of file
+#endif
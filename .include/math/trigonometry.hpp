@@ -2,9 +2,772 @@
 #define MATH_TRIGONOMETRY_HPP
 
 #include "../types/object.hpp"
+#include "./arithmetic.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 namespace asl::math::trig {
-    // TODO: Trigonometry
+
+    // How close to the exact result the batch functions get (1 ULP: one step between neighbouring floats)
+    // @note All tiers give NaN / inf / zeros like libm does, only the error on ordinary values differs
+    enum accuracy_ {
+        accuracy_fast, // About 2^-17 relative error: short polynomials, sin / cos reduced without widening (fine up to |x| ~ 1e5)
+        accuracy_4ulp, // At most 4 ULP: full polynomials, sin / cos reduced exactly up to |x| = 2^20 (libm beyond)
+        accuracy_1ulp  // At most 1 ULP: float is computed in double then rounded, double goes to libm
+    };
+
+
+
+    // Contiguous ranges of float or double
+    template<typename R>
+    concept a_real_range = arithmetic::a_lane_range<R> && std::floating_point<std::ranges::range_value_t<R>>;
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal {
+
+        using arithmetic::_internal::vec;
+        using arithmetic::_internal::lanes;
+        using arithmetic::_internal::load;
+        using arithmetic::_internal::store;
+        using arithmetic::_internal::load_partial;
+        using arithmetic::_internal::store_partial;
+        using arithmetic::_internal::dispatch;
+
+
+
+        #pragma region Constants
+        // Polynomial coefficients are in increasing powers, for Horner
+        // @note fdlibm's for double (sin / cos / log / atan), Taylor for double exp. The others are fitted near-minimax
+        template<typename T>
+        struct constants;
+
+        template<>
+        struct constants<double> {
+            using bits = uint64_t;
+            using sbits = int64_t;
+            static constexpr int mantissa = 52;
+            static constexpr int bias = 1023;
+            static constexpr double magic = 0x1.8p52; // x + magic - magic rounds to an integer, which lands in the low bits
+
+            // sin / cos / tan
+            static constexpr double two_over_pi = 6.36619772367581382433e-01;
+            static constexpr double pio2_1 = 1.57079632673412561417e+00;  // 33 bits, n * pio2_1 is exact for n < 2^20
+            static constexpr double pio2_2 = 6.07710050630396597660e-11;  // 33 bits too
+            static constexpr double pio2_3 = 2.02226624879595063154e-21;
+            static constexpr double reduce_limit = 0x1p20;
+            static constexpr double sin_poly[] = { -1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04,
+                                                   2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10 };
+            static constexpr double cos_poly[] = { 4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+                                                   -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11 };
+
+            // exp
+            static constexpr double log2e = 1.44269504088896338700e+00;
+            static constexpr double ln2_hi = 6.93147180369123816490e-01; // 32 bits
+            static constexpr double ln2_lo = 1.90821492927058770002e-10;
+            static constexpr double exp_max = 7.09782712893383973096e+02; // Above: inf
+            static constexpr double exp_min = -7.45133219101941108420e+02; // Below: 0
+            static constexpr double exp_poly[] = { 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320, 1.0 / 362880,
+                                                   1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800 };
+
+            // log
+            static constexpr double sqrt2 = 1.41421356237309514547e+00;
+            static constexpr double log_poly[] = { 6.666666666666735130e-01, 3.999999999940941908e-01, 2.857142874366239149e-01, 2.222219843214978396e-01,
+                                                   1.818357216161805012e-01, 1.531383769920937332e-01, 1.479819860511658591e-01 };
+
+            // atan2
+            static constexpr double atan_poly[] = { -3.33333333333329318027e-01, 1.99999999998764832476e-01, -1.42857142725034663711e-01,
+                                                    1.11111104054623557880e-01, -9.09088713343650656196e-02, 7.69187620504482999495e-02,
+                                                    -6.66107313738753120669e-02, 5.83357013379057348645e-02, -4.97687799461593236017e-02,
+                                                    3.65315727442169155270e-02, -1.62858201153657823623e-02 };
+            static constexpr double atan_half_hi = 4.63647609000806093515e-01, atan_half_lo = 2.26987774529616870924e-17; // atan(1/2)
+            static constexpr double pio4_hi = 7.85398163397448278999e-01, pio4_lo = 3.06161699786838301793e-17;
+            static constexpr double pio2_hi = 1.57079632679489655800e+00, pio2_lo = 6.12323399573676603587e-17;
+            static constexpr double pi_hi = 3.14159265358979311600e+00, pi_lo = 1.22464679914735317720e-16;
+        };
+
+        template<>
+        struct constants<float> {
+            using bits = uint32_t;
+            using sbits = int32_t;
+            static constexpr int mantissa = 23;
+            static constexpr int bias = 127;
+            static constexpr float magic = 0x1.8p23f;
+
+            // sin / cos / tan (reduced in double, with the constants above, except in the fast tier)
+            static constexpr float two_over_pi = 6.36619746685e-01f;
+            static constexpr float pio2_1 = 1.5703125f;         // 8 bits each, so n * pio2_k is exact for n < 2^16
+            static constexpr float pio2_2 = 4.825592041015625e-04f;
+            static constexpr float pio2_3 = 1.26659870147705078125e-06f;
+            static constexpr float pio2_4 = 9.92093629e-10f;
+            static constexpr float reduce_limit = 0x1p20f;
+            static constexpr float sin_poly[] = { -1.66666545e-01f, 8.33215605e-03f, -1.95146319e-04f };
+            static constexpr float cos_poly[] = { 4.16666456e-02f, -1.38873099e-03f, 2.44324130e-05f };
+
+            // exp
+            static constexpr float log2e = 1.44269502163e+00f;
+            static constexpr float ln2_hi = 6.93359375e-01f; // 9 bits
+            static constexpr float ln2_lo = -2.12194440e-04f;
+            static constexpr float exp_max = 8.872283935546875e+01f;
+            static constexpr float exp_min = -1.0397208404541015625e+02f;
+            static constexpr float exp_poly[] = { 4.99999934e-01f, 1.66665201e-01f, 4.16683947e-02f, 8.36878580e-03f, 1.38144557e-03f };
+
+            // log
+            static constexpr float sqrt2 = 1.41421353816986083984e+00f;
+            static constexpr float log_poly[] = { 6.66667769e-01f, 3.99774676e-01f, 2.98740521e-01f };
+
+            // atan2
+            static constexpr float atan_poly[] = { -3.33333034e-01f, 1.99977380e-01f, -1.42295819e-01f, 1.04908078e-01f, -5.81910318e-02f };
+            static constexpr float atan_half_hi = 4.63647604e-01f, atan_half_lo = 5.01215869e-09f;
+            static constexpr float pio4_hi = 7.85398185e-01f, pio4_lo = -2.18556941e-08f;
+            static constexpr float pio2_hi = 1.57079637e+00f, pio2_lo = -4.37113883e-08f;
+            static constexpr float pi_hi = 3.14159274e+00f, pi_lo = -8.74227766e-08f;
+        };
+
+        // The fast tier, the same for both types: about 2^-17 relative at worst
+        struct fast {
+            static constexpr double sin_poly[] = { -1.66633772027625291e-01, 8.16294233039686281e-03 };
+            static constexpr double cos_poly[] = { 4.16610485451497124e-02, -1.36482293475869138e-03 };
+            static constexpr double exp_poly[] = { 5.00051378561954492e-01, 1.67537006654393935e-01, 4.12769312463671912e-02 };
+            static constexpr double log_poly[] = { 6.66555698471134552e-01, 4.12048544215137073e-01 };
+            static constexpr double atan_poly[] = { -3.33255071183777422e-01, 1.97141279915576836e-01, -1.12250836830470456e-01 };
+            static constexpr double tan_pio8 = 4.14213562373095034e-01;
+        };
+        #pragma endregion
+
+
+
+        #pragma region Helpers
+        template<typename T, std::size_t Bytes>
+        using bits_vec = vec<typename constants<T>::bits, Bytes>;
+
+        template<typename T, std::size_t Bytes>
+        using sbits_vec = vec<typename constants<T>::sbits, Bytes>;
+
+        // r = c[0] + x * (c[1] + x * (...)), coefficients rounded to `T`
+        template<typename T, typename V, typename C, std::size_t K>
+        [[gnu::always_inline]] inline void horner(V& r, const V& x, const C (&c)[K]) noexcept {
+            r = V{} + static_cast<T>(c[K - 1]);
+            for (std::size_t k = K - 1; k-- > 0;) r = r * x + static_cast<T>(c[k]);
+        }
+
+        // Whether any lane of a mask is set
+        template<typename M>
+        [[gnu::always_inline]] inline bool any(const M& m) noexcept {
+            uint64_t words[sizeof(M) / 8];
+            std::memcpy(words, &m, sizeof(M));
+            uint64_t acc = 0;
+            for (const uint64_t w : words) acc |= w;
+            return acc != 0;
+        }
+
+        // Lanes whose bits fall outside [lo, hi): negative and NaN lanes do too, it is all one unsigned compare
+        // @note Two float compares and'ed together get split into scalar ones by GCC on AVX-512, this does not
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void outside(sbits_vec<T, Bytes>& m, const vec<T, Bytes>& x, const typename constants<T>::bits lo, const typename constants<T>::bits hi) noexcept {
+            m = ((bits_vec<T, Bytes>)x - lo) >= hi - lo;
+        }
+
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void abs(vec<T, Bytes>& r, const vec<T, Bytes>& x) noexcept {
+            using UV = bits_vec<T, Bytes>;
+            constexpr auto sign = typename constants<T>::bits(1) << (sizeof(T) * 8 - 1);
+            r = (vec<T, Bytes>)((UV)x & ~sign);
+        }
+
+        // Lanes [Offset, Offset + half) of `v`
+        template<std::size_t Offset, typename H, typename V, std::size_t... I>
+        [[gnu::always_inline]] inline void half(H& h, const V& v, std::index_sequence<I...>) noexcept {
+            h = __builtin_shufflevector(v, v, (I + Offset)...);
+        }
+
+        template<typename V, typename H, std::size_t... I>
+        [[gnu::always_inline]] inline void concat(V& v, const H& lo, const H& hi, std::index_sequence<I...>) noexcept {
+            v = __builtin_shufflevector(lo, hi, I...);
+        }
+
+        // float lanes as two double vectors of the same width, and back
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void widen(vec<double, Bytes>& lo, vec<double, Bytes>& hi, const vec<float, Bytes>& x) noexcept {
+            constexpr std::size_t H = Bytes / 8;
+            vec<float, Bytes / 2> l, h;
+            half<0>(l, x, std::make_index_sequence<H>{});
+            half<H>(h, x, std::make_index_sequence<H>{});
+            lo = __builtin_convertvector(l, vec<double, Bytes>);
+            hi = __builtin_convertvector(h, vec<double, Bytes>);
+        }
+
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void narrow(vec<float, Bytes>& x, const vec<double, Bytes>& lo, const vec<double, Bytes>& hi) noexcept {
+            const auto l = __builtin_convertvector(lo, vec<float, Bytes / 2>);
+            const auto h = __builtin_convertvector(hi, vec<float, Bytes / 2>);
+            concat(x, l, h, std::make_index_sequence<Bytes / 4>{});
+        }
+        #pragma endregion
+
+
+
+        #pragma region Reduction
+        // x = n * pi/2 + r, |r| <= pi/4 (about), `q` holds n in its low bits
+        // @note Cody-Waite in three parts, so `r` is exact for |x| < 2^20
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void reduce_exact(vec<double, Bytes>& r, vec<int64_t, Bytes>& q, const vec<double, Bytes>& x) noexcept {
+            using C = constants<double>;
+            const vec<double, Bytes> t = x * C::two_over_pi + C::magic;
+            const vec<double, Bytes> n = t - C::magic;
+            q = (vec<int64_t, Bytes>)t;
+            r = ((x - n * C::pio2_1) - n * C::pio2_2) - n * C::pio2_3;
+        }
+
+        // Same, float lanes reduced in double
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void reduce_exact(vec<float, Bytes>& r, vec<int32_t, Bytes>& q, const vec<float, Bytes>& x) noexcept {
+            constexpr std::size_t H = Bytes / 8;
+            vec<double, Bytes> lo, hi;
+            vec<int64_t, Bytes> qlo, qhi;
+            widen<Bytes>(lo, hi, x);
+            reduce_exact<Bytes>(lo, qlo, lo);
+            reduce_exact<Bytes>(hi, qhi, hi);
+            narrow<Bytes>(r, lo, hi);
+            concat(q, __builtin_convertvector(qlo, vec<int32_t, Bytes / 2>), __builtin_convertvector(qhi, vec<int32_t, Bytes / 2>),
+                   std::make_index_sequence<2 * H>{});
+        }
+
+        // Four parts in float, no widening: near exact up to |x| ~ 1e5, then the error grows with |x|
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void reduce_fast(vec<float, Bytes>& r, vec<int32_t, Bytes>& q, const vec<float, Bytes>& x) noexcept {
+            using C = constants<float>;
+            const vec<float, Bytes> t = x * C::two_over_pi + C::magic;
+            const vec<float, Bytes> n = t - C::magic;
+            q = (vec<int32_t, Bytes>)t;
+            r = (((x - n * C::pio2_1) - n * C::pio2_2) - n * C::pio2_3) - n * C::pio2_4;
+        }
+
+        // double is already cheap enough in three parts
+        template<std::size_t Bytes>
+        [[gnu::always_inline]] inline void reduce_fast(vec<double, Bytes>& r, vec<int64_t, Bytes>& q, const vec<double, Bytes>& x) noexcept {
+            reduce_exact<Bytes>(r, q, x);
+        }
+
+        // sin(r) and cos(r) for |r| <= pi/4
+        template<typename T, accuracy_ Tier, std::size_t Bytes>
+        [[gnu::always_inline]] inline void sin_cos_poly(vec<T, Bytes>& s, vec<T, Bytes>& c, const vec<T, Bytes>& r) noexcept {
+            using V = vec<T, Bytes>;
+            using K = std::conditional_t<Tier == accuracy_fast, fast, constants<T>>;
+
+            const V z = r * r;
+            V ps, pc;
+            horner<T>(ps, z, K::sin_poly);
+            horner<T>(pc, z, K::cos_poly);
+
+            s = r + (z * r) * ps;
+
+            const V hz = z * static_cast<T>(0.5);
+            const V w = static_cast<T>(1) - hz;
+            c = w + (((static_cast<T>(1) - w) - hz) + (z * z) * pc); // 1 - z/2 without losing what the rounding of w dropped
+        }
+
+        // Reduce, evaluate both polynomials, and fall back to libm for lanes too large to reduce
+        template<typename T, accuracy_ Tier, std::size_t Bytes>
+        [[gnu::always_inline]] inline void sin_cos(vec<T, Bytes>& s, vec<T, Bytes>& c, sbits_vec<T, Bytes>& q, const vec<T, Bytes>& x) noexcept {
+            vec<T, Bytes> r;
+            if constexpr (Tier == accuracy_fast) reduce_fast<Bytes>(r, q, x);
+            else reduce_exact<Bytes>(r, q, x);
+            sin_cos_poly<T, Tier, Bytes>(s, c, r);
+        }
+
+        // Lanes that `reduce_exact()` cannot handle (and NaN / inf)
+        template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void too_large(sbits_vec<T, Bytes>& large, const vec<T, Bytes>& x) noexcept {
+            vec<T, Bytes> ax;
+            abs<T, Bytes>(ax, x);
+            large = ~(ax <= constants<T>::reduce_limit);
+        }
+        #pragma endregion
+
+
+
+        #pragma region Kernels
+        // Each kernel maps `inputs` vectors to `outputs` vectors, and has a scalar libm version for the 1-ULP double tier
+
+        template<typename T, accuracy_ Tier>
+        struct sin_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::sin(in[0]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                const V& x = in[0];
+
+                V s, c;
+                sbits_vec<T, Bytes> q;
+                sin_cos<T, Tier, Bytes>(s, c, q, x);
+
+                // Quadrants: sin, cos, -sin, -cos
+                V r = (q & 1) ? c : s;
+                r = (V)((UV)r ^ ((UV)(q & 2) << (sizeof(T) * 8 - 2)));
+
+                if constexpr (Tier != accuracy_fast) {
+                    sbits_vec<T, Bytes> large;
+                    too_large<T, Bytes>(large, x);
+                    if (any(large))
+                        for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k)
+                            if (large[k]) r[k] = std::sin(x[k]);
+                }
+                out[0] = r;
+            }
+        };
+
+        template<typename T, accuracy_ Tier>
+        struct cos_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::cos(in[0]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                const V& x = in[0];
+
+                V s, c;
+                sbits_vec<T, Bytes> q;
+                sin_cos<T, Tier, Bytes>(s, c, q, x);
+
+                // Quadrants: cos, -sin, -cos, sin
+                V r = (q & 1) ? s : c;
+                r = (V)((UV)r ^ ((UV)((q + 1) & 2) << (sizeof(T) * 8 - 2)));
+
+                if constexpr (Tier != accuracy_fast) {
+                    sbits_vec<T, Bytes> large;
+                    too_large<T, Bytes>(large, x);
+                    if (any(large))
+                        for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k)
+                            if (large[k]) r[k] = std::cos(x[k]);
+                }
+                out[0] = r;
+            }
+        };
+
+        template<typename T, accuracy_ Tier>
+        struct sincos_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 2;
+
+            static void scalar(T* out, const T* in) noexcept {
+                out[0] = std::sin(in[0]);
+                out[1] = std::cos(in[0]);
+            }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                const V& x = in[0];
+
+                V s, c;
+                sbits_vec<T, Bytes> q;
+                sin_cos<T, Tier, Bytes>(s, c, q, x);
+
+                constexpr int shift = sizeof(T) * 8 - 2;
+                const auto odd = q & 1;
+                V rs = odd ? c : s;
+                V rc = odd ? s : c;
+                rs = (V)((UV)rs ^ ((UV)(q & 2) << shift));
+                rc = (V)((UV)rc ^ ((UV)((q + 1) & 2) << shift));
+
+                if constexpr (Tier != accuracy_fast) {
+                    sbits_vec<T, Bytes> large;
+                    too_large<T, Bytes>(large, x);
+                    if (any(large)) {
+                        for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k) {
+                            if (!large[k]) continue;
+                            rs[k] = std::sin(x[k]);
+                            rc[k] = std::cos(x[k]);
+                        }
+                    }
+                }
+                out[0] = rs;
+                out[1] = rc;
+            }
+        };
+
+        // sin / cos, or -cos / sin in odd quadrants
+        template<typename T, accuracy_ Tier>
+        struct tan_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::tan(in[0]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using V = vec<T, Bytes>;
+                const V& x = in[0];
+
+                V s, c;
+                sbits_vec<T, Bytes> q;
+                sin_cos<T, Tier, Bytes>(s, c, q, x);
+
+                const auto odd = q & 1;
+                V r = (odd ? -c : s) / (odd ? s : c);
+
+                if constexpr (Tier != accuracy_fast) {
+                    sbits_vec<T, Bytes> large;
+                    too_large<T, Bytes>(large, x);
+                    if (any(large))
+                        for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k)
+                            if (large[k]) r[k] = std::tan(x[k]);
+                }
+                out[0] = r;
+            }
+        };
+
+        // x = n * ln2 + r, exp(x) = 2^n * exp(r), with 2^n applied in two halves so subnormal results come out right
+        template<typename T, accuracy_ Tier>
+        struct exp_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::exp(in[0]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using C = constants<T>;
+                using K = std::conditional_t<Tier == accuracy_fast, fast, C>;
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                using SV = sbits_vec<T, Bytes>;
+                const V& x = in[0];
+
+                // Clamped (and NaN taken out) so n stays small, the ends are patched below
+                V xc = x > C::exp_max ? V{} + C::exp_max : x;
+                xc = xc < C::exp_min ? V{} + C::exp_min : xc;
+                xc = x != x ? V{} : xc;
+
+                const V t = xc * C::log2e + C::magic;
+                const V n = t - C::magic;
+                const SV ni = (SV)t - (SV)(V{} + C::magic);
+                const V r = (xc - n * C::ln2_hi) - n * C::ln2_lo;
+
+                V p;
+                horner<T>(p, r, K::exp_poly);
+                p = static_cast<T>(1) + (r + (r * r) * p);
+
+                const SV n1 = ni >> 1;
+                const SV n2 = ni - n1;
+                const V s1 = (V)((UV)(n1 + C::bias) << C::mantissa);
+                const V s2 = (V)((UV)(n2 + C::bias) << C::mantissa);
+                V y = (p * s1) * s2;
+
+                y = x > C::exp_max ? V{} + std::numeric_limits<T>::infinity() : y;
+                y = x < C::exp_min ? V{} : y;
+                out[0] = x != x ? x : y;
+            }
+        };
+
+        // x = 2^k * (1 + f), sqrt(1/2) <= 1 + f < sqrt(2), log(1 + f) = 2 atanh(s) with s = f / (2 + f)
+        // @note Zero, negative, subnormal, inf and NaN lanes go to libm
+        template<typename T, accuracy_ Tier>
+        struct log_kernel {
+            static constexpr std::size_t inputs = 1, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::log(in[0]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using C = constants<T>;
+                using K = std::conditional_t<Tier == accuracy_fast, fast, C>;
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                using SV = sbits_vec<T, Bytes>;
+                const V& x = in[0];
+
+                constexpr typename C::bits fraction = (typename C::bits(1) << C::mantissa) - 1;
+                constexpr typename C::bits one = typename C::bits(C::bias) << C::mantissa;
+
+                const UV bits = (UV)x;
+                SV k = (SV)(bits >> C::mantissa) - C::bias;
+                V m = (V)((bits & fraction) | one);
+                const SV high = m > C::sqrt2;
+                m = high ? m * static_cast<T>(0.5) : m;
+                k -= high;
+
+                const V kf = (V)((SV)(V{} + C::magic) + k) - C::magic;
+                const V f = m - static_cast<T>(1);
+                const V s = f / (static_cast<T>(2) + f);
+                const V z = s * s;
+                V R;
+                horner<T>(R, z, K::log_poly);
+                R *= z;
+
+                const V hfsq = static_cast<T>(0.5) * f * f;
+                V y = kf * C::ln2_hi - ((hfsq - (s * (hfsq + R) + kf * C::ln2_lo)) - f);
+
+                constexpr typename C::bits infinity = typename C::bits(2 * C::bias + 1) << C::mantissa;
+                SV special;
+                outside<T, Bytes>(special, x, typename C::bits(1) << C::mantissa, infinity); // Zero, subnormal, negative, inf, NaN
+                if (any(special))
+                    for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k)
+                        if (special[k]) y[k] = std::log(x[k]);
+                out[0] = y;
+            }
+        };
+
+        // atan(a / b) with a = min(|y|, |x|), b = max(|y|, |x|), then moved to the right octant
+        // @note Inputs are (y, x), like `std::atan2`. Zero, inf and NaN lanes go to libm
+        template<typename T, accuracy_ Tier>
+        struct atan2_kernel {
+            static constexpr std::size_t inputs = 2, outputs = 1;
+
+            static void scalar(T* out, const T* in) noexcept { out[0] = std::atan2(in[0], in[1]); }
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<T, Bytes>* out, const vec<T, Bytes>* in) noexcept {
+                using C = constants<T>;
+                using V = vec<T, Bytes>;
+                using UV = bits_vec<T, Bytes>;
+                using SV = sbits_vec<T, Bytes>;
+                const V& y = in[0];
+                const V& x = in[1];
+
+                V ax, ay;
+                abs<T, Bytes>(ax, x);
+                abs<T, Bytes>(ay, y);
+                const SV swap = ay > ax;
+                V a = swap ? ax : ay;
+                V b = swap ? ay : ax;
+
+                // Only the ratio matters: scale huge pairs down by 16 (exact), so `a * 16` and `(b + b) + a` below stay finite
+                const SV huge = b > std::numeric_limits<T>::max() / static_cast<T>(16);
+                a = huge ? a * static_cast<T>(0.0625) : a;
+                b = huge ? b * static_cast<T>(0.0625) : b;
+
+                // atan(a / b) = hi + atan(u), |u| small, with one division
+                V num, den, hi, lo, P;
+                if constexpr (Tier == accuracy_fast) {
+                    const SV big = a > b * static_cast<T>(fast::tan_pio8);
+                    num = big ? a - b : a;
+                    den = big ? a + b : b;
+                    hi = big ? V{} + static_cast<T>(C::pio4_hi) : V{};
+                    lo = V{};
+                } else {
+                    // fdlibm's breakpoints: a/b < 7/16, < 11/16 (around atan(1/2)), else around atan(1)
+                    const SV small = a * static_cast<T>(16) < b * static_cast<T>(7);
+                    const SV mid = a * static_cast<T>(16) < b * static_cast<T>(11);
+                    num = small ? a : (mid ? (a + a) - b : a - b);
+                    den = small ? b : (mid ? (b + b) + a : a + b);
+                    hi = small ? V{} : (mid ? V{} + C::atan_half_hi : V{} + C::pio4_hi);
+                    lo = small ? V{} : (mid ? V{} + C::atan_half_lo : V{} + C::pio4_lo);
+                }
+                const V u = num / den;
+                const V z = u * u;
+                if constexpr (Tier == accuracy_fast) horner<T>(P, z, fast::atan_poly);
+                else horner<T>(P, z, C::atan_poly);
+
+                V r = hi + (u + ((u * z) * P + lo));
+                r = swap ? (C::pio2_hi - r) + C::pio2_lo : r;
+                r = (SV)x < 0 ? (C::pi_hi - r) + C::pi_lo : r; // Sign bit, so -0 counts as negative
+
+                constexpr typename C::bits sign = typename C::bits(1) << (sizeof(T) * 8 - 1);
+                r = (V)(((UV)r & ~sign) | ((UV)y & sign));
+
+                constexpr typename C::bits infinity = typename C::bits(2 * C::bias + 1) << C::mantissa;
+                SV special;
+                outside<T, Bytes>(special, b, 1, infinity); // Zero, inf, NaN
+                if (any(special))
+                    for (std::size_t k = 0; k < lanes<T, Bytes>::count; ++k)
+                        if (special[k]) r[k] = std::atan2(y[k], x[k]);
+                out[0] = r;
+            }
+        };
+
+        // A float kernel computed by the double 4-ULP one: its error is far below half a float ULP, so only the last rounding counts
+        template<template<typename, accuracy_> class K>
+        struct widened {
+            using D = K<double, accuracy_4ulp>;
+            static constexpr std::size_t inputs = D::inputs, outputs = D::outputs;
+
+            template<std::size_t Bytes>
+            [[gnu::always_inline]] static void apply(vec<float, Bytes>* out, const vec<float, Bytes>* in) noexcept {
+                vec<double, Bytes> lo[inputs], hi[inputs], rlo[outputs], rhi[outputs];
+                for (std::size_t j = 0; j < inputs; ++j) widen<Bytes>(lo[j], hi[j], in[j]);
+                D::template apply<Bytes>(rlo, lo);
+                D::template apply<Bytes>(rhi, hi);
+                for (std::size_t j = 0; j < outputs; ++j) narrow<Bytes>(out[j], rlo[j], rhi[j]);
+            }
+        };
+        #pragma endregion
+
+
+
+        #pragma region Drivers
+        template<typename K, typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline void map(const T* const* in, T* const* out, const std::size_t n) noexcept {
+            using V = vec<T, Bytes>;
+            constexpr std::size_t N = lanes<T, Bytes>::count;
+
+            V x[K::inputs], y[K::outputs];
+            std::size_t i = 0;
+            for (; i + N <= n; i += N) {
+                for (std::size_t j = 0; j < K::inputs; ++j) load(x[j], in[j] + i);
+                K::template apply<Bytes>(y, x);
+                for (std::size_t j = 0; j < K::outputs; ++j) store(out[j] + i, y[j]);
+            }
+            if (i < n) {
+                for (std::size_t j = 0; j < K::inputs; ++j) load_partial(x[j], in[j] + i, n - i);
+                K::template apply<Bytes>(y, x);
+                for (std::size_t j = 0; j < K::outputs; ++j) store_partial(out[j] + i, y[j], n - i);
+            }
+        }
+
+        template<template<typename, accuracy_> class K, typename T>
+        inline void run(const T* const* in, T* const* out, const std::size_t n, const accuracy_ accuracy) {
+            switch (accuracy) {
+            case accuracy_fast:
+                dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                    map<K<T, accuracy_fast>, T, Bytes>(in, out, n);
+                });
+                break;
+
+            case accuracy_1ulp:
+                if constexpr (std::is_same_v<T, double>) {
+                    constexpr std::size_t I = K<T, accuracy_1ulp>::inputs, O = K<T, accuracy_1ulp>::outputs;
+                    T x[I], y[O];
+                    for (std::size_t i = 0; i < n; ++i) {
+                        for (std::size_t j = 0; j < I; ++j) x[j] = in[j][i];
+                        K<T, accuracy_1ulp>::scalar(y, x);
+                        for (std::size_t j = 0; j < O; ++j) out[j][i] = y[j];
+                    }
+                } else {
+                    dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                        map<widened<K>, T, Bytes>(in, out, n);
+                    });
+                }
+                break;
+
+            default:
+                dispatch([&]<std::size_t Bytes>() __attribute__((always_inline)) {
+                    map<K<T, accuracy_4ulp>, T, Bytes>(in, out, n);
+                });
+            }
+        }
+
+        template<typename R>
+        inline void same_size(const char* where, const std::size_t n, const R& r) {
+            if (std::ranges::size(r) != n)
+                throw std::runtime_error(std::string("asl::math::trig::") + where + "(): Sizes differ.");
+        }
+        #pragma endregion
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region Functions
+    // @note Batch versions over contiguous ranges (`containers::vector`, `std::vector`, spans...), through the ISA picked by `arithmetic::isa()`
+    // @note `out` must have the same size as the input(s). It may be an input (in place), but not overlap it otherwise
+
+    // out[i] = sin(x[i])
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> Out>
+    inline void sin(const In& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("sin", n, out);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::sin_kernel>(in, result, n, accuracy);
+    }
+
+    // out[i] = cos(x[i])
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> Out>
+    inline void cos(const In& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("cos", n, out);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::cos_kernel>(in, result, n, accuracy);
+    }
+
+    // s[i] = sin(x[i]), c[i] = cos(x[i]), for about the price of one of them
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> OutS, arithmetic::an_output_of<std::ranges::range_value_t<In>> OutC>
+    inline void sincos(const In& x, OutS&& s, OutC&& c, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("sincos", n, s);
+        _internal::same_size("sincos", n, c);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(s), std::ranges::data(c) };
+        _internal::run<_internal::sincos_kernel>(in, result, n, accuracy);
+    }
+
+    // out[i] = tan(x[i])
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> Out>
+    inline void tan(const In& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("tan", n, out);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::tan_kernel>(in, result, n, accuracy);
+    }
+
+    // out[i] = atan2(y[i], x[i]), in [-pi, pi]
+    template<a_real_range InY, arithmetic::a_range_of<std::ranges::range_value_t<InY>> InX, arithmetic::an_output_of<std::ranges::range_value_t<InY>> Out>
+    inline void atan2(const InY& y, const InX& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<InY>;
+        const std::size_t n = std::ranges::size(y);
+        _internal::same_size("atan2", n, x);
+        _internal::same_size("atan2", n, out);
+
+        const T* in[] = { std::ranges::data(y), std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::atan2_kernel>(in, result, n, accuracy);
+    }
+
+    // out[i] = e^x[i]
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> Out>
+    inline void exp(const In& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("exp", n, out);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::exp_kernel>(in, result, n, accuracy);
+    }
+
+    // out[i] = ln(x[i])
+    template<a_real_range In, arithmetic::an_output_of<std::ranges::range_value_t<In>> Out>
+    inline void log(const In& x, Out&& out, const accuracy_ accuracy = accuracy_4ulp) {
+        using T = std::ranges::range_value_t<In>;
+        const std::size_t n = std::ranges::size(x);
+        _internal::same_size("log", n, out);
+
+        const T* in[] = { std::ranges::data(x) };
+        T* const result[] = { std::ranges::data(out) };
+        _internal::run<_internal::log_kernel>(in, result, n, accuracy);
+    }
+
+    #pragma endregion
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,14 +2,526 @@
 #define RT_EVENT_HPP
 
 #include "../types/object.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#endif
 
 namespace asl::rt {
 
+    #pragma region Enums
+    // What to wait for on a file descriptor
+    // @note Enumerators represent the `epoll` flags. Use `operator|` to combine them
+    enum readiness_ : uint32_t {
+        #ifdef __linux__
+        ready_read   = EPOLLIN,
+        ready_write  = EPOLLOUT,
+        ready_hangup = EPOLLHUP | EPOLLRDHUP, // Always reported, no need to ask
+        ready_error  = EPOLLERR,              // Always reported, no need to ask
+        edge_triggered = EPOLLET              // Only report changes (default: level-triggered)
+        #else
+        ready_read = 1, ready_write = 4, ready_hangup = 16, ready_error = 8, edge_triggered = 1u << 31
+        #endif
+    };
+    #pragma endregion
+
+
+
+
     // Event maker
-    class event final : private types::object {
+    // @note An epoll reactor: fd readiness, timers (timerfd), signals (signalfd), cross-thread wakeups (eventfd)
+    // @note Not thread-safe, except `post()`, `wake()` and `stop()`
+    class event final : private types::object<event> {
     public:
-        // TODO: Event
+        // Called with what is ready (`readiness_` flags)
+        using fd_callback = std::function<void(uint32_t)>;
+
+        // Called with how many times the timer expired since the last call
+        using timer_callback = std::function<void(uint64_t)>;
+
+        // What a signal callback gets
+        #ifdef __linux__
+        using signal_info = signalfd_siginfo;
+        #else
+        struct signal_info { uint32_t ssi_signo = 0; };
+        #endif
+
+        // Called with the signal info
+        using signal_callback = std::function<void(const signal_info&)>;
+
+        // Handle of a timer (its timerfd, and a generation so a stale handle never reaches a reused fd)
+        using timer_id = uint64_t;
+
+        // No timer (never returned by `add_timer()`)
+        static constexpr timer_id no_timer = 0;
+
+    private:
+        enum class kind_ : uint8_t { fd, timer, signal, wake };
+
+        struct watcher_ {
+            int fd;
+            kind_ kind;
+            bool alive = true;
+            fd_callback on_fd;
+            timer_callback on_timer;
+            uint32_t generation = 0; // Timers only
+        };
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        int signal_fd_ = -1;
+
+        std::unordered_map<int, std::unique_ptr<watcher_>> watchers_;
+        std::vector<std::unique_ptr<watcher_>> retired_; // Removed while dispatching, freed after the batch
+        uint32_t timer_generation_ = 0;
+
+        #ifdef __linux__
+        std::vector<epoll_event> ready_; // Reused by every `epoll_wait`
+        sigset_t signal_mask_;
+        #endif
+        std::vector<signal_callback> signal_callbacks_;
+
+        std::mutex tasks_mutex_;
+        std::vector<std::function<void()>> tasks_;   // Posted
+        std::vector<std::function<void()>> running_; // Being run, swapped with `tasks_` to keep both capacities
+
+        std::atomic<bool> stopping_{ false };
+        std::atomic<std::thread::id> loop_thread_{};
+
+        std::shared_ptr<void> alive_ = std::make_shared<bool>(true); // Only handed out weakly, see `lifetime()`
+
+        void add_(const int fd, const kind_ kind, const uint32_t events, fd_callback on_fd, timer_callback on_timer) {
+            #ifdef __linux__
+            auto w = std::make_unique<watcher_>(watcher_{ fd, kind, true, std::move(on_fd), std::move(on_timer) });
+
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.ptr = w.get();
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1)
+                throw std::runtime_error("asl::rt::event: epoll_ctl(ADD) failed.");
+
+            watchers_[fd] = std::move(w);
+            #endif
+        }
+
+        bool remove_(const int fd) {
+            #ifdef __linux__
+            const auto it = watchers_.find(fd);
+            if (it == watchers_.end()) return false;
+
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            it->second->alive = false;
+            retired_.push_back(std::move(it->second)); // Might be mid-dispatch
+            watchers_.erase(it);
+            return true;
+            #else
+            return false;
+            #endif
+        }
+
+        // The live timer `id` refers to, if any
+        watcher_* timer_(const timer_id id) noexcept {
+            const auto it = watchers_.find(static_cast<int>(id & 0xffffffffu));
+            if (it == watchers_.end()) return nullptr;
+
+            watcher_& w = *it->second;
+            return w.kind == kind_::timer && w.generation == static_cast<uint32_t>(id >> 32) ? &w : nullptr;
+        }
+
+        void run_tasks_() {
+            {
+                std::lock_guard lock(tasks_mutex_);
+                running_.swap(tasks_);
+            }
+            for (auto& task : running_) task();
+            running_.clear();
+        }
+
+        void dispatch_(watcher_& w, const uint32_t events) {
+            #ifdef __linux__
+            switch (w.kind) {
+                case kind_::fd:
+                    w.on_fd(events);
+                    break;
+
+                case kind_::timer: {
+                    uint64_t expirations = 0;
+                    if (::read(w.fd, &expirations, sizeof(expirations)) != sizeof(expirations)) break;
+
+                    w.on_timer(expirations);
+                    if (!w.alive) break;
+
+                    // Disarmed (one-shot, not re-armed by the callback): done with it, its handle goes stale
+                    itimerspec spec;
+                    timerfd_gettime(w.fd, &spec);
+                    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+                        const int fd = w.fd;
+                        if (remove_(fd)) close(fd);
+                    }
+                    break;
+                }
+
+                case kind_::signal: {
+                    signalfd_siginfo infos[16];
+                    const ssize_t got = ::read(w.fd, infos, sizeof(infos));
+                    for (ssize_t i = 0; i < got / static_cast<ssize_t>(sizeof(signalfd_siginfo)); ++i) {
+                        const auto signo = infos[i].ssi_signo;
+                        if (signo >= signal_callbacks_.size() || !signal_callbacks_[signo]) continue;
+
+                        const signal_callback callback = signal_callbacks_[signo]; // It may `off_signal()` itself
+                        callback(infos[i]);
+                    }
+                    break;
+                }
+
+                case kind_::wake: {
+                    uint64_t count;
+                    [[maybe_unused]] const ssize_t got = ::read(w.fd, &count, sizeof(count));
+                    run_tasks_();
+                    break;
+                }
+            }
+            #endif
+        }
+
+        static timespec to_timespec_(const std::chrono::nanoseconds d) noexcept {
+            const auto s = std::chrono::duration_cast<std::chrono::seconds>(d);
+            return { static_cast<time_t>(s.count()), static_cast<long>((d - s).count()) };
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param batch_size How many ready fds one `epoll_wait` can return (default: 256)
+        explicit event(const std::size_t batch_size = 256) {
+            #ifdef __linux__
+            ready_.resize(batch_size ? batch_size : 1);
+
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd_ == -1)
+                throw std::runtime_error("asl::rt::event::event(): epoll_create1 failed.");
+
+            wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (wake_fd_ == -1) {
+                close(epoll_fd_);
+                throw std::runtime_error("asl::rt::event::event(): eventfd failed.");
+            }
+            add_(wake_fd_, kind_::wake, ready_read, {}, {});
+
+            sigemptyset(&signal_mask_);
+            tasks_.reserve(64);
+            running_.reserve(64);
+            #elif _WIN32
+            (void)batch_size;
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        event(const event&) = delete;
+        event& operator=(const event&) = delete;
+
+        ~event() {
+            #ifdef __linux__
+            for (auto& [fd, w] : watchers_)
+                if (w->kind == kind_::timer) close(fd);
+
+            if (signal_fd_ != -1) {
+                close(signal_fd_);
+                pthread_sigmask(SIG_UNBLOCK, &signal_mask_, nullptr);
+            }
+            close(wake_fd_);
+            close(epoll_fd_);
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Fds
+
+        // Call `callback` whenever `fd` is ready
+        // @param fd Any pollable fd (not owned)
+        // @param readiness Use `operator|` to combine `readiness_` flags
+        // @param callback Called on the loop thread with what is ready
+        event& watch(const int fd, const uint32_t readiness, fd_callback callback) {
+            add_(fd, kind_::fd, readiness, std::move(callback), {});
+            return *this;
+        }
+
+        // Change what to wait for on a watched fd
+        event& modify(const int fd, const uint32_t readiness) {
+            #ifdef __linux__
+            const auto it = watchers_.find(fd);
+            if (it == watchers_.end())
+                throw std::runtime_error("asl::rt::event::modify(): fd is not watched.");
+
+            epoll_event ev{};
+            ev.events = readiness;
+            ev.data.ptr = it->second.get();
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == -1)
+                throw std::runtime_error("asl::rt::event::modify(): epoll_ctl(MOD) failed.");
+            #endif
+            return *this;
+        }
+
+        // Stop watching a fd (safe from inside its own callback)
+        // @note Does not close the fd
+        event& unwatch(const int fd) {
+            remove_(fd);
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Timers
+
+        // Call `callback` after `first`, then every `interval`
+        // @param first Delay before the first call
+        // @param interval Period (default: zero, once)
+        // @return A handle for `reset_timer()` / `cancel_timer()`, stale once a one-shot timer fired (unless its callback re-armed it)
+        template<typename Rep1, typename Period1, typename Rep2 = int, typename Period2 = std::ratio<1>>
+        timer_id add_timer(const std::chrono::duration<Rep1, Period1> first, timer_callback callback, const std::chrono::duration<Rep2, Period2> interval = std::chrono::duration<Rep2, Period2>::zero()) {
+            #ifdef __linux__
+            const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (fd == -1)
+                throw std::runtime_error("asl::rt::event::add_timer(): timerfd_create failed.");
+
+            itimerspec spec{};
+            spec.it_value = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(first));
+            spec.it_interval = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval));
+            if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1; // Zero would disarm
+
+            if (timerfd_settime(fd, 0, &spec, nullptr) == -1) {
+                close(fd);
+                throw std::runtime_error("asl::rt::event::add_timer(): timerfd_settime failed.");
+            }
+
+            try {
+                add_(fd, kind_::timer, ready_read, {}, std::move(callback));
+            } catch (...) {
+                close(fd);
+                throw;
+            }
+
+            if (++timer_generation_ == 0) ++timer_generation_; // Keeps `no_timer` unused
+            watchers_[fd]->generation = timer_generation_;
+            return static_cast<timer_id>(timer_generation_) << 32 | static_cast<uint32_t>(fd);
+            #else
+            (void)first, (void)callback, (void)interval;
+            return no_timer;
+            #endif
+        }
+
+        // Re-arm a timer
+        // @param first Delay before the next call
+        // @param interval Period (zero: once)
+        // @note Throws if `id` is stale (a one-shot timer that fired, or a cancelled one)
+        template<typename Rep1, typename Period1, typename Rep2 = int, typename Period2 = std::ratio<1>>
+        event& reset_timer(const timer_id id, const std::chrono::duration<Rep1, Period1> first, const std::chrono::duration<Rep2, Period2> interval = std::chrono::duration<Rep2, Period2>::zero()) {
+            #ifdef __linux__
+            itimerspec spec{};
+            spec.it_value = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(first));
+            spec.it_interval = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval));
+            if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;
+
+            const watcher_* w = timer_(id);
+            if (!w)
+                throw std::runtime_error("asl::rt::event::reset_timer(): No such timer.");
+            if (timerfd_settime(w->fd, 0, &spec, nullptr) == -1)
+                throw std::runtime_error("asl::rt::event::reset_timer(): timerfd_settime failed.");
+            #else
+            (void)id, (void)first, (void)interval;
+            #endif
+            return *this;
+        }
+
+        // Remove a timer (safe from inside its own callback)
+        // @note Does nothing if `id` is stale
+        event& cancel_timer(const timer_id id) {
+            #ifdef __linux__
+            if (const watcher_* w = timer_(id)) {
+                const int fd = w->fd;
+                if (remove_(fd)) close(fd);
+            }
+            #else
+            (void)id;
+            #endif
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Signals
+
+        // Deliver `signo` to `callback` on the loop thread instead of an async handler
+        // @note Blocks `signo` for the calling thread, so create the loop (and call this) before spawning threads
+        event& on_signal(const int signo, signal_callback callback) {
+            #ifdef __linux__
+            sigaddset(&signal_mask_, signo);
+            if (pthread_sigmask(SIG_BLOCK, &signal_mask_, nullptr) != 0)
+                throw std::runtime_error("asl::rt::event::on_signal(): pthread_sigmask failed.");
+
+            const int fd = signalfd(signal_fd_, &signal_mask_, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (fd == -1)
+                throw std::runtime_error("asl::rt::event::on_signal(): signalfd failed.");
+
+            if (signal_fd_ == -1) {
+                signal_fd_ = fd;
+                add_(signal_fd_, kind_::signal, ready_read, {}, {});
+            }
+
+            if (static_cast<std::size_t>(signo) >= signal_callbacks_.size())
+                signal_callbacks_.resize(static_cast<std::size_t>(signo) + 1);
+            signal_callbacks_[static_cast<std::size_t>(signo)] = std::move(callback);
+            #else
+            (void)signo, (void)callback;
+            #endif
+            return *this;
+        }
+
+        // Stop delivering `signo` to the loop: its callback is dropped and the signal unblocked for the calling thread
+        // @note Safe from inside the callback
+        event& off_signal(const int signo) {
+            #ifdef __linux__
+            if (static_cast<std::size_t>(signo) < signal_callbacks_.size())
+                signal_callbacks_[static_cast<std::size_t>(signo)] = nullptr;
+            if (signal_fd_ == -1 || sigismember(&signal_mask_, signo) != 1) return *this;
+
+            sigdelset(&signal_mask_, signo);
+            if (signalfd(signal_fd_, &signal_mask_, SFD_NONBLOCK | SFD_CLOEXEC) == -1)
+                throw std::runtime_error("asl::rt::event::off_signal(): signalfd failed.");
+
+            sigset_t one;
+            sigemptyset(&one);
+            sigaddset(&one, signo);
+            pthread_sigmask(SIG_UNBLOCK, &one, nullptr);
+            #else
+            (void)signo;
+            #endif
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Cross-thread
+
+        // Run `task` on the loop thread (from any thread)
+        event& post(std::function<void()> task) {
+            {
+                std::lock_guard lock(tasks_mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            return wake();
+        }
+
+        // Wake the loop up (from any thread)
+        event& wake() noexcept {
+            #ifdef __linux__
+            const uint64_t one = 1;
+            [[maybe_unused]] const ssize_t done = ::write(wake_fd_, &one, sizeof(one));
+            #endif
+            return *this;
+        }
+
+        // Whether the caller runs on the loop thread
+        bool in_loop_thread() const noexcept {
+            return loop_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Loop
+
+        // Wait once, then run every ready callback
+        // @param timeout How long to wait (negative: forever, zero: don't block)
+        // @return How many fds were ready
+        std::size_t run_once(const std::chrono::milliseconds timeout = std::chrono::milliseconds(-1)) {
+            #ifdef __linux__
+            loop_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+            const int n = epoll_wait(epoll_fd_, ready_.data(), static_cast<int>(ready_.size()), timeout.count() < 0 ? -1 : static_cast<int>(timeout.count()));
+            if (n < 0) {
+                if (errno == EINTR) return 0;
+                throw std::runtime_error("asl::rt::event::run_once(): epoll_wait failed.");
+            }
+
+            for (int i = 0; i < n; ++i) {
+                watcher_& w = *static_cast<watcher_*>(ready_[static_cast<std::size_t>(i)].data.ptr);
+                if (w.alive) dispatch_(w, ready_[static_cast<std::size_t>(i)].events);
+            }
+            retired_.clear();
+
+            return static_cast<std::size_t>(n);
+            #else
+            (void)timeout;
+            return 0;
+            #endif
+        }
+
+        // Run until `stop()`
+        // @note A `stop()` that came before returns right away (it is used up, the next `run()` runs)
+        event& run() {
+            while (!stopping_.load(std::memory_order_relaxed))
+                run_once();
+            stopping_.store(false, std::memory_order_relaxed);
+            return *this;
+        }
+
+        // Make `run()` return (from any thread)
+        event& stop() noexcept {
+            stopping_.store(true, std::memory_order_relaxed);
+            return wake();
+        }
+
+        // Number of watched fds, timers and signal fd (the internal wakeup fd excluded)
+        std::size_t size() const noexcept {
+            return watchers_.size() - 1;
+        }
+
+        // Expires when this loop is destroyed, for things attached to it that may outlive it
+        std::weak_ptr<void> lifetime() const noexcept {
+            return alive_;
+        }
+
+        #pragma endregion
     };
 }
 
-#endif
\ No newline at end of file
+#endif
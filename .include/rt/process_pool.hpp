@@ -0,0 +1,294 @@
+#ifndef RT_PROCESS_POOL_HPP
+#define RT_PROCESS_POOL_HPP
+
+#include "../types/object.hpp"
+#include "./event.hpp"
+#include "./process_starter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#endif
+
+namespace asl::rt {
+
+    // A fixed set of warm worker processes, fed jobs over pipes
+    // @note Protocol: one job is one line on the worker's stdin, its reply is one line on its stdout
+    // @note Workers are started up front (and restarted when they die), so no spawn happens per job
+    // @note A worker that keeps dying before it replies is restarted after a growing delay (10 ms, doubling, up to ~5 s)
+    // @note Lives on the loop thread, like `event` itself
+    class process_pool final : private types::object<process_pool> {
+    public:
+        // Called on the loop thread with the reply line (without '\n'), or `ok = false` if the worker died on the job
+        using reply_callback = std::function<void(std::string_view reply, bool ok)>;
+
+    private:
+        struct job_ {
+            std::string line; // With its '\n'
+            reply_callback callback;
+        };
+
+        struct worker_ {
+            process proc;
+            bool busy = false;
+            reply_callback callback;
+
+            std::string to_write;
+            std::size_t written = 0;
+            bool watching_write = false;
+
+            std::string partial; // Reply read so far
+
+            std::size_t generation = 0; // Bumped on each start, to notice a restart from inside a callback
+            unsigned failures = 0;      // Deaths in a row without a reply
+            event::timer_id restart_timer = event::no_timer; // Pending delayed start
+        };
+
+        event& loop_;
+        process_starter starter_;
+        std::vector<std::unique_ptr<worker_>> workers_;
+        std::deque<job_> queue_;
+        std::size_t max_queued_;
+        std::size_t restarts_ = 0;
+
+        void start_worker_(worker_& w) {
+            w.proc = starter_.start();
+            ++w.generation;
+            w.busy = false;
+            w.callback = nullptr;
+            w.to_write.clear();
+            w.written = 0;
+            w.watching_write = false;
+            w.partial.clear();
+
+            loop_.watch(w.proc.stdout_fd(), ready_read, [this, &w](uint32_t) { on_readable_(w); });
+        }
+
+        // Kill it, fail its job, start a new one (after a delay if it keeps dying)
+        void restart_worker_(worker_& w) {
+            #ifdef __linux__
+            loop_.unwatch(w.proc.stdout_fd());
+            if (w.watching_write) loop_.unwatch(w.proc.stdin_fd());
+            w.proc.close_stdin().kill(SIGKILL).wait();
+            #endif
+
+            reply_callback failed = std::move(w.callback);
+            ++restarts_;
+
+            // Dying again before any reply: wait a bit, it is kept busy meanwhile
+            if (w.failures++ == 0) start_worker_(w);
+            else {
+                w.busy = true;
+                w.watching_write = false;
+                ++w.generation;
+                const auto delay = std::chrono::milliseconds(10) * (1u << std::min(w.failures - 2, 9u));
+                w.restart_timer = loop_.add_timer(delay, [this, &w](uint64_t) {
+                    w.restart_timer = event::no_timer;
+                    start_worker_(w);
+                    dispatch_();
+                });
+            }
+
+            if (failed) failed({}, false);
+            dispatch_();
+        }
+
+        void flush_(worker_& w) {
+            #ifdef __linux__
+            while (w.written < w.to_write.size()) {
+                const ssize_t n = w.proc.write_stdin(std::string_view(w.to_write).substr(w.written));
+                if (n > 0) {
+                    w.written += static_cast<std::size_t>(n);
+                    continue;
+                }
+                if (n == -1 && errno == EINTR) continue;
+                if (n == -1 && errno == EAGAIN) {
+                    if (!w.watching_write) {
+                        loop_.watch(w.proc.stdin_fd(), ready_write, [this, &w](uint32_t) { flush_(w); });
+                        w.watching_write = true;
+                    }
+                    return;
+                }
+                restart_worker_(w); // EPIPE: it is gone
+                return;
+            }
+
+            w.to_write.clear();
+            w.written = 0;
+            if (w.watching_write) {
+                loop_.unwatch(w.proc.stdin_fd());
+                w.watching_write = false;
+            }
+            #endif
+        }
+
+        void on_readable_(worker_& w) {
+            #ifdef __linux__
+            char buffer[16384];
+            for (;;) {
+                const ssize_t n = ::read(w.proc.stdout_fd(), buffer, sizeof(buffer));
+                if (n == -1 && errno == EINTR) continue;
+                if (n == -1 && errno == EAGAIN) return;
+                if (n <= 0) {
+                    restart_worker_(w);
+                    return;
+                }
+
+                std::string_view chunk(buffer, static_cast<std::size_t>(n));
+                std::size_t nl;
+                while ((nl = chunk.find('\n')) != std::string_view::npos) {
+                    std::string_view reply = chunk.substr(0, nl);
+                    if (!w.partial.empty()) {
+                        w.partial.append(reply);
+                        reply = w.partial;
+                    }
+
+                    reply_callback callback = std::move(w.callback);
+                    w.callback = nullptr;
+                    w.busy = false;
+                    w.failures = 0;
+
+                    // The callback (through `submit()`) or the next job may kill it, then the rest of the chunk is stale
+                    const std::size_t generation = w.generation;
+                    if (callback) callback(reply, true);
+                    if (generation != w.generation) return;
+
+                    w.partial.clear();
+                    chunk.remove_prefix(nl + 1);
+
+                    dispatch_();
+                    if (generation != w.generation) return;
+                }
+                w.partial.append(chunk);
+
+                if (static_cast<std::size_t>(n) < sizeof(buffer)) return;
+            }
+            #endif
+        }
+
+        void send_(worker_& w, job_&& job) {
+            w.busy = true;
+            w.callback = std::move(job.callback);
+            w.to_write = std::move(job.line);
+            w.written = 0;
+            flush_(w);
+        }
+
+        void dispatch_() {
+            for (auto& w : workers_) {
+                if (queue_.empty()) return;
+                if (w->busy) continue;
+
+                job_ job = std::move(queue_.front());
+                queue_.pop_front();
+                send_(*w, std::move(job));
+            }
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param loop The loop that drives the pool (must outlive it)
+        // @param starter How to start one worker (stdin / stdout are replaced by pipes)
+        // @param workers How many to keep running
+        // @param max_queued Jobs that can wait for a free worker (default: 1024)
+        process_pool(event& loop, const process_starter& starter, const std::size_t workers, const std::size_t max_queued = 1024) :
+            loop_(loop), starter_(starter), max_queued_(max_queued) {
+            if (workers == 0)
+                throw std::runtime_error("asl::rt::process_pool::process_pool(): Needs at least one worker.");
+
+            starter_.redirect_stdin(redirect_pipe).redirect_stdout(redirect_pipe);
+            workers_.reserve(workers);
+            for (std::size_t i = 0; i < workers; ++i) {
+                workers_.push_back(std::make_unique<worker_>());
+                start_worker_(*workers_.back());
+            }
+        }
+
+        process_pool(const process_pool&) = delete;
+        process_pool& operator=(const process_pool&) = delete;
+
+        // Close the workers' stdin (they should exit on EOF), then wait for them
+        // @note Pending jobs are dropped without calling back
+        ~process_pool() {
+            #ifdef __linux__
+            for (auto& w : workers_) {
+                loop_.cancel_timer(w->restart_timer);
+                loop_.unwatch(w->proc.stdout_fd());
+                if (w->watching_write) loop_.unwatch(w->proc.stdin_fd());
+                w->proc.close_stdin();
+            }
+            for (auto& w : workers_) w->proc.wait();
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Jobs
+
+        // Queue a job
+        // @param line The request, without '\n'
+        // @return False if the queue is full (back-pressure, try later)
+        bool submit(const std::string_view line, reply_callback callback) {
+            if (line.find('\n') != std::string_view::npos)
+                throw std::runtime_error("asl::rt::process_pool::submit(): A job is one line.");
+            if (queue_.size() >= max_queued_) return false;
+
+            std::string framed;
+            framed.reserve(line.size() + 1);
+            framed.append(line).append(1, '\n');
+            queue_.push_back({ std::move(framed), std::move(callback) });
+            dispatch_();
+            return true;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        std::size_t workers() const noexcept {
+            return workers_.size();
+        }
+
+        // Workers running a job
+        std::size_t busy() const noexcept {
+            std::size_t n = 0;
+            for (const auto& w : workers_) n += w->busy;
+            return n;
+        }
+
+        // Jobs waiting for a worker
+        std::size_t queued() const noexcept {
+            return queue_.size();
+        }
+
+        // Workers started again after dying
+        std::size_t restarts() const noexcept {
+            return restarts_;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
@@ -2,22 +2,677 @@
 #define RT_PROCESS_STARTER_HPP
 
 #include "../types/object.hpp"
+#include "../env_var.hpp"
+#include "./event.hpp"
+#include "./trace_points.hpp"
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
 #elif __unix__
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #endif
 
 namespace asl::rt {
-    
+
+    #pragma region Enums
+    // Where a standard stream of the child goes
+    enum redirect_ : uint8_t {
+        redirect_inherit, // Same as ours
+        redirect_pipe,    // A pipe we hold the other end of
+        redirect_null,    // `/dev/null`
+        redirect_file,    // A file, truncated for output
+        redirect_append,  // A file, appended to for output
+        redirect_fd       // A fd of ours (not owned)
+    };
+    #pragma endregion
+
+
+
+
+    // How a process ended
+    struct exit_status {
+        int code = -1;  // Exit code, -1 if killed by a signal
+        int signal = 0; // The killing signal, 0 if it exited
+
+        bool exited() const noexcept {
+            return signal == 0 && code >= 0;
+        }
+
+        bool success() const noexcept {
+            return code == 0 && signal == 0;
+        }
+
+        static exit_status from_wait(const int status) noexcept {
+            #ifdef __unix__
+            if (WIFEXITED(status)) return { WEXITSTATUS(status), 0 };
+            if (WIFSIGNALED(status)) return { -1, WTERMSIG(status) };
+            #endif
+            return { -1, 0 };
+        }
+    };
+
+
+
+    // A started child process
+    // @note Move-only. Destroying it closes our pipe ends but does not wait for the child: call `wait()` to reap it
+    class process final : private types::object<process> {
+    public:
+        // Called with a chunk of output (valid only during the call)
+        using chunk_callback = std::function<void(std::string_view)>;
+
+    private:
+        pid_t pid_ = -1;
+        int in_ = -1;  // Child's stdin, write end
+        int out_ = -1; // Child's stdout, read end
+        int err_ = -1; // Child's stderr, read end
+
+        bool reaped_ = false;
+        exit_status status_;
+
+        // The pipes handed to an event loop by `drain()`, shared with its callbacks (so moving this object is fine)
+        struct drain_state_ {
+            event* loop;
+            std::weak_ptr<void> loop_alive;
+            int fds[2] = { -1, -1 }; // stdout, stderr
+            int open = 0;
+            std::function<void()> on_closed;
+        };
+        std::shared_ptr<drain_state_> draining_;
+
+        friend class process_starter;
+
+        static void close_(int& fd) noexcept {
+            #ifdef __unix__
+            if (fd != -1) close(fd);
+            #endif
+            fd = -1;
+        }
+
+        // Unwatch, then close, what `drain()` still holds
+        void stop_draining_() noexcept {
+            if (!draining_) return;
+            const bool loop_alive = !draining_->loop_alive.expired();
+            for (int& fd : draining_->fds) {
+                if (fd == -1) continue;
+                if (loop_alive) draining_->loop->unwatch(fd);
+                close_(fd);
+            }
+            draining_.reset();
+        }
+
+        // `write()` that does not kill us with SIGPIPE when the child closed its end
+        static ssize_t write_no_sigpipe_(const int fd, const char* data, const std::size_t size) noexcept {
+            #ifdef __unix__
+            sigset_t pipe_set, old_set;
+            sigemptyset(&pipe_set);
+            sigaddset(&pipe_set, SIGPIPE);
+
+            sigset_t pending;
+            sigpending(&pending);
+            const bool was_pending = sigismember(&pending, SIGPIPE);
+            pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+            const ssize_t n = ::write(fd, data, size);
+
+            // Swallow the SIGPIPE we caused, if any
+            if (n == -1 && errno == EPIPE && !was_pending) {
+                const int saved = errno;
+                const timespec zero{ 0, 0 };
+                while (sigtimedwait(&pipe_set, nullptr, &zero) == -1 && errno == EINTR) {}
+                errno = saved;
+            }
+            pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+            return n;
+            #else
+            return -1;
+            #endif
+        }
+
+    public:
+
+        #pragma region Setups
+
+        process() noexcept = default;
+
+        process(const process&) = delete;
+        process& operator=(const process&) = delete;
+
+        process(process&& other) noexcept :
+            pid_(std::exchange(other.pid_, -1)), in_(std::exchange(other.in_, -1)), out_(std::exchange(other.out_, -1)),
+            err_(std::exchange(other.err_, -1)), reaped_(other.reaped_), status_(other.status_), draining_(std::move(other.draining_)) {}
+
+        process& operator=(process&& other) noexcept {
+            if (this != &other) {
+                stop_draining_();
+                close_(in_);
+                close_(out_);
+                close_(err_);
+                pid_ = std::exchange(other.pid_, -1);
+                in_ = std::exchange(other.in_, -1);
+                out_ = std::exchange(other.out_, -1);
+                err_ = std::exchange(other.err_, -1);
+                reaped_ = other.reaped_;
+                status_ = other.status_;
+                draining_ = std::move(other.draining_);
+            }
+            return *this;
+        }
+
+        ~process() {
+            stop_draining_();
+            close_(in_);
+            close_(out_);
+            close_(err_);
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        pid_t pid() const noexcept {
+            return pid_;
+        }
+
+        // Our ends of the pipes, -1 if not `redirect_pipe`
+        int stdin_fd() const noexcept { return in_; }
+        int stdout_fd() const noexcept { return out_; }
+        int stderr_fd() const noexcept { return err_; }
+
+        // Whether `wait()` / `try_wait()` saw it end
+        bool reaped() const noexcept {
+            return reaped_;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Control
+
+        // Close the child's stdin (it sees EOF)
+        process& close_stdin() noexcept {
+            close_(in_);
+            return *this;
+        }
+
+        // Write to the child's stdin, without a SIGPIPE if it closed its end
+        // @return Bytes written, or -1 with `errno` set (EPIPE: it is gone)
+        ssize_t write_stdin(const std::string_view data) noexcept {
+            return write_no_sigpipe_(in_, data.data(), data.size());
+        }
+
+        // Send a signal
+        process& kill(const int signo = SIGTERM) {
+            #ifdef __unix__
+            if (!reaped_ && pid_ > 0 && ::kill(pid_, signo) == -1 && errno != ESRCH)
+                throw std::runtime_error("asl::rt::process::kill(): kill failed.");
+            #endif
+            return *this;
+        }
+
+        // Block until it ends
+        exit_status wait() {
+            #ifdef __unix__
+            if (reaped_ || pid_ <= 0) return status_;
+
+            int status;
+            pid_t r;
+            while ((r = waitpid(pid_, &status, 0)) == -1 && errno == EINTR) {}
+            if (r == -1)
+                throw std::runtime_error("asl::rt::process::wait(): waitpid failed.");
+
+            status_ = exit_status::from_wait(status);
+            reaped_ = true;
+            #endif
+            return status_;
+        }
+
+        // Reap it if it ended
+        // @return False if it is still running
+        bool try_wait(exit_status& status) {
+            #ifdef __unix__
+            if (!reaped_ && pid_ > 0) {
+                int raw;
+                const pid_t r = waitpid(pid_, &raw, WNOHANG);
+                if (r == 0) return false;
+                if (r == -1)
+                    throw std::runtime_error("asl::rt::process::try_wait(): waitpid failed.");
+                status_ = exit_status::from_wait(raw);
+                reaped_ = true;
+            }
+            #endif
+            status = status_;
+            return true;
+        }
+
+        // Record how it ended when someone else reaped it (e.g., a supervisor)
+        process& mark_reaped(const exit_status status) noexcept {
+            status_ = status;
+            reaped_ = true;
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Output
+
+        // Feed `input` to stdin while collecting stdout and stderr, then wait for the exit
+        // @param out, err Where to append the output (nullptr: discard it)
+        // @note Multiplexes all pipes with `poll`, so a child filling one pipe while we write another cannot deadlock
+        exit_status communicate(const std::string_view input = {}, std::string* out = nullptr, std::string* err = nullptr) {
+            #ifdef __unix__
+            std::size_t written = 0;
+            if (in_ != -1 && input.empty()) close_(in_);
+
+            char buffer[65536];
+            while (in_ != -1 || out_ != -1 || err_ != -1) {
+                pollfd fds[3];
+                nfds_t n = 0;
+                if (in_ != -1) fds[n++] = { in_, POLLOUT, 0 };
+                if (out_ != -1) fds[n++] = { out_, POLLIN, 0 };
+                if (err_ != -1) fds[n++] = { err_, POLLIN, 0 };
+
+                if (poll(fds, n, -1) == -1) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("asl::rt::process::communicate(): poll failed.");
+                }
+
+                for (nfds_t i = 0; i < n; ++i) {
+                    if (!fds[i].revents) continue;
+
+                    if (fds[i].fd == in_) {
+                        const ssize_t w = write_no_sigpipe_(in_, input.data() + written, input.size() - written);
+                        if (w > 0) written += static_cast<std::size_t>(w);
+                        if ((w == -1 && errno != EAGAIN && errno != EINTR) || written == input.size()) close_(in_);
+                        continue;
+                    }
+
+                    int& fd = fds[i].fd == out_ ? out_ : err_;
+                    std::string* sink = &fd == &out_ ? out : err;
+                    const ssize_t r = ::read(fd, buffer, sizeof(buffer));
+                    if (r > 0) {
+                        if (sink) sink->append(buffer, static_cast<std::size_t>(r));
+                    } else if (r == 0 || (errno != EAGAIN && errno != EINTR)) {
+                        close_(fd);
+                    }
+                }
+            }
+            #endif
+            return wait();
+        }
+
+        // Drain stdout / stderr from an event loop instead
+        // @param on_stdout, on_stderr Called with each chunk (null: discard)
+        // @param on_closed Called once both pipes reached EOF
+        // @note The pipes go to the loop (`stdout_fd()` / `stderr_fd()` become -1). Destroying this object stops the draining
+        process& drain(event& loop, chunk_callback on_stdout, chunk_callback on_stderr = nullptr, std::function<void()> on_closed = nullptr) {
+            if (draining_) throw std::runtime_error("asl::rt::process::drain(): Already draining.");
+            if (out_ == -1 && err_ == -1) {
+                if (on_closed) on_closed();
+                return *this;
+            }
+
+            auto state = std::make_shared<drain_state_>(drain_state_{ &loop, loop.lifetime(), { std::exchange(out_, -1), std::exchange(err_, -1) }, 0, std::move(on_closed) });
+            state->open = (state->fds[0] != -1) + (state->fds[1] != -1);
+            draining_ = state;
+
+            chunk_callback callbacks[2] = { std::move(on_stdout), std::move(on_stderr) };
+            for (int i = 0; i < 2; ++i) {
+                if (state->fds[i] == -1) continue;
+                loop.watch(state->fds[i], ready_read, [state, i, fn = std::move(callbacks[i])](uint32_t) {
+                    #ifdef __unix__
+                    char buffer[65536];
+                    for (;;) {
+                        const ssize_t r = ::read(state->fds[i], buffer, sizeof(buffer));
+                        if (r > 0) {
+                            if (fn) fn(std::string_view(buffer, static_cast<std::size_t>(r)));
+                            if (static_cast<std::size_t>(r) < sizeof(buffer) || state->fds[i] == -1) return; // `fn` may have destroyed the process
+                            continue;
+                        }
+                        if (r == -1 && (errno == EAGAIN || errno == EINTR)) return;
+
+                        // EOF or error: done with this one
+                        state->loop->unwatch(state->fds[i]);
+                        close_(state->fds[i]);
+                        if (--state->open == 0 && state->on_closed) state->on_closed();
+                        return;
+                    }
+                    #endif
+                });
+            }
+            return *this;
+        }
+
+        #pragma endregion
+    };
+
+
+
     // Spawn a new process
-    class process_starter final : private types::object {
+    // @note Uses `posix_spawn`, which glibc implements with `clone(CLONE_VM | CLONE_VFORK)`:
+    //       no page tables are copied, so it stays fast from a parent with a large RSS
+    // @note The child gets an empty signal mask and default signal handlers
+    // @note The environment is `env_var`'s (plus the changes made here)
+    class process_starter final : private types::object<process_starter> {
     private:
-        // TODO: Incomplete process executor.
+        struct stream_ {
+            redirect_ kind = redirect_inherit;
+            std::string path;
+            int fd = -1;
+        };
+
+        std::string program_;
+        std::vector<std::string> args_;
+        std::vector<std::string> env_set_;   // "NAME=value"
+        std::vector<std::string> env_unset_; // "NAME"
+        bool env_clear_ = false;
+        std::string directory_;
+        bool new_group_ = false;
+        bool merge_stderr_ = false;
+        stream_ streams_[3];
+
+        static bool same_name_(const std::string_view entry, const std::string_view name) noexcept {
+            return entry.size() > name.size() && entry[name.size()] == '=' && entry.compare(0, name.size(), name) == 0;
+        }
+
+        // NULL-terminated envp: the `env_var` snapshot itself when nothing changes
+        char* const* build_env_(std::vector<char*>& storage, std::shared_ptr<char* const>& snapshot) const {
+            snapshot = env_var::envp();
+            if (!env_clear_ && env_set_.empty() && env_unset_.empty()) return snapshot.get();
+
+            storage.clear();
+            if (!env_clear_) {
+                for (char* const* e = snapshot.get(); *e; ++e) {
+                    const std::string_view entry(*e);
+                    bool replaced = false;
+                    for (const auto& s : env_set_)
+                        if (same_name_(entry, std::string_view(s).substr(0, s.find('=')))) { replaced = true; break; }
+                    for (const auto& u : env_unset_)
+                        if (!replaced && same_name_(entry, u)) { replaced = true; break; }
+                    if (!replaced) storage.push_back(*e);
+                }
+            }
+            for (const auto& s : env_set_)
+                storage.push_back(const_cast<char*>(s.c_str()));
+            storage.push_back(nullptr);
+            return storage.data();
+        }
+
+        process_starter& set_stream_(const int target, const redirect_ kind, const std::string_view path, const int fd) {
+            if ((kind == redirect_file || kind == redirect_append) && path.empty())
+                throw std::runtime_error("asl::rt::process_starter::redirect(): A file redirection needs a path.");
+            if (kind == redirect_fd && fd < 0)
+                throw std::runtime_error("asl::rt::process_starter::redirect(): Invalid fd.");
+
+            streams_[target] = { kind, std::string(path), fd };
+            if (target == 2) merge_stderr_ = false;
+            return *this;
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param program A path, or a name looked up in `PATH`
+        explicit process_starter(const std::string_view program) : program_(program) {
+            args_.emplace_back(program);
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Arguments
+
+        // Append an argument (`argv[0]` is the program already)
+        process_starter& arg(const std::string_view a) {
+            args_.emplace_back(a);
+            return *this;
+        }
+
+        process_starter& args(const std::initializer_list<std::string_view> list) {
+            for (const auto a : list) args_.emplace_back(a);
+            return *this;
+        }
+
+        // Override `argv[0]`
+        process_starter& arg0(const std::string_view name) {
+            args_[0] = std::string(name);
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Environment
+
+        // Set a variable for the child
+        process_starter& env(const std::string_view name, const std::string_view value) {
+            std::string entry;
+            entry.reserve(name.size() + value.size() + 1);
+            entry.append(name).append(1, '=').append(value);
+
+            for (auto& s : env_set_)
+                if (same_name_(s, name)) { s = std::move(entry); return *this; }
+            env_set_.push_back(std::move(entry));
+            return *this;
+        }
+
+        // Remove a variable for the child
+        process_starter& unset_env(const std::string_view name) {
+            std::erase_if(env_set_, [name](const std::string& s) { return same_name_(s, name); });
+            env_unset_.emplace_back(name);
+            return *this;
+        }
+
+        // Start from an empty environment (then only `env()` ones)
+        process_starter& clear_env() noexcept {
+            env_clear_ = true;
+            return *this;
+        }
+
+        // Run in `path`
+        process_starter& working_directory(const std::string_view path) {
+            directory_ = path;
+            return *this;
+        }
+
+        // Put the child in its own process group (e.g., to signal its whole tree)
+        process_starter& new_process_group(const bool enable = true) noexcept {
+            new_group_ = enable;
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Redirections
+
+        // @param kind Where it comes from
+        // @param path For `redirect_file` / `redirect_append`
+        process_starter& redirect_stdin(const redirect_ kind, const std::string_view path = {}) { return set_stream_(0, kind, path, -1); }
+        process_starter& redirect_stdout(const redirect_ kind, const std::string_view path = {}) { return set_stream_(1, kind, path, -1); }
+        process_starter& redirect_stderr(const redirect_ kind, const std::string_view path = {}) { return set_stream_(2, kind, path, -1); }
+
+        // Use one of our fds (not owned, must stay open until `start()`)
+        process_starter& redirect_stdin(const int fd) { return set_stream_(0, redirect_fd, {}, fd); }
+        process_starter& redirect_stdout(const int fd) { return set_stream_(1, redirect_fd, {}, fd); }
+        process_starter& redirect_stderr(const int fd) { return set_stream_(2, redirect_fd, {}, fd); }
+
+        // Send stderr wherever stdout goes (`2>&1`)
+        process_starter& merge_stderr() noexcept {
+            merge_stderr_ = true;
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Start
+
+    private:
+        process start_(const stream_ (&streams)[3]) const {
+            ASL_TRACE_SPAN("rt::process_starter::spawn");
+            #ifdef __unix__
+            process child;
+            int pipes[3][2] = { { -1, -1 }, { -1, -1 }, { -1, -1 } };
+
+            auto cleanup = [&pipes]() {
+                for (auto& p : pipes)
+                    for (int fd : p)
+                        if (fd != -1) close(fd);
+            };
+
+            posix_spawn_file_actions_t actions;
+            posix_spawnattr_t attr;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawnattr_init(&attr);
+
+            int failed = 0;
+            for (int target = 0; target < 3 && !failed; ++target) {
+                const stream_& s = streams[target];
+                if (target == 2 && merge_stderr_) {
+                    failed = posix_spawn_file_actions_adddup2(&actions, 1, 2);
+                    continue;
+                }
+
+                switch (s.kind) {
+                    case redirect_inherit:
+                        break;
+                    case redirect_pipe:
+                        if (pipe2(pipes[target], O_CLOEXEC) == -1) {
+                            failed = errno;
+                            break;
+                        }
+                        // Child end: read end for stdin, write end for the others. Ours does not block
+                        failed = posix_spawn_file_actions_adddup2(&actions, pipes[target][target == 0 ? 0 : 1], target);
+                        fcntl(pipes[target][target == 0 ? 1 : 0], F_SETFL, O_NONBLOCK);
+                        break;
+                    case redirect_null:
+                        failed = posix_spawn_file_actions_addopen(&actions, target, "/dev/null", target == 0 ? O_RDONLY : O_WRONLY, 0);
+                        break;
+                    case redirect_file:
+                    case redirect_append:
+                        failed = posix_spawn_file_actions_addopen(&actions, target, s.path.c_str(),
+                            target == 0 ? O_RDONLY : O_WRONLY | O_CREAT | (s.kind == redirect_append ? O_APPEND : O_TRUNC), 0644);
+                        break;
+                    case redirect_fd:
+                        failed = posix_spawn_file_actions_adddup2(&actions, s.fd, target);
+                        break;
+                }
+            }
+
+            if (!failed && !directory_.empty())
+                failed = posix_spawn_file_actions_addchdir_np(&actions, directory_.c_str());
+
+            // Clean signal state: `event` blocks the signals it watches, the child should not inherit that
+            sigset_t mask, defaults;
+            sigemptyset(&mask);
+            sigfillset(&defaults);
+            sigdelset(&defaults, SIGKILL);
+            sigdelset(&defaults, SIGSTOP);
+            short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+            if (new_group_) flags |= POSIX_SPAWN_SETPGROUP;
+            posix_spawnattr_setsigmask(&attr, &mask);
+            posix_spawnattr_setsigdefault(&attr, &defaults);
+            posix_spawnattr_setpgroup(&attr, 0);
+            posix_spawnattr_setflags(&attr, flags);
+
+            std::vector<char*> argv;
+            argv.reserve(args_.size() + 1);
+            for (const auto& a : args_) argv.push_back(const_cast<char*>(a.c_str()));
+            argv.push_back(nullptr);
+
+            std::vector<char*> env_storage;
+            std::shared_ptr<char* const> env_snapshot;
+            char* const* envp = build_env_(env_storage, env_snapshot);
+
+            pid_t pid = -1;
+            if (!failed) {
+                failed = program_.find('/') == std::string::npos
+                    ? posix_spawnp(&pid, program_.c_str(), &actions, &attr, argv.data(), envp)
+                    : posix_spawn(&pid, program_.c_str(), &actions, &attr, argv.data(), envp);
+            }
+
+            posix_spawn_file_actions_destroy(&actions);
+            posix_spawnattr_destroy(&attr);
+
+            if (failed) {
+                cleanup();
+                if (failed == ENOENT || failed == EACCES || failed == ENOEXEC)
+                    throw std::runtime_error("asl::rt::process_starter::start(): Cannot execute the program.");
+                throw std::runtime_error("asl::rt::process_starter::start(): posix_spawn failed.");
+            }
+
+            // Keep our ends, close the child's
+            child.pid_ = pid;
+            child.in_ = std::exchange(pipes[0][1], -1);
+            child.out_ = std::exchange(pipes[1][0], -1);
+            child.err_ = std::exchange(pipes[2][0], -1);
+            cleanup();
+            return child;
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+    public:
+
+        // Start it
+        // @note Can be called again for another process with the same settings
+        process start() const {
+            return start_(streams_);
+        }
+
+        // Start it, feed `input`, collect the output and wait
+        // @param out, err Where to append stdout / stderr (nullptr: inherit)
+        exit_status run(const std::string_view input = {}, std::string* out = nullptr, std::string* err = nullptr) const {
+            stream_ streams[3] = { streams_[0], streams_[1], streams_[2] };
+            if (!input.empty()) streams[0] = { redirect_pipe, {}, -1 };
+            if (out) streams[1] = { redirect_pipe, {}, -1 };
+            if (err) streams[2] = { redirect_pipe, {}, -1 };
+            return start_(streams).communicate(input, out, err);
+        }
+
+        #pragma endregion
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,21 +2,514 @@
 #define RT_PROCESS_STATE_HPP
 
 #include "../types/object.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
 #elif __unix__
+#include <cerrno>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 #endif
 
 namespace asl::rt {
 
+    #pragma region Enums
+    // Which /proc files a sample reads
+    // @note Use `operator|` to combine them
+    enum proc_fields_ : unsigned {
+        proc_stat   = 1,  // State, CPU times, threads, virtual size
+        proc_statm  = 2,  // Resident / shared memory
+        proc_status = 4,  // Context switches, peak RSS, swap
+        proc_io     = 8,  // I/O counters (needs the same user, or `CAP_SYS_PTRACE`)
+        proc_fds    = 16, // Open fd count
+        proc_all    = 31
+    };
+    #pragma endregion
+
+
+
+
+    // One sample of a process
+    struct process_sample {
+        int64_t timestamp_ns = 0; // `CLOCK_MONOTONIC`
+        unsigned fields = 0;      // `proc_fields_` that were read
+
+        // stat
+        char state = '?';
+        int32_t ppid = 0;
+        uint64_t user_ticks = 0;   // `clock_ticks()` per second
+        uint64_t system_ticks = 0;
+        int64_t threads = 0;
+        uint64_t start_ticks = 0;  // Since boot
+        uint64_t virtual_bytes = 0;
+
+        // statm
+        uint64_t resident_bytes = 0;
+        uint64_t shared_bytes = 0;
+
+        // status
+        uint64_t peak_resident_bytes = 0;
+        uint64_t swap_bytes = 0;
+        uint64_t voluntary_switches = 0;
+        uint64_t involuntary_switches = 0;
+
+        // io
+        uint64_t read_chars = 0;  // Through read(2) and friends, cache hits too
+        uint64_t write_chars = 0;
+        uint64_t read_syscalls = 0;
+        uint64_t write_syscalls = 0;
+        uint64_t read_bytes = 0;  // From storage
+        uint64_t write_bytes = 0;
+
+        // fd
+        uint32_t fds = 0;
+    };
+
+
+
+    // What changed between two samples, per second
+    struct process_rates {
+        double seconds = 0;         // Between the samples
+        double cpu_percent = 0;     // 100 is one core busy
+        double user_percent = 0;
+        double system_percent = 0;
+        double read_bytes = 0;      // From storage
+        double write_bytes = 0;
+        double read_chars = 0;
+        double write_chars = 0;
+        double context_switches = 0;
+    };
+
+
+
     // The current state of a process
-    class process_state final : private types::object {
+    // @note Keeps the /proc files open and re-reads them with `pread` at offset 0: no open / close and no allocation per sample
+    // @note Not thread-safe, one per sampling thread
+    class process_state final : private types::object<process_state> {
+    private:
+        pid_t pid_ = 0;
+        int stat_ = -1, statm_ = -1, status_ = -1, io_ = -1, fd_dir_ = -1;
+        unsigned fields_ = 0;
+
+        process_sample current_;
+        process_sample previous_;
+        bool has_previous_ = false;
+
+        #pragma region Parsing
+        static uint64_t page_size_() noexcept {
+            #ifdef __unix__
+            static const uint64_t size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+            return size;
+            #else
+            return 4096;
+            #endif
+        }
+
+        static const char* skip_spaces_(const char* p, const char* end) noexcept {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+            return p;
+        }
+
+        // Unsigned decimal, stops at the first non-digit
+        static const char* scan_(const char* p, const char* end, uint64_t& out) noexcept {
+            p = skip_spaces_(p, end);
+            uint64_t v = 0;
+            while (p < end && static_cast<unsigned>(*p - '0') <= 9) v = v * 10 + static_cast<unsigned>(*p++ - '0');
+            out = v;
+            return p;
+        }
+
+        static const char* scan_(const char* p, const char* end, int64_t& out) noexcept {
+            p = skip_spaces_(p, end);
+            const bool negative = p < end && *p == '-';
+            if (negative) ++p;
+            uint64_t v;
+            p = scan_(p, end, v);
+            out = negative ? -static_cast<int64_t>(v) : static_cast<int64_t>(v);
+            return p;
+        }
+
+        // Skip `count` space-separated fields
+        static const char* skip_fields_(const char* p, const char* end, unsigned count) noexcept {
+            while (count-- && p < end) {
+                p = skip_spaces_(p, end);
+                while (p < end && *p != ' ') ++p;
+            }
+            return p;
+        }
+
+        // The number after "key:" in a "key: value" file, 0 if missing
+        static uint64_t value_of_(const std::string_view texts, const std::string_view key) noexcept {
+            std::size_t at = 0;
+            while (at < texts.size()) {
+                if (texts.compare(at, key.size(), key) == 0 && at + key.size() < texts.size() && texts[at + key.size()] == ':') {
+                    uint64_t v;
+                    scan_(texts.data() + at + key.size() + 1, texts.data() + texts.size(), v);
+                    return v;
+                }
+                const std::size_t nl = texts.find('\n', at);
+                if (nl == std::string_view::npos) break;
+                at = nl + 1;
+            }
+            return 0;
+        }
+
+        // @return Bytes read, -1 if the process is gone
+        static ssize_t reread_(const int fd, char* buffer, const std::size_t size) noexcept {
+            #ifdef __unix__
+            ssize_t n;
+            while ((n = pread(fd, buffer, size - 1, 0)) == -1 && errno == EINTR) {}
+            if (n <= 0) return -1;
+            buffer[n] = '\0';
+            return n;
+            #else
+            return -1;
+            #endif
+        }
+
+        bool parse_stat_(const char* p, const char* end) noexcept {
+            // "pid (comm) state ...", comm may hold spaces and parentheses: go from the last ')'
+            const char* close = end;
+            while (close > p && *(close - 1) != ')') --close;
+            if (close == p) return false;
+            p = skip_spaces_(close, end);
+            if (p >= end) return false;
+
+            current_.state = *p++;
+            int64_t v;
+            p = scan_(p, end, v); // 4: ppid
+            current_.ppid = static_cast<int32_t>(v);
+            p = skip_fields_(p, end, 9); // 5 - 13
+            p = scan_(p, end, current_.user_ticks);   // 14
+            p = scan_(p, end, current_.system_ticks); // 15
+            p = skip_fields_(p, end, 4); // 16 - 19
+            p = scan_(p, end, current_.threads); // 20
+            p = skip_fields_(p, end, 1); // 21
+            p = scan_(p, end, current_.start_ticks);   // 22
+            scan_(p, end, current_.virtual_bytes);     // 23
+            return true;
+        }
+
+        uint32_t count_fds_() noexcept {
+            #if defined(__linux__) && defined(SYS_getdents64)
+            if (lseek(fd_dir_, 0, SEEK_SET) == -1) return 0;
+
+            // linux_dirent64: d_ino (8), d_off (8), d_reclen (2), d_type (1), d_name
+            alignas(8) char buffer[8192];
+            uint32_t count = 0;
+            for (;;) {
+                const long n = syscall(SYS_getdents64, fd_dir_, buffer, sizeof(buffer));
+                if (n <= 0) break;
+                for (long at = 0; at < n;) {
+                    unsigned short reclen;
+                    std::memcpy(&reclen, buffer + at + 16, sizeof(reclen));
+                    if (buffer[at + 19] != '.') ++count;
+                    at += reclen;
+                }
+            }
+            return count;
+            #else
+            return 0;
+            #endif
+        }
+
+        void close_all_() noexcept {
+            #ifdef __unix__
+            for (int* fd : { &stat_, &statm_, &status_, &io_, &fd_dir_ })
+                if (*fd != -1) { close(*fd); *fd = -1; }
+            #endif
+        }
+
+        static int64_t now_ns_() noexcept {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+        }
+        #pragma endregion
+
     public:
-        // TODO: Incomplete process_state
+
+        #pragma region Setups
+
+        // @param pid The process (default: 0, ourselves)
+        // @param fields Which /proc files to read, `proc_fields_` (default: all)
+        // @note Files that cannot be opened (e.g., another user's io) are left out of `fields()`
+        explicit process_state(const pid_t pid = 0, const unsigned fields = proc_all) : pid_(pid) {
+            #ifdef __linux__
+            char path[64];
+            const int base = pid ? std::snprintf(path, sizeof(path), "/proc/%d/", static_cast<int>(pid)) : std::snprintf(path, sizeof(path), "/proc/self/");
+            auto open_ = [&](const unsigned field, const char* name, const int flags) {
+                if (!(fields & field)) return -1;
+                std::snprintf(path + base, sizeof(path) - static_cast<std::size_t>(base), "%s", name);
+                const int fd = open(path, flags | O_CLOEXEC);
+                if (fd != -1) fields_ |= field;
+                return fd;
+            };
+
+            stat_ = open_(proc_stat, "stat", O_RDONLY);
+            if (stat_ == -1 && (fields & proc_stat))
+                throw std::runtime_error("asl::rt::process_state::process_state(): No such process.");
+            statm_ = open_(proc_statm, "statm", O_RDONLY);
+            status_ = open_(proc_status, "status", O_RDONLY);
+            io_ = open_(proc_io, "io", O_RDONLY);
+            fd_dir_ = open_(proc_fds, "fd", O_RDONLY | O_DIRECTORY);
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        process_state(const process_state&) = delete;
+        process_state& operator=(const process_state&) = delete;
+
+        process_state(process_state&& other) noexcept :
+            pid_(other.pid_), stat_(std::exchange(other.stat_, -1)), statm_(std::exchange(other.statm_, -1)),
+            status_(std::exchange(other.status_, -1)), io_(std::exchange(other.io_, -1)), fd_dir_(std::exchange(other.fd_dir_, -1)),
+            fields_(other.fields_), current_(other.current_), previous_(other.previous_), has_previous_(other.has_previous_) {}
+
+        process_state& operator=(process_state&& other) noexcept {
+            if (this != &other) {
+                close_all_();
+                pid_ = other.pid_;
+                stat_ = std::exchange(other.stat_, -1);
+                statm_ = std::exchange(other.statm_, -1);
+                status_ = std::exchange(other.status_, -1);
+                io_ = std::exchange(other.io_, -1);
+                fd_dir_ = std::exchange(other.fd_dir_, -1);
+                fields_ = other.fields_;
+                current_ = other.current_;
+                previous_ = other.previous_;
+                has_previous_ = other.has_previous_;
+            }
+            return *this;
+        }
+
+        ~process_state() {
+            close_all_();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Sample
+
+        // Take a new sample (the last one becomes `previous()`)
+        // @return False if the process is gone
+        bool sample() noexcept {
+            if (current_.fields) {
+                previous_ = current_;
+                has_previous_ = true;
+            }
+
+            char buffer[4096];
+            process_sample& s = current_;
+            s.timestamp_ns = now_ns_();
+            s.fields = 0;
+
+            if (stat_ != -1) {
+                const ssize_t n = reread_(stat_, buffer, sizeof(buffer));
+                if (n < 0 || !parse_stat_(buffer, buffer + n)) return false;
+                s.fields |= proc_stat;
+            }
+
+            if (statm_ != -1) {
+                const ssize_t n = reread_(statm_, buffer, sizeof(buffer));
+                if (n < 0) return false;
+                uint64_t pages;
+                const char* p = scan_(buffer, buffer + n, pages); // size
+                p = scan_(p, buffer + n, pages);                   // resident
+                s.resident_bytes = pages * page_size_();
+                scan_(p, buffer + n, pages);                       // shared
+                s.shared_bytes = pages * page_size_();
+                s.fields |= proc_statm;
+            }
+
+            if (status_ != -1) {
+                const ssize_t n = reread_(status_, buffer, sizeof(buffer));
+                if (n < 0) return false;
+                const std::string_view texts(buffer, static_cast<std::size_t>(n));
+                s.peak_resident_bytes = value_of_(texts, "VmHWM") * 1024;
+                s.swap_bytes = value_of_(texts, "VmSwap") * 1024;
+                s.voluntary_switches = value_of_(texts, "voluntary_ctxt_switches");
+                s.involuntary_switches = value_of_(texts, "nonvoluntary_ctxt_switches");
+                s.fields |= proc_status;
+            }
+
+            if (io_ != -1) {
+                const ssize_t n = reread_(io_, buffer, sizeof(buffer));
+                if (n >= 0) {
+                    const std::string_view texts(buffer, static_cast<std::size_t>(n));
+                    s.read_chars = value_of_(texts, "rchar");
+                    s.write_chars = value_of_(texts, "wchar");
+                    s.read_syscalls = value_of_(texts, "syscr");
+                    s.write_syscalls = value_of_(texts, "syscw");
+                    s.read_bytes = value_of_(texts, "read_bytes");
+                    s.write_bytes = value_of_(texts, "write_bytes");
+                    s.fields |= proc_io;
+                }
+            }
+
+            if (fd_dir_ != -1) {
+                s.fds = count_fds_();
+                s.fields |= proc_fds;
+            }
+            return true;
+        }
+
+        // What changed between `previous()` and `current()`
+        // @note All zeros until there are two samples
+        process_rates rates() const noexcept {
+            return has_previous_ ? rates(previous_, current_) : process_rates{};
+        }
+
+        // What changed between two samples
+        static process_rates rates(const process_sample& before, const process_sample& after) noexcept {
+            process_rates r;
+            r.seconds = static_cast<double>(after.timestamp_ns - before.timestamp_ns) / 1e9;
+            if (r.seconds <= 0) return r;
+
+            auto per_second = [&r](const uint64_t a, const uint64_t b) {
+                return b >= a ? static_cast<double>(b - a) / r.seconds : 0.0;
+            };
+
+            const double tick_percent = 100.0 / static_cast<double>(clock_ticks());
+            r.user_percent = per_second(before.user_ticks, after.user_ticks) * tick_percent;
+            r.system_percent = per_second(before.system_ticks, after.system_ticks) * tick_percent;
+            r.cpu_percent = r.user_percent + r.system_percent;
+            r.read_bytes = per_second(before.read_bytes, after.read_bytes);
+            r.write_bytes = per_second(before.write_bytes, after.write_bytes);
+            r.read_chars = per_second(before.read_chars, after.read_chars);
+            r.write_chars = per_second(before.write_chars, after.write_chars);
+            r.context_switches = per_second(before.voluntary_switches + before.involuntary_switches, after.voluntary_switches + after.involuntary_switches);
+            return r;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        const process_sample& current() const noexcept {
+            return current_;
+        }
+
+        const process_sample& previous() const noexcept {
+            return previous_;
+        }
+
+        pid_t pid() const noexcept {
+            return pid_;
+        }
+
+        // `proc_fields_` that could be opened
+        unsigned fields() const noexcept {
+            return fields_;
+        }
+
+        // CPU time ticks per second (`_SC_CLK_TCK`)
+        static uint64_t clock_ticks() noexcept {
+            #ifdef __unix__
+            static const uint64_t ticks = static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+            return ticks;
+            #else
+            return 100;
+            #endif
+        }
+
+        #pragma endregion
+    };
+
+
+
+    // Samples many processes at once
+    // @note Processes that are gone are dropped on `sample()`
+    class process_sampler final : private types::object<process_sampler> {
+    private:
+        std::vector<process_state> states_;
+        unsigned fields_;
+
+    public:
+
+        #pragma region Setups
+
+        // @param fields Which /proc files to read for each process, `proc_fields_` (default: all)
+        explicit process_sampler(const unsigned fields = proc_all) : fields_(fields) {}
+
+        process_sampler(const process_sampler&) = delete;
+        process_sampler& operator=(const process_sampler&) = delete;
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Processes
+
+        // Start sampling `pid`
+        // @return False if there is no such process
+        bool add(const pid_t pid) {
+            for (const auto& s : states_)
+                if (s.pid() == pid) return true;
+            try {
+                states_.emplace_back(pid, fields_);
+            } catch (const std::runtime_error&) {
+                return false;
+            }
+            return true;
+        }
+
+        process_sampler& remove(const pid_t pid) {
+            std::erase_if(states_, [pid](const process_state& s) { return s.pid() == pid; });
+            return *this;
+        }
+
+        // Sample every process
+        // @param gone Called with each pid that exited since the last call (optional)
+        // @return How many are still there
+        std::size_t sample(const std::function<void(pid_t)>& gone = nullptr) {
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < states_.size(); ++i) {
+                if (!states_[i].sample()) {
+                    if (gone) gone(states_[i].pid());
+                    continue;
+                }
+                if (kept != i) std::swap(states_[kept], states_[i]);
+                ++kept;
+            }
+            states_.erase(states_.begin() + static_cast<std::ptrdiff_t>(kept), states_.end());
+            return kept;
+        }
+
+        // Visit each process state
+        template<typename Fn>
+        void for_each(Fn&& fn) const {
+            for (const auto& s : states_) fn(s);
+        }
+
+        std::size_t size() const noexcept {
+            return states_.size();
+        }
+
+        #pragma endregion
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,212 @@
+#ifndef RT_PROCESS_SUPERVISOR_HPP
+#define RT_PROCESS_SUPERVISOR_HPP
+
+#include "../types/object.hpp"
+#include "./event.hpp"
+#include "./process_starter.hpp"
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+namespace asl::rt {
+
+    // Tells when children exit, from an event loop
+    // @note One `pidfd` per child watched by epoll: no thread and no `waitpid` per child, so thousands are fine
+    // @note Falls back to `SIGCHLD` (through the loop's signalfd) + `waitpid(WNOHANG)` on kernels without `pidfd_open` (< 5.3)
+    // @note Lives on the loop thread, like `event` itself
+    class process_supervisor final : private types::object<process_supervisor> {
+    public:
+        // Called on the loop thread once the child was reaped
+        using exit_callback = std::function<void(pid_t, exit_status)>;
+
+    private:
+        struct child_ {
+            int pidfd = -1;
+            exit_callback callback;
+        };
+
+        event& loop_;
+        std::unordered_map<pid_t, child_> children_;
+        bool pidfd_ = false;
+        std::shared_ptr<bool> alive_ = std::make_shared<bool>(true); // Cleared on destruction, for tasks still posted to the loop
+
+        #ifdef __linux__
+        static int pidfd_open_(const pid_t pid) noexcept {
+            #ifdef SYS_pidfd_open
+            return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+            #else
+            errno = ENOSYS;
+            return -1;
+            #endif
+        }
+        #endif
+
+        // Reap `pid` if it ended, then report it
+        // @return False if it is still running
+        bool reap_(const pid_t pid) {
+            #ifdef __linux__
+            int status;
+            pid_t r;
+            while ((r = waitpid(pid, &status, WNOHANG)) == -1 && errno == EINTR) {}
+            if (r == 0) return false;
+
+            const exit_status result = r == pid ? exit_status::from_wait(status) : exit_status{}; // -1: someone else reaped it
+
+            const auto it = children_.find(pid);
+            if (it == children_.end()) return true;
+            child_ child = std::move(it->second);
+            children_.erase(it);
+
+            if (child.pidfd != -1) {
+                loop_.unwatch(child.pidfd);
+                close(child.pidfd);
+            }
+            if (child.callback) child.callback(pid, result);
+            #endif
+            return true;
+        }
+
+        // SIGCHLD coalesces, so any number of children may have ended
+        void on_sigchld_() {
+            #ifdef __linux__
+            std::vector<pid_t> ended;
+            for (;;) {
+                siginfo_t info{};
+                if (waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) == -1 || info.si_pid == 0) break;
+                if (!children_.contains(info.si_pid)) {
+                    // Not ours, we must not reap it: look at ours one by one instead
+                    ended.clear();
+                    for (const auto& [pid, child] : children_) ended.push_back(pid);
+                    for (const pid_t pid : ended) reap_(pid);
+                    return;
+                }
+                reap_(info.si_pid);
+            }
+            #endif
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param loop The loop to report exits from (must outlive the supervisor)
+        explicit process_supervisor(event& loop) : loop_(loop) {
+            #ifdef __linux__
+            const int probe = pidfd_open_(getpid());
+            pidfd_ = probe != -1;
+            if (pidfd_) close(probe);
+            else loop_.on_signal(SIGCHLD, [this](const signalfd_siginfo&) { on_sigchld_(); });
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        process_supervisor(const process_supervisor&) = delete;
+        process_supervisor& operator=(const process_supervisor&) = delete;
+
+        // Stops watching, does not reap what is left
+        ~process_supervisor() {
+            *alive_ = false;
+
+            #ifdef __linux__
+            if (!pidfd_) {
+                try { loop_.off_signal(SIGCHLD); } catch (...) {} // The callback is gone either way
+            }
+            for (auto& [pid, child] : children_) {
+                if (child.pidfd == -1) continue;
+                loop_.unwatch(child.pidfd);
+                close(child.pidfd);
+            }
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Watch
+
+        // Reap `pid` once it exits and call `callback`
+        // @param pid A child of ours, not reaped yet
+        process_supervisor& watch(const pid_t pid, exit_callback callback) {
+            #ifdef __linux__
+            if (children_.contains(pid))
+                throw std::runtime_error("asl::rt::process_supervisor::watch(): Already watched.");
+
+            child_& child = children_[pid];
+            child.callback = std::move(callback);
+
+            if (pidfd_) {
+                child.pidfd = pidfd_open_(pid);
+                if (child.pidfd == -1) {
+                    children_.erase(pid);
+                    throw std::runtime_error("asl::rt::process_supervisor::watch(): pidfd_open failed.");
+                }
+                loop_.watch(child.pidfd, ready_read, [this, pid](uint32_t) { reap_(pid); });
+            } else {
+                // It may have ended before we were listening
+                loop_.post([this, pid, alive = alive_]() { if (*alive) reap_(pid); });
+            }
+            #endif
+            return *this;
+        }
+
+        // Same, and record the exit in `p` (which must outlive the watch)
+        process_supervisor& watch(process& p, exit_callback callback = nullptr) {
+            return watch(p.pid(), [&p, callback = std::move(callback)](const pid_t pid, const exit_status status) {
+                p.mark_reaped(status);
+                if (callback) callback(pid, status);
+            });
+        }
+
+        // Stop watching `pid` (it is not reaped then)
+        process_supervisor& unwatch(const pid_t pid) {
+            const auto it = children_.find(pid);
+            if (it == children_.end()) return *this;
+
+            #ifdef __linux__
+            if (it->second.pidfd != -1) {
+                loop_.unwatch(it->second.pidfd);
+                close(it->second.pidfd);
+            }
+            #endif
+            children_.erase(it);
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        // Children being watched
+        std::size_t size() const noexcept {
+            return children_.size();
+        }
+
+        // Whether exits come through pidfds (or through `SIGCHLD`)
+        bool uses_pidfd() const noexcept {
+            return pidfd_;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
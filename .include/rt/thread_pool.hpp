@@ -0,0 +1,479 @@
+#ifndef RT_THREAD_POOL_HPP
+#define RT_THREAD_POOL_HPP
+
+#include "../types/object.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace asl::rt {
+
+    #pragma region Internal
+    namespace _internal {
+
+        // One unit of work: a function pointer and whatever derives from it, no allocation needed
+        // @note Fork / join jobs live on the stack of the frame that forked them
+        struct job {
+            void (*run)(job*) = nullptr;
+            std::atomic<bool> done{false};
+            std::exception_ptr error;
+            std::atomic<std::uint32_t>* wake = nullptr; // Bumped and notified after `done`, for a waiter that sleeps (it outlives the job)
+        };
+
+        // A job calling `f()` once, keeping what it throws
+        template<typename F>
+        struct call_job final : job {
+            F* f;
+
+            explicit call_job(F& function) noexcept : f(&function) {
+                run = [](job* self) {
+                    auto* me = static_cast<call_job*>(self);
+                    try {
+                        (*me->f)();
+                    } catch (...) {
+                        me->error = std::current_exception();
+                    }
+                    // The waiter may end the job's lifetime as soon as it sees `done`: nothing of it is touched after
+                    std::atomic<std::uint32_t>* wake = me->wake;
+                    me->done.store(true, std::memory_order_release);
+                    if (wake) {
+                        wake->fetch_add(1, std::memory_order_release);
+                        wake->notify_all();
+                    }
+                };
+            }
+        };
+
+        // A fire-and-forget job, it deletes itself
+        struct posted_job final : job {
+            std::function<void()> f;
+
+            explicit posted_job(std::function<void()>&& function) noexcept : f(std::move(function)) {
+                run = [](job* self) {
+                    std::unique_ptr<posted_job> me(static_cast<posted_job*>(self));
+                    me->f();
+                };
+            }
+        };
+
+        inline void pause() noexcept {
+            #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+            #elif defined(__aarch64__)
+            asm volatile("yield");
+            #endif
+        }
+
+        // Chase-Lev work-stealing deque (with the memory orders of Le et al., PPoPP 2013)
+        // @note The owner pushes / pops at the bottom, thieves take from the top
+        // @note Grows, never shrinks: old rings stay alive until the deque dies, a thief may still be reading one
+        class work_deque {
+            struct ring {
+                std::int64_t mask;
+                std::unique_ptr<std::atomic<job*>[]> slots;
+
+                explicit ring(const std::int64_t size) : mask(size - 1), slots(new std::atomic<job*>[static_cast<std::size_t>(size)]) {}
+
+                job* get(const std::int64_t i) const noexcept {
+                    return slots[static_cast<std::size_t>(i & mask)].load(std::memory_order_relaxed);
+                }
+
+                void put(const std::int64_t i, job* j) noexcept {
+                    slots[static_cast<std::size_t>(i & mask)].store(j, std::memory_order_relaxed);
+                }
+            };
+
+            alignas(64) std::atomic<std::int64_t> top_{0};
+            alignas(64) std::atomic<std::int64_t> bottom_{0};
+            std::atomic<ring*> ring_;
+            std::vector<std::unique_ptr<ring>> rings_; // Owner only
+
+            ring* grow_(ring* old, const std::int64_t top, const std::int64_t bottom) {
+                auto bigger = std::make_unique<ring>((old->mask + 1) * 2);
+                for (std::int64_t i = top; i < bottom; ++i) bigger->put(i, old->get(i));
+                ring* r = bigger.get();
+                rings_.push_back(std::move(bigger));
+                ring_.store(r, std::memory_order_release);
+                return r;
+            }
+
+        public:
+            explicit work_deque(const std::int64_t size = 256) {
+                rings_.push_back(std::make_unique<ring>(size));
+                ring_.store(rings_.back().get(), std::memory_order_relaxed);
+            }
+
+            work_deque(const work_deque&) = delete;
+            work_deque& operator=(const work_deque&) = delete;
+
+            // Owner only
+            void push(job* j) {
+                const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+                const std::int64_t t = top_.load(std::memory_order_acquire);
+                ring* r = ring_.load(std::memory_order_relaxed);
+                if (b - t > r->mask) r = grow_(r, t, b);
+                r->put(b, j);
+                bottom_.store(b + 1, std::memory_order_release); // The paper's release fence, folded into the store
+            }
+
+            // Owner only
+            // @return The last pushed job, or nullptr
+            job* pop() noexcept {
+                const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                ring* r = ring_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::int64_t t = top_.load(std::memory_order_relaxed);
+
+                if (t > b) {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                job* j = r->get(b);
+                if (t == b) {
+                    // The last one: race the thieves for it
+                    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) j = nullptr;
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+                return j;
+            }
+
+            // Any thread
+            // @return The oldest job, or nullptr (empty, or another thief won)
+            job* steal() noexcept {
+                std::int64_t t = top_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::int64_t b = bottom_.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+
+                job* j = ring_.load(std::memory_order_acquire)->get(t);
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+                return j;
+            }
+        };
+    }
+    #pragma endregion
+
+
+
+
+
+    // Work-stealing thread pool: one Chase-Lev deque per worker, idle workers steal from the others
+    // @note Jobs forked from a worker go to its own deque (no lock, no allocation with `invoke()`), the rest goes through a locked injection queue
+    // @note Idle workers spin a little, then sleep on a futex; a push only wakes one when some are asleep
+    // @note `shared()` is the one pool meant to be used by everything, rather than ad-hoc `std::thread`s
+    class thread_pool final : private types::object<thread_pool> {
+        struct worker_ {
+            _internal::work_deque deque;
+            std::thread thread;
+            std::uint64_t seed;
+        };
+
+        struct current_ {
+            const thread_pool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        static current_& current_worker_() noexcept {
+            static thread_local current_ current;
+            return current;
+        }
+
+        std::vector<std::unique_ptr<worker_>> workers_;
+        std::mutex inject_mutex_;
+        std::deque<_internal::job*> injected_;
+        std::atomic<std::size_t> injected_count_{0};
+
+        alignas(64) std::atomic<std::uint32_t> epoch_{0};
+        alignas(64) std::atomic<std::uint32_t> finished_{0}; // Futex of threads waiting from outside, see `run_outside_()`
+        std::atomic<std::uint32_t> sleepers_{0};
+        std::atomic<bool> stopping_{false};
+
+        static constexpr int spins_ = 64;
+
+        // Wake one sleeping worker, if any (the fence pairs with the one in `idle_()`)
+        void wake_() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_one();
+        }
+
+        void inject_(_internal::job* j) {
+            {
+                std::lock_guard lock(inject_mutex_);
+                injected_.push_back(j);
+                injected_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+            wake_();
+        }
+
+        _internal::job* take_injected_() {
+            if (injected_count_.load(std::memory_order_relaxed) == 0) return nullptr;
+            std::lock_guard lock(inject_mutex_);
+            if (injected_.empty()) return nullptr;
+            _internal::job* j = injected_.front();
+            injected_.pop_front();
+            injected_count_.fetch_sub(1, std::memory_order_relaxed);
+            return j;
+        }
+
+        // Steal from the others, starting at a random one
+        _internal::job* steal_(const std::size_t self) noexcept {
+            const std::size_t n = workers_.size();
+            if (n < 2) return nullptr;
+
+            std::uint64_t& seed = workers_[self]->seed;
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+
+            const std::size_t first = static_cast<std::size_t>(seed % n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t victim = (first + i) % n;
+                if (victim == self) continue;
+                if (_internal::job* j = workers_[victim]->deque.steal()) return j;
+            }
+            return nullptr;
+        }
+
+        _internal::job* find_(const std::size_t self) {
+            if (_internal::job* j = workers_[self]->deque.pop()) return j;
+            if (_internal::job* j = take_injected_()) return j;
+            return steal_(self);
+        }
+
+        // Sleep until something gets pushed
+        // @return False when the pool stops
+        bool idle_(const std::size_t self, _internal::job*& found) {
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+
+            // Anything pushed before the increment above is seen here, anything after wakes us up
+            found = find_(self);
+            if (!found) {
+                if (stopping_.load(std::memory_order_acquire)) {
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    return false;
+                }
+                epoch_.wait(epoch, std::memory_order_acquire);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        void work_loop_(const std::size_t self) {
+            current_worker_() = { this, self };
+
+            while (true) {
+                _internal::job* j = nullptr;
+                for (int i = 0; i < spins_ && !j; ++i) {
+                    j = find_(self);
+                    if (!j) _internal::pause();
+                }
+                if (!j && !idle_(self, j)) return;
+                if (j) j->run(j);
+            }
+        }
+
+        #ifdef __linux__
+        // Pin worker `i` to the i-th CPU this process may run on
+        static void pin_(std::thread& thread, const std::size_t i) noexcept {
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+
+            const int count = CPU_COUNT(&allowed);
+            if (count == 0) return;
+
+            std::size_t wanted = i % static_cast<std::size_t>(count);
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (!CPU_ISSET(cpu, &allowed)) continue;
+                if (wanted-- != 0) continue;
+
+                cpu_set_t one;
+                CPU_ZERO(&one);
+                CPU_SET(cpu, &one);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(one), &one);
+                return;
+            }
+        }
+        #endif
+
+        // Run `j` on the pool from outside of it and wait
+        void run_outside_(_internal::job& j) {
+            j.wake = &finished_;
+            inject_(&j);
+            while (true) {
+                const std::uint32_t seen = finished_.load(std::memory_order_acquire);
+                if (j.done.load(std::memory_order_acquire)) return;
+                finished_.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        // Wait for `j` from a worker of this pool, stealing work in the meantime
+        void wait_inside_(_internal::job& j, const std::size_t self) {
+            int misses = 0;
+            while (!j.done.load(std::memory_order_acquire)) {
+                _internal::job* other = steal_(self);
+                if (!other) other = take_injected_();
+                if (other) {
+                    other->run(other);
+                    misses = 0;
+                } else if (++misses < 1024) _internal::pause();
+                else std::this_thread::yield();
+            }
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param threads How many workers (default: one per hardware thread)
+        // @param pin Pin worker i to the i-th CPU of the process' affinity mask (default: false)
+        explicit thread_pool(std::size_t threads = 0, const bool pin = false) {
+            if (threads == 0) threads = std::thread::hardware_concurrency();
+            if (threads == 0) threads = 1;
+
+            workers_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers_.push_back(std::make_unique<worker_>());
+                workers_.back()->seed = 0x9E3779B97F4A7C15ull * (i + 1);
+            }
+
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers_[i]->thread = std::thread([this, i] { work_loop_(i); });
+                #ifdef __linux__
+                if (pin) pin_(workers_[i]->thread, i);
+                #else
+                (void)pin;
+                #endif
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // Runs what was posted, then joins the workers
+        ~thread_pool() {
+            stopping_.store(true, std::memory_order_release);
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+            for (auto& w : workers_) w->thread.join();
+        }
+
+        // The pool shared by the whole process (one worker per hardware thread, started on first use)
+        static thread_pool& shared() {
+            static thread_pool pool;
+            return pool;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        // Workers
+        std::size_t size() const noexcept {
+            return workers_.size();
+        }
+
+        // Whether the calling thread is one of our workers
+        bool on_worker() const noexcept {
+            return current_worker_().pool == this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Run
+
+        // Run `f()` on some worker, without waiting
+        // @note It must not throw (that ends the program)
+        thread_pool& post(std::function<void()> f) {
+            auto* j = new _internal::posted_job(std::move(f));
+            const current_& current = current_worker_();
+            if (current.pool == this) {
+                workers_[current.index]->deque.push(j);
+                wake_();
+            } else inject_(j);
+            return *this;
+        }
+
+        // Run `a()` and `b()`, maybe in parallel, and return once both are done
+        // @note From a worker, `b` is pushed to its deque for others to steal, and `a` runs right away: nested calls split work recursively
+        // @note If either throws, the other is still waited for, then the exception goes on (`a`'s first)
+        template<typename A, typename B>
+        void invoke(A&& a, B&& b) {
+            const current_& current = current_worker_();
+            if (current.pool != this) {
+                // Outside: become a job of the pool first
+                auto both = [&] { invoke(a, b); };
+                _internal::call_job<decltype(both)> root(both);
+                run_outside_(root);
+                if (root.error) std::rethrow_exception(root.error);
+                return;
+            }
+
+            const std::size_t self = current.index;
+            _internal::call_job<std::remove_reference_t<B>> forked(b);
+            worker_& me = *workers_[self];
+            me.deque.push(&forked);
+            wake_();
+
+            std::exception_ptr error;
+            try {
+                a();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // Nobody took it: run it here. Only what `a` posted can sit above it in the deque (LIFO), run that on the way
+            while (!forked.done.load(std::memory_order_acquire)) {
+                _internal::job* j = me.deque.pop();
+                if (!j) break;
+                j->run(j);
+            }
+            wait_inside_(forked, self);
+
+            if (error) std::rethrow_exception(error);
+            if (forked.error) std::rethrow_exception(forked.error);
+        }
+
+        // Run `f()` on the pool and wait for it (inline when already on one of its workers)
+        template<typename F>
+        void run(F&& f) {
+            if (on_worker()) {
+                f();
+                return;
+            }
+            _internal::call_job<std::remove_reference_t<F>> root(f);
+            run_outside_(root);
+            if (root.error) std::rethrow_exception(root.error);
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
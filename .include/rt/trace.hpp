@@ -0,0 +1,491 @@
+#ifndef RT_TRACE_HPP
+#define RT_TRACE_HPP
+
+#include "../types/object.hpp"
+#include "../fs/mapping.hpp"
+#include "../tm/real_clock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+
+// Tracing: spans, counters and instants, recorded in per-thread buffers and drained into a ring file
+// @note Opt-in: define ASL_TRACE (or configure with -DASL_TRACE=ON), otherwise the macros are no-ops (see `trace_points.hpp`)
+// @note `name` must be a string literal (only its address is recorded)
+#ifdef ASL_TRACE
+#define ASL_TRACE_CONCAT_(a, b) a##b
+#define ASL_TRACE_CONCAT(a, b) ASL_TRACE_CONCAT_(a, b)
+
+// Time spent from here until the end of the enclosing scope
+#define ASL_TRACE_SPAN(name) const ::asl::rt::trace::_internal::span ASL_TRACE_CONCAT(asl_trace_span_, __LINE__)(name)
+// A value over time (e.g., queue length), `value` is only evaluated while recording
+#define ASL_TRACE_COUNTER(name, value) (::asl::rt::trace::_internal::recording.load(::std::memory_order_relaxed) \
+    ? ::asl::rt::trace::_internal::record(::asl::rt::trace::_internal::kind_counter, name, ::asl::tm::real_clock::cycles(), static_cast<int64_t>(value)) : void())
+// A point in time
+#define ASL_TRACE_INSTANT(name) (::asl::rt::trace::_internal::recording.load(::std::memory_order_relaxed) \
+    ? ::asl::rt::trace::_internal::record(::asl::rt::trace::_internal::kind_instant, name, ::asl::tm::real_clock::cycles(), 0) : void())
+#else
+#include "./trace_points.hpp"
+#endif
+
+
+namespace asl::rt::trace {
+
+    #ifdef ASL_TRACE
+    inline constexpr bool enabled = true;
+    #else
+    inline constexpr bool enabled = false;
+    #endif
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal {
+        enum kind_ : uint32_t {
+            kind_span,
+            kind_counter,
+            kind_instant
+        };
+
+
+
+        #pragma region Ring file
+        // Layout: header (1 page), then the name table, then the events ring
+        // @note Plain data, so a file left by a crashed process can still be read
+        inline constexpr char magic[8] = { 'A', 'S', 'L', 'T', 'R', 'A', 'C', 'E' };
+        inline constexpr uint32_t file_version = 1;
+        inline constexpr std::size_t header_bytes = 4096;
+        inline constexpr std::size_t name_bytes = 64;
+        inline constexpr uint32_t name_slots = 4096; // The last one stands for all names past it
+
+        struct file_header {
+            char magic[8];
+            uint32_t version;
+            uint32_t pid;
+            uint64_t capacity;              // Events the ring holds
+            std::atomic<uint64_t> written;  // Events written since the start, the ring keeps the last `capacity`
+            std::atomic<uint32_t> names;    // Name slots in use
+            uint32_t reserved;
+            std::atomic<uint64_t> dropped;  // Events lost to full thread buffers
+        };
+
+        struct file_event {
+            int64_t ns;     // CLOCK_MONOTONIC
+            int64_t value;  // Span: duration (ns), counter: value
+            uint32_t name;
+            uint32_t tid;
+            uint32_t kind;
+            uint32_t reserved;
+        };
+
+        static_assert(sizeof(file_header) <= header_bytes);
+        static_assert(sizeof(file_event) == 32);
+
+        inline constexpr std::size_t events_offset = header_bytes + name_slots * name_bytes;
+        #pragma endregion
+
+
+
+        #pragma region Thread buffers
+        struct event {
+            uint64_t cycles;
+            int64_t value;
+            const char* name;
+            kind_ kind;
+            uint32_t session; // Which `start()` it belongs to
+        };
+
+        // Single producer (its thread), single consumer (the drainer), lock-free
+        // @note Full: the event is dropped, the thread never waits
+        struct thread_buffer {
+            static constexpr std::size_t capacity = 1 << 14;
+
+            alignas(64) std::atomic<uint64_t> head{ 0 }; // Written by the owner
+            uint64_t tail_seen = 0;                       // Owner's copy of `tail`, refreshed when the buffer looks full
+            uint64_t dropped = 0;
+
+            alignas(64) std::atomic<uint64_t> tail{ 0 }; // Written by the drainer
+            std::atomic<uint64_t> dropped_seen{ 0 };
+            std::atomic<bool> retired{ false };           // Its thread exited
+            uint32_t tid = 0;
+
+            event events[capacity];
+
+            bool push(const event& e) noexcept {
+                const uint64_t h = head.load(std::memory_order_relaxed);
+                if (h - tail_seen == capacity) {
+                    tail_seen = tail.load(std::memory_order_acquire);
+                    if (h - tail_seen == capacity) {
+                        ++dropped;
+                        return false;
+                    }
+                }
+                events[h & (capacity - 1)] = e;
+                head.store(h + 1, std::memory_order_release);
+                return true;
+            }
+        };
+
+        // Buffers outlive their threads until drained, and the registry outlives everything
+        struct registry_ {
+            std::mutex lock;
+            std::vector<thread_buffer*> buffers;
+        };
+
+        inline registry_& registry() {
+            static registry_* r = new registry_;
+            return *r;
+        }
+
+        struct thread_handle {
+            thread_buffer* buffer = nullptr;
+
+            thread_buffer* get() {
+                if (!buffer) {
+                    buffer = new thread_buffer;
+                    #ifdef __linux__
+                    buffer->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+                    #endif
+                    registry_& r = registry();
+                    const std::lock_guard guard(r.lock);
+                    r.buffers.push_back(buffer);
+                }
+                return buffer;
+            }
+
+            ~thread_handle() {
+                if (buffer) buffer->retired.store(true, std::memory_order_release);
+            }
+        };
+
+        inline std::atomic<bool> recording{ false };
+
+        // Bumped by each `start()` (before `recording` is set). A writer that saw `recording` just before `stop()` may still push,
+        // its events carry the old session and the next one skips them
+        inline std::atomic<uint32_t> session_id{ 0 };
+
+        inline void push(const uint32_t session, const kind_ kind, const char* name, const uint64_t cycles, const int64_t value) noexcept {
+            static thread_local thread_handle handle;
+            try {
+                handle.get()->push({ cycles, value, name, kind, session });
+            } catch (...) {} // No memory for a buffer: not traced
+        }
+
+        inline void record(const kind_ kind, const char* name, const uint64_t cycles, const int64_t value) noexcept {
+            if (!recording.load(std::memory_order_acquire)) return;
+            push(session_id.load(std::memory_order_relaxed), kind, name, cycles, value);
+        }
+
+        class span final : private types::object<span> {
+        private:
+            const char* name_;
+            uint64_t start_ = 0;
+            uint32_t session_ = 0;
+
+        public:
+            explicit span(const char* name) noexcept : name_(name) {
+                if (recording.load(std::memory_order_acquire)) {
+                    session_ = session_id.load(std::memory_order_relaxed);
+                    start_ = tm::real_clock::cycles();
+                }
+            }
+
+            span(const span&) = delete;
+            span& operator=(const span&) = delete;
+
+            // A span that outlived its session is dropped
+            ~span() {
+                if (start_ && recording.load(std::memory_order_relaxed)) {
+                    const uint64_t end = tm::real_clock::cycles();
+                    push(session_, kind_span, name_, start_, static_cast<int64_t>(end - start_));
+                }
+            }
+        };
+        #pragma endregion
+
+
+
+        #pragma region Session
+        struct session_ {
+            std::mutex lock; // `start()` / `stop()`
+
+            fs::mapping file;
+            file_header* header = nullptr;
+            char* names = nullptr;
+            file_event* events = nullptr;
+            std::unordered_map<const char*, uint32_t> ids;
+            uint32_t id = 0; // `session_id` of this one
+
+            std::thread drainer;
+            std::mutex wake_lock;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::chrono::milliseconds every{ 10 };
+
+            uint32_t id_of(const char* name) {
+                const auto found = ids.find(name);
+                if (found != ids.end()) return found->second;
+
+                uint32_t id = header->names.load(std::memory_order_relaxed);
+                if (id >= name_slots - 1) {
+                    id = name_slots - 1;
+                    if (header->names.load(std::memory_order_relaxed) != name_slots) {
+                        std::strncpy(names + id * name_bytes, "(more names)", name_bytes - 1);
+                        header->names.store(name_slots, std::memory_order_release);
+                    }
+                    ids.emplace(name, id);
+                    return id;
+                }
+
+                std::strncpy(names + id * name_bytes, name, name_bytes - 1); // The slot is zeroed, so it stays terminated
+                header->names.store(id + 1, std::memory_order_release);
+                ids.emplace(name, id);
+                return id;
+            }
+
+            // Move everything buffered into the ring, free the buffers of exited threads
+            void drain() {
+                const uint64_t now_cycles = tm::real_clock::cycles();
+                const int64_t now_ns = tm::real_clock::now().time_since_epoch().count();
+                const auto to_ns = [&](const uint64_t cycles) {
+                    return cycles <= now_cycles ? now_ns - tm::real_clock::to_nanoseconds(now_cycles - cycles).count()
+                                                : now_ns + tm::real_clock::to_nanoseconds(cycles - now_cycles).count();
+                };
+
+                uint64_t written = header->written.load(std::memory_order_relaxed);
+                registry_& r = registry();
+                const std::lock_guard guard(r.lock);
+
+                std::erase_if(r.buffers, [&](thread_buffer* b) {
+                    const uint64_t head = b->head.load(std::memory_order_acquire);
+                    uint64_t tail = b->tail.load(std::memory_order_relaxed);
+
+                    for (; tail != head; ++tail) {
+                        const event& e = b->events[tail & (thread_buffer::capacity - 1)];
+                        if (e.session != id) continue; // Late from an earlier session
+
+                        file_event& out = events[written++ % header->capacity];
+                        out.ns = to_ns(e.cycles);
+                        out.value = e.kind == kind_span ? tm::real_clock::to_nanoseconds(static_cast<uint64_t>(e.value)).count() : e.value;
+                        out.name = id_of(e.name);
+                        out.tid = b->tid;
+                        out.kind = e.kind;
+                    }
+                    b->tail.store(tail, std::memory_order_release);
+
+                    const bool done = b->retired.load(std::memory_order_acquire) && b->head.load(std::memory_order_acquire) == tail;
+                    if (done) {
+                        header->dropped.fetch_add(b->dropped, std::memory_order_relaxed);
+                        delete b;
+                    }
+                    return done;
+                });
+
+                header->written.store(written, std::memory_order_release);
+            }
+
+            void run() {
+                std::unique_lock wait(wake_lock);
+                while (!stopping) {
+                    wake.wait_for(wait, every);
+                    wait.unlock();
+                    drain();
+                    wait.lock();
+                }
+            }
+        };
+
+        inline session_& session() {
+            static session_* s = new session_; // Never destroyed, `stop()` may run from `atexit`
+            return *s;
+        }
+        #pragma endregion
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region API
+    inline void stop();
+
+    // Start recording into a ring file
+    // @param path The ring file (created, or overwritten)
+    // @param bytes Its size, the oldest events get overwritten when it is full (default: 64 MiB, ~2M events)
+    // @param drain_every How often buffered events go to the file (default: 10 ms)
+    // @return False if built without ASL_TRACE, or already recording
+    // @note `stop()` runs at exit, call it sooner to make sure the file has everything
+    inline bool start(const std::string& path, const std::size_t bytes = std::size_t(64) << 20, const std::chrono::milliseconds drain_every = std::chrono::milliseconds(10)) {
+        if constexpr (!enabled) return false;
+
+        namespace in = _internal;
+        in::session_& s = in::session();
+        const std::lock_guard guard(s.lock);
+        if (s.header) return false;
+
+        if (bytes < in::events_offset + 1024 * sizeof(in::file_event))
+            throw std::invalid_argument("asl::rt::trace::start(): Ring file too small.");
+
+        #ifdef __unix__
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1)
+            throw std::runtime_error("asl::rt::trace::start(): Failed to create the ring file.");
+        const bool sized = ftruncate(fd, static_cast<off_t>(bytes)) == 0;
+        close(fd);
+        if (!sized)
+            throw std::runtime_error("asl::rt::trace::start(): Failed to size the ring file.");
+        #endif
+
+        s.file = fs::mapping(path, fs::read_write);
+        std::byte* base = s.file.data();
+        s.header = new (base) in::file_header{};
+        std::memcpy(s.header->magic, in::magic, sizeof(in::magic));
+        s.header->version = in::file_version;
+        #ifdef __unix__
+        s.header->pid = static_cast<uint32_t>(getpid());
+        #endif
+        s.header->capacity = (bytes - in::events_offset) / sizeof(in::file_event);
+        s.names = reinterpret_cast<char*>(base + in::header_bytes);
+        s.events = reinterpret_cast<in::file_event*>(base + in::events_offset);
+        s.ids.clear();
+
+        s.every = drain_every;
+        s.stopping = false;
+        s.id = in::session_id.fetch_add(1, std::memory_order_relaxed) + 1;
+        s.drainer = std::thread([&s] { s.run(); });
+
+        static const bool at_exit = (std::atexit([] { trace::stop(); }), true);
+        (void)at_exit;
+
+        in::recording.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Stop recording: what is buffered goes to the file, which is then flushed and closed
+    // @note Events still being recorded by other threads right now may miss the file (never the next one)
+    inline void stop() {
+        namespace in = _internal;
+        in::session_& s = in::session();
+        const std::lock_guard guard(s.lock);
+        if (!s.header) return;
+
+        in::recording.store(false, std::memory_order_relaxed);
+        {
+            const std::lock_guard wake_guard(s.wake_lock);
+            s.stopping = true;
+        }
+        s.wake.notify_one();
+        s.drainer.join();
+        s.drain(); // Whatever came in after the last round
+
+        s.file.sync();
+        s.file = fs::mapping();
+        s.header = nullptr;
+        s.names = nullptr;
+        s.events = nullptr;
+    }
+
+    // Whether events are being recorded
+    inline bool recording() noexcept {
+        return _internal::recording.load(std::memory_order_relaxed);
+    }
+
+
+
+    // Convert a ring file to Chrome trace JSON (open it in Perfetto or chrome://tracing)
+    // @param ring_path A file written by `start()` (possibly by a process that crashed)
+    // @param json_path Where to write the JSON
+    // @return How many events were written
+    inline std::size_t export_json(const std::string& ring_path, const std::string& json_path) {
+        namespace in = _internal;
+        const fs::mapping ring(ring_path);
+        if (ring.size() < in::events_offset || std::memcmp(ring.data(), in::magic, sizeof(in::magic)) != 0)
+            throw std::runtime_error("asl::rt::trace::export_json(): Not a trace ring file.");
+
+        const auto* header = reinterpret_cast<const in::file_header*>(ring.data());
+        if (header->version != in::file_version)
+            throw std::runtime_error("asl::rt::trace::export_json(): Unknown ring file version.");
+
+        const char* names = reinterpret_cast<const char*>(ring.data() + in::header_bytes);
+        const auto* events = reinterpret_cast<const in::file_event*>(ring.data() + in::events_offset);
+        const uint64_t capacity = std::min<uint64_t>(header->capacity, (ring.size() - in::events_offset) / sizeof(in::file_event));
+        const uint64_t written = header->written.load(std::memory_order_acquire);
+        const uint64_t first = written > capacity ? written - capacity : 0;
+        const uint32_t name_count = std::min(header->names.load(std::memory_order_acquire), in::name_slots);
+
+        std::FILE* out = std::fopen(json_path.c_str(), "w");
+        if (!out)
+            throw std::runtime_error("asl::rt::trace::export_json(): Failed to open the output file.");
+
+        // Names, JSON-escaped once
+        std::vector<std::string> escaped(name_count);
+        for (uint32_t i = 0; i < name_count; ++i) {
+            const char* name = names + i * in::name_bytes;
+            for (std::size_t k = 0; k < in::name_bytes && name[k]; ++k) {
+                const unsigned char ch = static_cast<unsigned char>(name[k]);
+                if (ch == '"' || ch == '\\') escaped[i] += '\\';
+                if (ch < 0x20) escaped[i] += ' ';
+                else escaped[i] += static_cast<char>(ch);
+            }
+        }
+
+        // Timestamps are in microseconds, relative to the oldest event kept
+        int64_t origin = INT64_MAX;
+        for (uint64_t i = first; i < written; ++i) origin = std::min(origin, events[i % capacity].ns);
+
+        std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":%llu},\"traceEvents\":[",
+            static_cast<unsigned long long>(header->dropped.load(std::memory_order_relaxed)));
+
+        std::size_t count = 0;
+        for (uint64_t i = first; i < written; ++i) {
+            const in::file_event& e = events[i % capacity];
+            const char* name = e.name < name_count ? escaped[e.name].c_str() : "?";
+            const double ts = static_cast<double>(e.ns - origin) / 1000.0;
+
+            std::fputs(count++ ? ",\n" : "\n", out);
+            switch (e.kind) {
+                case in::kind_span:
+                    std::fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}",
+                        name, ts, static_cast<double>(e.value) / 1000.0, header->pid, e.tid);
+                    break;
+                case in::kind_counter:
+                    std::fprintf(out, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"value\":%lld}}",
+                        name, ts, header->pid, e.tid, static_cast<long long>(e.value));
+                    break;
+                default:
+                    std::fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}",
+                        name, ts, header->pid, e.tid);
+                    break;
+            }
+        }
+        std::fputs("\n]}\n", out);
+
+        if (std::fclose(out) != 0)
+            throw std::runtime_error("asl::rt::trace::export_json(): Failed to write the output file.");
+        return count;
+    }
+
+    #pragma endregion
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef RT_TRACE_POINTS_HPP
+#define RT_TRACE_POINTS_HPP
+
+// The `ASL_TRACE_*` macros, without the tracer unless ASL_TRACE is defined
+// @note Include this to instrument code, and `trace.hpp` to start / stop / export
+#ifdef ASL_TRACE
+#include "./trace.hpp"
+#else
+// Arguments are not evaluated (like `assert`), but still count as used
+#define ASL_TRACE_SPAN(name) static_cast<void>(sizeof(name))
+#define ASL_TRACE_COUNTER(name, value) (static_cast<void>(sizeof(name)), static_cast<void>(sizeof(value)))
+#define ASL_TRACE_INSTANT(name) static_cast<void>(sizeof(name))
+#endif
+
+#endif
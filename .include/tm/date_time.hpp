@@ -2,16 +2,430 @@
 #define TM_DATE_TIME_HPP
 
 #include "../types/object.hpp"
+#include "./time_zone.hpp"
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace asl::tm {
 
+    // A date and time of day, broken down
+    struct civil_time {
+        civil_date date;
+        unsigned hour = 0;
+        unsigned minute = 0;
+        unsigned second = 0;
+        uint32_t nanosecond = 0;
+        unsigned weekday = 4; // 0 is Sunday
+    };
+
+
+
     // Fixed set of time.
-    class date_time final : private types::object {
+    // @note Nanoseconds since the Unix epoch (UTC) in one `int64_t`, so years 1678 - 2262
+    // @note Formats and parses ISO-8601 / RFC-3339 without allocating. To format many timestamps, see `date_formatter`
+    class date_time final : private types::object<date_time> {
+    private:
+        int64_t ns_ = 0;
+
+        static constexpr char digit_pairs_[201] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        friend class date_formatter;
+
+        static void put2_(char* out, const unsigned v) noexcept {
+            std::memcpy(out, digit_pairs_ + v * 2, 2);
+        }
+
+        static void put4_(char* out, const unsigned v) noexcept {
+            put2_(out, v / 100);
+            put2_(out + 2, v % 100);
+        }
+
+        // The first `digits` (1 - 9) digits of a nanosecond count
+        static void put_fraction_(char* out, uint32_t ns, const unsigned digits) noexcept {
+            for (unsigned i = 9; i > digits; --i) ns /= 10;
+            for (unsigned i = digits; i > 0; --i) {
+                out[i - 1] = static_cast<char>('0' + ns % 10);
+                ns /= 10;
+            }
+        }
+
+        // "Z" or "+hh:mm"
+        static std::size_t put_offset_(char* out, const int32_t offset) noexcept {
+            if (offset == 0) {
+                out[0] = 'Z';
+                return 1;
+            }
+            const unsigned minutes = static_cast<unsigned>(offset < 0 ? -offset : offset) / 60;
+            out[0] = offset < 0 ? '-' : '+';
+            put2_(out + 1, minutes / 60 % 100);
+            out[3] = ':';
+            put2_(out + 4, minutes % 60);
+            return 6;
+        }
+
+        // "YYYY-MM-DD"
+        static void put_date_(char* out, const civil_date& d) noexcept {
+            put4_(out, static_cast<unsigned>(d.year));
+            out[4] = '-';
+            put2_(out + 5, d.month);
+            out[7] = '-';
+            put2_(out + 8, d.day);
+        }
+
+        // "HH:MM:SS" from seconds into the day
+        static void put_clock_(char* out, const unsigned seconds) noexcept {
+            put2_(out, seconds / 3600);
+            out[2] = ':';
+            put2_(out + 3, seconds / 60 % 60);
+            out[5] = ':';
+            put2_(out + 6, seconds % 60);
+        }
+
+        static bool read_digits_(const char*& p, const char* end, const unsigned count, unsigned& out) noexcept {
+            if (static_cast<std::size_t>(end - p) < count) return false;
+            unsigned v = 0;
+            for (unsigned i = 0; i < count; ++i) {
+                const unsigned d = static_cast<unsigned>(p[i] - '0');
+                if (d > 9) return false;
+                v = v * 10 + d;
+            }
+            p += count;
+            out = v;
+            return true;
+        }
+
     public:
-        // TODO: Date time            
+        // Longest output of `format()`: "YYYY-MM-DDTHH:MM:SS.nnnnnnnnn+hh:mm"
+        static constexpr std::size_t max_format_size = 35;
+
+
+
+
+
+        #pragma region Setups
+
+        date_time() noexcept = default;
+
+        // @param epoch_ns Nanoseconds since 1970-01-01T00:00:00Z
+        explicit date_time(const int64_t epoch_ns) noexcept : ns_(epoch_ns) {}
+
+        date_time(const std::chrono::system_clock::time_point tp) noexcept :
+            ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count()) {}
+
+        // Parse ISO-8601 / RFC-3339, see `parse()`
+        explicit date_time(const std::string_view texts) {
+            if (!parse(texts, *this))
+                throw std::runtime_error("asl::tm::date_time::date_time(): Invalid date time.");
+        }
+
+        // Current wall-clock time (`CLOCK_REALTIME`)
+        static date_time now() noexcept {
+            timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            return date_time(static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec);
+        }
+
+        // From calendar fields, in the local time of `offset` (seconds east of UTC)
+        static date_time from_civil(const int64_t year, const unsigned month, const unsigned day, const unsigned hour = 0, const unsigned minute = 0,
+            const unsigned second = 0, const uint32_t nanosecond = 0, const int32_t offset = 0) noexcept {
+            const int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+            return date_time(seconds * 1'000'000'000 + nanosecond);
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        int64_t epoch_ns() const noexcept {
+            return ns_;
+        }
+
+        // Whole seconds since the epoch (rounded down, also before 1970)
+        int64_t epoch_seconds() const noexcept {
+            return ns_ >= 0 ? ns_ / 1'000'000'000 : (ns_ + 1) / 1'000'000'000 - 1;
+        }
+
+        // Nanoseconds into the current second
+        uint32_t subsecond_ns() const noexcept {
+            return static_cast<uint32_t>(ns_ - epoch_seconds() * 1'000'000'000);
+        }
+
+        std::chrono::system_clock::time_point to_sys() const noexcept {
+            return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns_)));
+        }
+
+        // Calendar fields, in the local time of `offset` (seconds east of UTC)
+        civil_time split(const int32_t offset = 0) const noexcept {
+            const int64_t local = epoch_seconds() + offset;
+            const int64_t days = floor_days(local);
+            const unsigned in_day = static_cast<unsigned>(local - days * 86400);
+            return { civil_from_days(days), in_day / 3600, in_day / 60 % 60, in_day % 60, subsecond_ns(), weekday_from_days(days) };
+        }
+
+        // Calendar fields, in `zone`
+        civil_time split(const time_zone& zone) const noexcept {
+            return split(zone.offset_at(epoch_seconds()));
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Format
+
+        // Write "YYYY-MM-DDTHH:MM:SS[.f]" then "Z" or "+hh:mm" into `out`, no NUL
+        // @param digits Sub-second digits, 0 - 9
+        // @param offset Seconds east of UTC to show the time in
+        // @return Characters written, 0 if `size` was too small
+        std::size_t format(char* out, const std::size_t size, const unsigned digits = 9, const int32_t offset = 0) const noexcept {
+            const unsigned d = digits > 9 ? 9 : digits;
+            const std::size_t length = 19 + (d ? d + 1 : 0) + (offset ? 6 : 1);
+            if (size < length) return 0;
+
+            const int64_t local = epoch_seconds() + offset;
+            const int64_t days = floor_days(local);
+            put_date_(out, civil_from_days(days));
+            out[10] = 'T';
+            put_clock_(out + 11, static_cast<unsigned>(local - days * 86400));
+
+            std::size_t n = 19;
+            if (d) {
+                out[n++] = '.';
+                put_fraction_(out + n, subsecond_ns(), d);
+                n += d;
+            }
+            return n + put_offset_(out + n, offset);
+        }
+
+        // Same, in the local time of `zone`
+        std::size_t format(char* out, const std::size_t size, const time_zone& zone, const unsigned digits = 9) const noexcept {
+            return format(out, size, digits, zone.offset_at(epoch_seconds()));
+        }
+
+        // Same, as a string
+        std::string to_string(const unsigned digits = 9, const int32_t offset = 0) const {
+            char buffer[max_format_size];
+            return std::string(buffer, format(buffer, sizeof(buffer), digits, offset));
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Parse
+
+        // Parse "YYYY-MM-DD[(T| )HH:MM[:SS[.f...]]][Z|+hh[:mm]|-hh[:mm]]"
+        // @note No offset means UTC. Up to 9 fraction digits are kept, more are ignored
+        // @return False if `texts` is not one of those (then `out` is untouched)
+        static bool parse(const std::string_view texts, date_time& out) noexcept {
+            const char* p = texts.data();
+            const char* const end = p + texts.size();
+
+            unsigned year, month, day, hour = 0, minute = 0, second = 0;
+            if (!read_digits_(p, end, 4, year) || p == end || *p++ != '-') return false;
+            if (!read_digits_(p, end, 2, month) || p == end || *p++ != '-') return false;
+            if (!read_digits_(p, end, 2, day)) return false;
+
+            static constexpr unsigned month_days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            if (month < 1 || month > 12 || day < 1 || day > month_days[month - 1] + (month == 2 && is_leap_year(year))) return false;
+
+            uint32_t fraction = 0;
+            if (p != end && (*p == 'T' || *p == 't' || *p == ' ')) {
+                ++p;
+                if (!read_digits_(p, end, 2, hour) || p == end || *p++ != ':') return false;
+                if (!read_digits_(p, end, 2, minute)) return false;
+
+                if (p != end && *p == ':') {
+                    ++p;
+                    if (!read_digits_(p, end, 2, second)) return false;
+
+                    if (p != end && (*p == '.' || *p == ',')) {
+                        ++p;
+                        unsigned count = 0;
+                        for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p, ++count)
+                            if (count < 9) fraction = fraction * 10 + static_cast<uint32_t>(*p - '0');
+                        if (count == 0) return false;
+                        for (; count < 9; ++count) fraction *= 10;
+                    }
+                }
+                if (hour > 23 || minute > 59 || second > 60) return false; // 60: leap second, lands on the next one
+            }
+
+            int32_t offset = 0;
+            if (p != end) {
+                if (*p == 'Z' || *p == 'z') {
+                    ++p;
+                } else if (*p == '+' || *p == '-') {
+                    const bool negative = *p++ == '-';
+                    unsigned oh, om = 0;
+                    if (!read_digits_(p, end, 2, oh)) return false;
+                    if (p != end && *p == ':') ++p;
+                    if (p != end && !read_digits_(p, end, 2, om)) return false;
+                    if (oh > 23 || om > 59) return false;
+                    offset = static_cast<int32_t>(oh * 3600 + om * 60) * (negative ? -1 : 1);
+                } else {
+                    return false;
+                }
+            }
+            if (p != end) return false;
+
+            const int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+            int64_t ns;
+            if (__builtin_mul_overflow(seconds, int64_t(1'000'000'000), &ns) || __builtin_add_overflow(ns, int64_t(fraction), &ns)) return false;
+
+            out.ns_ = ns;
+            return true;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Operators
+
+        auto operator<=>(const date_time& other) const noexcept {
+            return ns_ <=> other.ns_;
+        }
+
+        bool operator==(const date_time& other) const noexcept {
+            return ns_ == other.ns_;
+        }
+
+        template<typename Rep, typename Period>
+        date_time operator+(const std::chrono::duration<Rep, Period> d) const noexcept {
+            return date_time(ns_ + std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+
+        template<typename Rep, typename Period>
+        date_time operator-(const std::chrono::duration<Rep, Period> d) const noexcept {
+            return date_time(ns_ - std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+
+        std::chrono::nanoseconds operator-(const date_time& other) const noexcept {
+            return std::chrono::nanoseconds(ns_ - other.ns_);
+        }
+
+        #pragma endregion
+    };
+
+
+
+    static_assert(sizeof(date_time) == sizeof(int64_t) && std::is_trivially_copyable_v<date_time>);
+
+
+
+    // Formats a stream of timestamps (e.g., one per log line) as fast as it gets
+    // @note Keeps the date and time of the last second, so within one second only the sub-second digits are rewritten,
+    //       and within one day only the time. The zone offset is cached until its next transition
+    // @note Not thread-safe, use one per thread
+    class date_formatter final : private types::object<date_formatter> {
+    private:
+        const time_zone* zone_;
+        unsigned digits_;
+
+        zone_offset offset_{ 0, false, {}, 0, 0 }; // Covers nothing, so the first call looks it up
+        int64_t second_ = INT64_MIN;
+        int64_t day_ = INT64_MIN;
+
+        char prefix_[19];   // "YYYY-MM-DDTHH:MM:SS"
+        char suffix_[6];    // "Z" or "+hh:mm"
+        std::size_t suffix_size_ = 1;
+
+    public:
+
+        #pragma region Setups
+
+        // @param digits Sub-second digits, 0 - 9 (default: 6)
+        // @param zone The zone to show times in (default: UTC; must outlive the formatter, which `time_zone::get()` ones do)
+        explicit date_formatter(const unsigned digits = 6, const time_zone& zone = time_zone::utc()) noexcept :
+            zone_(&zone), digits_(digits > 9 ? 9 : digits) {
+            std::memcpy(prefix_, "1970-01-01T00:00:00", 19);
+            suffix_[0] = 'Z';
+        }
+
+        date_formatter(const date_formatter&) = delete;
+        date_formatter& operator=(const date_formatter&) = delete;
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Format
+
+        // Output size of every `format()` call
+        std::size_t size() const noexcept {
+            return 19 + (digits_ ? digits_ + 1 : 0) + suffix_size_;
+        }
+
+        // Write `t` into `out`, no NUL
+        // @param room Size of `out`, `date_time::max_format_size` is always enough
+        // @return Characters written, 0 if `room` was too small
+        std::size_t format(const date_time t, char* out, const std::size_t room) noexcept {
+            const int64_t second = t.epoch_seconds();
+
+            if (second != second_) {
+                if (!offset_.covers(second)) {
+                    const int32_t before = offset_.offset;
+                    offset_ = zone_->at(second);
+                    if (before != offset_.offset || second_ == INT64_MIN) {
+                        suffix_size_ = date_time::put_offset_(suffix_, offset_.offset);
+                        day_ = INT64_MIN; // Local day may have moved
+                    }
+                }
+
+                const int64_t local = second + offset_.offset;
+                const int64_t day = floor_days(local);
+                if (day != day_) {
+                    date_time::put_date_(prefix_, civil_from_days(day));
+                    day_ = day;
+                }
+                date_time::put_clock_(prefix_ + 11, static_cast<unsigned>(local - day * 86400));
+                second_ = second;
+            }
+
+            if (size() > room) return 0;
+
+            std::memcpy(out, prefix_, 19);
+            std::size_t n = 19;
+            if (digits_) {
+                out[n++] = '.';
+                date_time::put_fraction_(out + n, t.subsecond_ns(), digits_);
+                n += digits_;
+            }
+            std::memcpy(out + n, suffix_, suffix_size_);
+            return n + suffix_size_;
+        }
+
+        // Write `t` at the end of `out`
+        std::string& append(const date_time t, std::string& out) {
+            char buffer[date_time::max_format_size];
+            return out.append(buffer, format(t, buffer, sizeof(buffer)));
+        }
+
+        #pragma endregion
     };
 }
 
 
-#endif
\ No newline at end of file
+#endif
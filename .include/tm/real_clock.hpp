@@ -2,16 +2,245 @@
 #define TM_REAL_CLOCK_HPP
 
 #include "../types/object.hpp"
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define ASL_TM_HAS_TSC 1
+#else
+#define ASL_TM_HAS_TSC 0
+#endif
 
 namespace asl::tm {
 
     // Just real clock.
     // @note Tick-tock, tick-tock
-    class real_clock final : private types::object {
+    // @note Reads the TSC when the CPU has an invariant one, calibrated against `CLOCK_MONOTONIC`.
+    //       Otherwise falls back to `clock_gettime(CLOCK_MONOTONIC)` (vDSO, no syscall).
+    // @note Satisfies the standard Clock requirements, so it works with `std::chrono`
+    class real_clock final : private types::object<real_clock> {
+    public:
+        using rep = int64_t;
+        using period = std::nano;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<real_clock>;
+        static constexpr bool is_steady = true;
+
+    private:
+        // ns = base_ns + ((cycles - base_cycles) * mult) >> 32
+        // @note Guarded by a seqlock so `recalibrate()` can run while others read
+        struct calibration_ {
+            std::atomic<uint32_t> seq{ 0 };
+            std::atomic<uint64_t> base_cycles{ 0 };
+            std::atomic<int64_t> base_ns{ 0 };
+            std::atomic<uint64_t> mult{ 0 };
+
+            // Start of the current measuring window, for drift correction
+            uint64_t window_cycles = 0;
+            int64_t window_ns = 0;
+
+            bool tsc = false;
+
+            // Initial calibration, a short window that `recalibrate()` refines
+            calibration_() noexcept;
+        };
+
+        static int64_t clock_ns_(const clockid_t id) noexcept {
+            timespec ts;
+            clock_gettime(id, &ts);
+            return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+        }
+
+        static bool invariant_tsc_() noexcept {
+            #if ASL_TM_HAS_TSC
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) return false;
+            if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+            return edx & (1u << 8);
+            #else
+            return false;
+            #endif
+        }
+
+        static uint64_t read_tsc_() noexcept {
+            #if ASL_TM_HAS_TSC
+            return __rdtsc();
+            #else
+            return static_cast<uint64_t>(clock_ns_(CLOCK_MONOTONIC));
+            #endif
+        }
+
+        // Cycles and monotonic ns sampled as close together as possible
+        static void sample_(uint64_t& cycles, int64_t& ns) noexcept {
+            uint64_t best_gap = ~uint64_t(0);
+            for (int i = 0; i < 5; ++i) {
+                const uint64_t before = read_tsc_();
+                const int64_t mono = clock_ns_(CLOCK_MONOTONIC);
+                const uint64_t after = read_tsc_();
+                if (after - before < best_gap) {
+                    best_gap = after - before;
+                    cycles = before + (after - before) / 2;
+                    ns = mono;
+                }
+            }
+        }
+
+        static void publish_(calibration_& c, const uint64_t base_cycles, const int64_t base_ns, const uint64_t mult) noexcept {
+            c.seq.fetch_add(1, std::memory_order_acq_rel); // Odd: being written
+            c.base_cycles.store(base_cycles, std::memory_order_relaxed);
+            c.base_ns.store(base_ns, std::memory_order_relaxed);
+            c.mult.store(mult, std::memory_order_relaxed);
+            c.seq.fetch_add(1, std::memory_order_release);
+        }
+
+        static calibration_& state_() noexcept {
+            static calibration_ c;
+            return c;
+        }
+
+        static int64_t convert_(const calibration_& c, const uint64_t cycles) noexcept {
+            uint32_t seq;
+            uint64_t base_cycles, mult;
+            int64_t base_ns;
+            do {
+                seq = c.seq.load(std::memory_order_acquire);
+                base_cycles = c.base_cycles.load(std::memory_order_relaxed);
+                base_ns = c.base_ns.load(std::memory_order_relaxed);
+                mult = c.mult.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+            } while ((seq & 1) || seq != c.seq.load(std::memory_order_relaxed));
+
+            const int64_t delta = static_cast<int64_t>(cycles - base_cycles);
+            const __int128 scaled = (static_cast<__int128>(delta) * static_cast<__int128>(mult)) >> 32;
+            return base_ns + static_cast<int64_t>(scaled);
+        }
+
     public:
-        // TODO: Real clock
+
+        #pragma region Now
+
+        // Current time, monotonic, nanoseconds
+        static time_point now() noexcept {
+            const calibration_& c = state_();
+            if (!c.tsc) return time_point(duration(clock_ns_(CLOCK_MONOTONIC)));
+            return time_point(duration(convert_(c, read_tsc_())));
+        }
+
+        // Cheaper, lower resolution (a few ms) time, from `CLOCK_MONOTONIC_COARSE`
+        static time_point coarse_now() noexcept {
+            #ifdef CLOCK_MONOTONIC_COARSE
+            return time_point(duration(clock_ns_(CLOCK_MONOTONIC_COARSE)));
+            #else
+            return time_point(duration(clock_ns_(CLOCK_MONOTONIC)));
+            #endif
+        }
+
+        // Time not slewed by NTP, from `CLOCK_MONOTONIC_RAW`
+        static time_point raw_now() noexcept {
+            #ifdef CLOCK_MONOTONIC_RAW
+            return time_point(duration(clock_ns_(CLOCK_MONOTONIC_RAW)));
+            #else
+            return time_point(duration(clock_ns_(CLOCK_MONOTONIC)));
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Cycles
+
+        // Raw cycle counter (`rdtsc`), for the cheapest possible interval measurement
+        // @note Not ordered with surrounding instructions, see `cycles_ordered()`
+        static uint64_t cycles() noexcept {
+            return read_tsc_();
+        }
+
+        // Cycle counter read after every earlier instruction finished (`rdtscp`)
+        static uint64_t cycles_ordered() noexcept {
+            #if ASL_TM_HAS_TSC
+            unsigned int aux;
+            return __rdtscp(&aux);
+            #else
+            return read_tsc_();
+            #endif
+        }
+
+        // Convert a cycle count (a difference of `cycles()`) to nanoseconds
+        static duration to_nanoseconds(const uint64_t cycle_count) noexcept {
+            const calibration_& c = state_();
+            const uint64_t mult = c.mult.load(std::memory_order_relaxed);
+            return duration(static_cast<rep>((static_cast<unsigned __int128>(cycle_count) * mult) >> 32));
+        }
+
+        // Cycles per nanosecond (i.e., TSC frequency in GHz)
+        static double ghz() noexcept {
+            const uint64_t mult = state_().mult.load(std::memory_order_relaxed);
+            return mult ? 4294967296.0 / static_cast<double>(mult) : 0.0;
+        }
+
+        // Whether `now()` reads the TSC
+        static bool uses_tsc() noexcept {
+            return state_().tsc;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Calibration
+
+        // Correct drift against `CLOCK_MONOTONIC`, e.g., once every few seconds from a timer
+        // @note Measures the rate over the whole window since the last call, and never goes backwards
+        // @note Call it from one thread at a time
+        static void recalibrate() noexcept {
+            calibration_& c = state_();
+
+            uint64_t cycles_now = 0;
+            int64_t ns_now = 0;
+            sample_(cycles_now, ns_now);
+
+            const uint64_t window = cycles_now - c.window_cycles;
+            if (window == 0) return;
+
+            const uint64_t mult = static_cast<uint64_t>((static_cast<unsigned __int128>(ns_now - c.window_ns) << 32) / window);
+
+            // Rebase on the monotonic reading, unless that would step back
+            const int64_t estimate = convert_(c, cycles_now);
+            publish_(c, cycles_now, ns_now > estimate ? ns_now : estimate, mult);
+
+            c.window_cycles = cycles_now;
+            c.window_ns = ns_now;
+        }
+
+        #pragma endregion
     };
+
+
+
+    inline real_clock::calibration_::calibration_() noexcept : tsc(invariant_tsc_()) {
+        uint64_t c0 = 0, c1 = 0;
+        int64_t n0 = 0, n1 = 0;
+        sample_(c0, n0);
+
+        const int64_t until = n0 + 10'000'000; // 10 ms
+        while (clock_ns_(CLOCK_MONOTONIC) < until) {}
+        sample_(c1, n1);
+
+        base_cycles.store(c1, std::memory_order_relaxed);
+        base_ns.store(n1, std::memory_order_relaxed);
+        mult.store(c1 > c0 ? static_cast<uint64_t>((static_cast<unsigned __int128>(n1 - n0) << 32) / (c1 - c0)) : (uint64_t(1) << 32), std::memory_order_relaxed);
+        window_cycles = c0;
+        window_ns = n0;
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,16 +2,376 @@
 #define TM_SLEEP_TIMER_HPP
 
 #include "../types/object.hpp"
+#include "../rt/event.hpp"
+#include "./real_clock.hpp"
+#include <algorithm>
 #include <chrono> // For compatibility
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#endif
 
 namespace asl::tm {
 
     // CPU sleep putter, lol
-    class sleep_timer final : private types::object {
+    // @note Hybrid: `clock_nanosleep(TIMER_ABSTIME)` for the bulk of the wait, then spins (`pause`) through the tail,
+    //       where a plain sleep would overshoot by the scheduler wake-up latency
+    // @note The spin margin trades CPU for precision: 0 only sleeps, a huge one only spins
+    class sleep_timer final : private types::object<sleep_timer> {
+    public:
+        using clock = std::chrono::steady_clock; // `CLOCK_MONOTONIC`
+
+    private:
+        std::chrono::nanoseconds spin_margin_;
+
+        static int64_t mono_ns_() noexcept {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+        }
+
+        static void pause_() noexcept {
+            #if ASL_TM_HAS_TSC
+            _mm_pause();
+            #elif defined(__aarch64__)
+            asm volatile("yield");
+            #endif
+        }
+
+        // Sleep (not spin) until `CLOCK_MONOTONIC` reaches `ns`
+        static void sleep_abs_(const int64_t ns) noexcept {
+            #ifdef __linux__
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+            ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+            #else
+            std::this_thread::sleep_until(clock::time_point(std::chrono::nanoseconds(ns)));
+            #endif
+        }
+
+        void wait_until_(const int64_t target) const noexcept {
+            const int64_t wake = target - spin_margin_.count();
+            if (mono_ns_() < wake) sleep_abs_(wake);
+
+            while (mono_ns_() < target) pause_();
+        }
+
+    public:
+
+        #pragma region Setups
+
+        // @param spin_margin How long before the deadline to stop sleeping and start spinning (default: 100 µs)
+        explicit sleep_timer(const std::chrono::nanoseconds spin_margin = std::chrono::microseconds(100)) noexcept :
+            spin_margin_(spin_margin.count() > 0 ? spin_margin : std::chrono::nanoseconds(0)) {}
+
+        // Measure how late a short `clock_nanosleep` wakes up on this machine, and use that as the spin margin
+        // @param samples How many sleeps to measure (default: 32)
+        // @return The new spin margin
+        // @note Takes about `samples` x (50 µs + wake-up latency)
+        std::chrono::nanoseconds calibrate(const unsigned samples = 32) {
+            std::vector<int64_t> late;
+            late.reserve(samples ? samples : 1);
+
+            for (unsigned i = 0; i < (samples ? samples : 1); ++i) {
+                const int64_t target = mono_ns_() + 50'000;
+                sleep_abs_(target);
+                late.push_back(std::max<int64_t>(mono_ns_() - target, 0));
+            }
+
+            // 90th percentile, plus some slack. Outliers (preemption) would make every sleep a long spin
+            std::sort(late.begin(), late.end());
+            const int64_t p90 = late[(late.size() * 9) / 10 < late.size() ? (late.size() * 9) / 10 : late.size() - 1];
+            spin_margin_ = std::chrono::nanoseconds(std::min<int64_t>(p90 + p90 / 4 + 5'000, 2'000'000));
+            return spin_margin_;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Sleep
+
+        // Sleep until `deadline`
+        sleep_timer& sleep_until(const clock::time_point deadline) noexcept {
+            wait_until_(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count());
+            return *this;
+        }
+
+        // Sleep until `deadline`
+        // @note `real_clock` follows `CLOCK_MONOTONIC`, the deadline is taken as is
+        sleep_timer& sleep_until(const real_clock::time_point deadline) noexcept {
+            wait_until_(deadline.time_since_epoch().count());
+            return *this;
+        }
+
+        // Sleep for `delay`
+        template<typename Rep, typename Period>
+        sleep_timer& sleep_for(const std::chrono::duration<Rep, Period> delay) noexcept {
+            wait_until_(mono_ns_() + std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        std::chrono::nanoseconds spin_margin() const noexcept {
+            return spin_margin_;
+        }
+
+        sleep_timer& spin_margin(const std::chrono::nanoseconds margin) noexcept {
+            spin_margin_ = margin.count() > 0 ? margin : std::chrono::nanoseconds(0);
+            return *this;
+        }
+
+        #pragma endregion
+    };
+
+
+
+    static_assert(sizeof(sleep_timer) == sizeof(std::chrono::nanoseconds) && std::is_trivially_copyable_v<sleep_timer>);
+
+
+
+    // Fires every `period` without drift
+    // @note Deadlines are `start + n * period`, so a late wake-up does not push the next ones back
+    class ticker final : private types::object<ticker> {
+    private:
+        sleep_timer sleeper_;
+        std::chrono::nanoseconds period_;
+        sleep_timer::clock::time_point next_;
+
+    public:
+
+        #pragma region Setups
+
+        // @param period Time between ticks
+        // @param spin_margin See `sleep_timer` (default: 100 µs)
+        explicit ticker(const std::chrono::nanoseconds period, const std::chrono::nanoseconds spin_margin = std::chrono::microseconds(100)) :
+            sleeper_(spin_margin), period_(period), next_(sleep_timer::clock::now() + period) {
+            if (period.count() <= 0)
+                throw std::runtime_error("asl::tm::ticker::ticker(): Period must be positive.");
+        }
+
+        // Start over, the first tick is one period from now
+        ticker& reset() noexcept {
+            next_ = sleep_timer::clock::now() + period_;
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Tick
+
+        // Wait for the next tick
+        // @return How many ticks elapsed (more than 1 if the caller fell behind; the missed ones are skipped, not replayed)
+        uint64_t wait() noexcept {
+            sleeper_.sleep_until(next_);
+
+            const auto now = sleep_timer::clock::now();
+            uint64_t elapsed = 1;
+            if (now - next_ >= period_)
+                elapsed += static_cast<uint64_t>((now - next_) / period_);
+
+            next_ += period_ * static_cast<int64_t>(elapsed);
+            return elapsed;
+        }
+
+        // When the next tick is due
+        sleep_timer::clock::time_point next() const noexcept {
+            return next_;
+        }
+
+        std::chrono::nanoseconds period() const noexcept {
+            return period_;
+        }
+
+        #pragma endregion
+    };
+
+
+
+    static_assert(std::is_trivially_copyable_v<ticker>);
+
+
+
+    // A timerfd, readable whenever it expires
+    // @note Use it with `poll` / `epoll`, or `attach()` it to an `rt::event` loop
+    class timer_fd final : private types::object<timer_fd> {
+    public:
+        // Called with how many times the timer expired since the last call
+        using callback = std::function<void(uint64_t)>;
+
+    private:
+        int fd_ = -1;
+        rt::event* loop_ = nullptr;
+
+        static timespec to_timespec_(const std::chrono::nanoseconds d) noexcept {
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>(d.count() / 1'000'000'000);
+            ts.tv_nsec = static_cast<long>(d.count() % 1'000'000'000);
+            return ts;
+        }
+
+        #ifdef __linux__
+        void settime_(const int flags, const itimerspec& spec, const char* who) {
+            if (timerfd_settime(fd_, flags, &spec, nullptr) == -1)
+                throw std::runtime_error(std::string("asl::tm::timer_fd::") + who + "(): timerfd_settime failed.");
+        }
+        #endif
+
     public:
-        // TODO: Sleep
+
+        #pragma region Setups
+
+        // A disarmed timer on `CLOCK_MONOTONIC`
+        timer_fd() {
+            #ifdef __linux__
+            fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (fd_ == -1)
+                throw std::runtime_error("asl::tm::timer_fd::timer_fd(): timerfd_create failed.");
+            #elif _WIN32
+            throw std::runtime_error("Coming soon, but not yet, Stay tuned!");
+            #endif
+        }
+
+        timer_fd(const timer_fd&) = delete;
+        timer_fd& operator=(const timer_fd&) = delete;
+
+        ~timer_fd() {
+            detach();
+            #ifdef __linux__
+            if (fd_ != -1) close(fd_);
+            #endif
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Arm
+
+        // Expire after `first`, then every `interval` (zero: once)
+        template<typename Rep1, typename Period1, typename Rep2 = int64_t, typename Period2 = std::nano>
+        timer_fd& arm(const std::chrono::duration<Rep1, Period1> first, const std::chrono::duration<Rep2, Period2> interval = std::chrono::duration<Rep2, Period2>::zero()) {
+            #ifdef __linux__
+            itimerspec spec;
+            const auto f = std::chrono::duration_cast<std::chrono::nanoseconds>(first);
+            spec.it_value = to_timespec_(f.count() > 0 ? f : std::chrono::nanoseconds(1)); // Zero would disarm
+            spec.it_interval = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval));
+            settime_(0, spec, "arm");
+            #endif
+            return *this;
+        }
+
+        // Expire at `when` (absolute, so no drift from the time it took to get here), then every `interval` (zero: once)
+        template<typename Rep = int64_t, typename Period = std::nano>
+        timer_fd& arm_at(const sleep_timer::clock::time_point when, const std::chrono::duration<Rep, Period> interval = std::chrono::duration<Rep, Period>::zero()) {
+            #ifdef __linux__
+            itimerspec spec;
+            const auto at = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch());
+            spec.it_value = to_timespec_(at.count() > 0 ? at : std::chrono::nanoseconds(1));
+            spec.it_interval = to_timespec_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval));
+            settime_(TFD_TIMER_ABSTIME, spec, "arm_at");
+            #endif
+            return *this;
+        }
+
+        // Stop it, nothing fires until armed again
+        timer_fd& disarm() {
+            #ifdef __linux__
+            itimerspec spec{};
+            settime_(0, spec, "disarm");
+            #endif
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Read
+
+        // How many times it expired since the last read
+        // @return 0 if it did not (never blocks)
+        uint64_t expirations() noexcept {
+            uint64_t count = 0;
+            #ifdef __linux__
+            if (::read(fd_, &count, sizeof(count)) != sizeof(count)) count = 0;
+            #endif
+            return count;
+        }
+
+        // Time until the next expiration, zero if disarmed
+        std::chrono::nanoseconds remaining() const noexcept {
+            #ifdef __linux__
+            itimerspec spec{};
+            timerfd_gettime(fd_, &spec);
+            return std::chrono::seconds(spec.it_value.tv_sec) + std::chrono::nanoseconds(spec.it_value.tv_nsec);
+            #else
+            return std::chrono::nanoseconds(0);
+            #endif
+        }
+
+        int fd() const noexcept {
+            return fd_;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Loop
+
+        // Call `fn` on the loop thread whenever it expires
+        // @note The timer stays owned by this object, `detach()` (or destruction) stops watching it
+        timer_fd& attach(rt::event& loop, callback fn) {
+            detach();
+            loop.watch(fd_, rt::ready_read, [this, fn = std::move(fn)](uint32_t) {
+                const uint64_t count = expirations();
+                if (count) fn(count);
+            });
+            loop_ = &loop;
+            return *this;
+        }
+
+        // Stop being watched by the event loop
+        timer_fd& detach() {
+            if (loop_) loop_->unwatch(fd_);
+            loop_ = nullptr;
+            return *this;
+        }
+
+        #pragma endregion
     };
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,488 @@
+#ifndef TM_TIME_ZONE_HPP
+#define TM_TIME_ZONE_HPP
+
+#include "../types/object.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace asl::tm {
+
+    #pragma region Calendar
+    // A proleptic Gregorian date
+    struct civil_date {
+        int64_t year = 1970;
+        unsigned month = 1; // 1 - 12
+        unsigned day = 1;   // 1 - 31
+    };
+
+    // Days since 1970-01-01
+    constexpr int64_t days_from_civil(int64_t y, const unsigned m, const unsigned d) noexcept {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    // Date of a day count since 1970-01-01
+    constexpr civil_date civil_from_days(int64_t z) noexcept {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+        const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+        return { static_cast<int64_t>(yoe) + era * 400 + (m <= 2), m, d };
+    }
+
+    // 0 is Sunday
+    constexpr unsigned weekday_from_days(const int64_t z) noexcept {
+        return static_cast<unsigned>(z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6);
+    }
+
+    constexpr bool is_leap_year(const int64_t y) noexcept {
+        return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+    }
+
+    // Floor division of seconds into days, correct before 1970 too
+    constexpr int64_t floor_days(const int64_t seconds) noexcept {
+        return (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    }
+    #pragma endregion
+
+
+
+
+    // The UTC offset in effect over a span of time
+    struct zone_offset {
+        int32_t offset = 0;     // Seconds east of UTC
+        bool dst = false;
+        std::string_view abbreviation; // e.g., "CEST", valid as long as the zone is
+
+        // It holds for epoch seconds in [begin, end), cache it for that long
+        int64_t begin = INT64_MIN;
+        int64_t end = INT64_MAX;
+
+        bool covers(const int64_t seconds) const noexcept {
+            return seconds >= begin && seconds < end;
+        }
+    };
+
+
+
+    // A time zone from the tz database (TZif files)
+    // @note Get them with `get()`, `utc()` or `local()`: each is loaded once and lives until exit, so references stay valid
+    // @note Past the last transition of the file, the POSIX TZ rule of its footer takes over
+    class time_zone final : private types::object<time_zone> {
+    private:
+        struct type_ {
+            int32_t offset;
+            bool dst;
+            uint32_t abbreviation; // Index in `names_`
+        };
+
+        // `std offset dst [offset],start[/time],end[/time]`
+        struct posix_rule_ {
+            bool has_dst = false;
+            int32_t std_offset = 0;
+            int32_t dst_offset = 0;
+            std::string std_name, dst_name;
+
+            // Mm.w.d (kind 'M'), Jn (kind 'J', 1 - 365 without Feb 29) or n (kind 'n', 0 - 365)
+            struct when_ {
+                char kind = 'M';
+                unsigned month = 0, week = 0, day = 0;
+                int32_t time = 7200; // Local time of day, seconds
+            } start, end;
+        };
+
+        std::string name_;
+        std::vector<int64_t> transitions_; // Epoch seconds, ascending
+        std::vector<uint8_t> transition_types_;
+        std::vector<type_> types_;
+        std::string names_; // NUL-separated abbreviations
+
+        bool has_rule_ = false;
+        posix_rule_ rule_;
+
+        #pragma region Loading
+        static int64_t be_(const unsigned char* p, const unsigned size) noexcept {
+            uint64_t v = 0;
+            for (unsigned i = 0; i < size; ++i) v = (v << 8) | p[i];
+            if (size == 4) return static_cast<int32_t>(static_cast<uint32_t>(v));
+            return static_cast<int64_t>(v);
+        }
+
+        bool parse_tzif_(const std::string& data) {
+            const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+            const auto* const end = p + data.size();
+
+            auto header = [&](const unsigned char* h, uint32_t counts[6]) {
+                if (end - h < 44 || h[0] != 'T' || h[1] != 'Z' || h[2] != 'i' || h[3] != 'f') return false;
+                for (unsigned i = 0; i < 6; ++i)
+                    counts[i] = static_cast<uint32_t>(be_(h + 20 + i * 4, 4));
+                return true;
+            };
+
+            // isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt
+            uint32_t c[6];
+            if (!header(p, c)) return false;
+            const char version = static_cast<char>(p[4]);
+
+            unsigned time_size = 4;
+            const std::size_t v1_size = 44 + static_cast<std::size_t>(c[3]) * 5 + c[4] * 6 + c[5] + c[2] * 8 + c[1] + c[0];
+            if (version >= '2') {
+                // Skip the 32-bit body, the 64-bit one follows
+                if (static_cast<std::size_t>(end - p) < v1_size) return false;
+                p += v1_size;
+                if (!header(p, c)) return false;
+                time_size = 8;
+            }
+            p += 44;
+
+            const std::size_t body = static_cast<std::size_t>(c[3]) * (time_size + 1) + c[4] * 6 + c[5] + c[2] * (time_size + 4) + c[1] + c[0];
+            if (static_cast<std::size_t>(end - p) < body || c[4] == 0) return false;
+
+            transitions_.resize(c[3]);
+            for (uint32_t i = 0; i < c[3]; ++i, p += time_size)
+                transitions_[i] = be_(p, time_size);
+
+            transition_types_.assign(p, p + c[3]);
+            p += c[3];
+
+            types_.resize(c[4]);
+            for (uint32_t i = 0; i < c[4]; ++i, p += 6)
+                types_[i] = { static_cast<int32_t>(be_(p, 4)), p[4] != 0, p[5] };
+
+            names_.assign(reinterpret_cast<const char*>(p), c[5]);
+            p += c[5] + c[2] * (time_size + 4) + c[1] + c[0];
+
+            for (auto& t : transition_types_)
+                if (t >= types_.size()) return false;
+            for (auto& t : types_)
+                if (t.abbreviation >= names_.size()) t.abbreviation = 0;
+
+            // Footer: "\n<POSIX TZ>\n"
+            if (version >= '2' && p < end && *p == '\n') {
+                const auto* const stop = std::find(p + 1, end, '\n');
+                if (stop != end)
+                    has_rule_ = parse_rule_(std::string_view(reinterpret_cast<const char*>(p + 1), static_cast<std::size_t>(stop - p - 1)), rule_);
+            }
+            return true;
+        }
+
+        // [+-]hh[:mm[:ss]]
+        static bool parse_hms_(std::string_view& s, int32_t& out) noexcept {
+            int32_t sign = 1;
+            if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
+                if (s[0] == '-') sign = -1;
+                s.remove_prefix(1);
+            }
+
+            int32_t parts[3] = { 0, 0, 0 };
+            for (unsigned k = 0; k < 3; ++k) {
+                if (k && (s.empty() || s[0] != ':')) break;
+                if (k) s.remove_prefix(1);
+
+                bool any = false;
+                while (!s.empty() && s[0] >= '0' && s[0] <= '9') {
+                    parts[k] = parts[k] * 10 + (s[0] - '0');
+                    s.remove_prefix(1);
+                    any = true;
+                }
+                if (!any) return false;
+            }
+            out = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+            return true;
+        }
+
+        static bool parse_name_(std::string_view& s, std::string& out) {
+            if (!s.empty() && s[0] == '<') {
+                const std::size_t close = s.find('>');
+                if (close == std::string_view::npos) return false;
+                out.assign(s.substr(1, close - 1));
+                s.remove_prefix(close + 1);
+                return true;
+            }
+
+            std::size_t n = 0;
+            while (n < s.size() && ((s[n] >= 'A' && s[n] <= 'Z') || (s[n] >= 'a' && s[n] <= 'z'))) ++n;
+            if (n < 3) return false;
+            out.assign(s.substr(0, n));
+            s.remove_prefix(n);
+            return true;
+        }
+
+        static bool parse_when_(std::string_view& s, posix_rule_::when_& w) noexcept {
+            auto number = [&s](unsigned& v) {
+                bool any = false;
+                v = 0;
+                while (!s.empty() && s[0] >= '0' && s[0] <= '9') {
+                    v = v * 10 + static_cast<unsigned>(s[0] - '0');
+                    s.remove_prefix(1);
+                    any = true;
+                }
+                return any;
+            };
+
+            if (s.empty()) return false;
+            if (s[0] == 'M') {
+                s.remove_prefix(1);
+                w.kind = 'M';
+                if (!number(w.month) || s.empty() || s[0] != '.') return false;
+                s.remove_prefix(1);
+                if (!number(w.week) || s.empty() || s[0] != '.') return false;
+                s.remove_prefix(1);
+                if (!number(w.day)) return false;
+                if (w.month < 1 || w.month > 12 || w.week < 1 || w.week > 5 || w.day > 6) return false;
+            } else if (s[0] == 'J') {
+                s.remove_prefix(1);
+                w.kind = 'J';
+                if (!number(w.day) || w.day < 1 || w.day > 365) return false;
+            } else {
+                w.kind = 'n';
+                if (!number(w.day) || w.day > 365) return false;
+            }
+
+            w.time = 7200;
+            if (!s.empty() && s[0] == '/') {
+                s.remove_prefix(1);
+                if (!parse_hms_(s, w.time)) return false;
+            }
+            return true;
+        }
+
+        static bool parse_rule_(std::string_view s, posix_rule_& r) {
+            int32_t offset;
+            if (!parse_name_(s, r.std_name) || !parse_hms_(s, offset)) return false;
+            r.std_offset = -offset; // POSIX offsets are west of UTC
+            if (s.empty()) return true;
+
+            if (!parse_name_(s, r.dst_name)) return false;
+            r.has_dst = true;
+            r.dst_offset = r.std_offset + 3600;
+            if (!s.empty() && s[0] != ',') {
+                if (!parse_hms_(s, offset)) return false;
+                r.dst_offset = -offset;
+            }
+
+            // No rule: the US one, as POSIX says it is implementation-defined anyway
+            if (s.empty()) {
+                r.start = { 'M', 3, 2, 0, 7200 };
+                r.end = { 'M', 11, 1, 0, 7200 };
+                return true;
+            }
+
+            if (s[0] != ',') return false;
+            s.remove_prefix(1);
+            if (!parse_when_(s, r.start) || s.empty() || s[0] != ',') return false;
+            s.remove_prefix(1);
+            return parse_when_(s, r.end) && s.empty();
+        }
+
+        // UTC epoch seconds of a rule transition in `year`, with `offset` in effect before it
+        static int64_t rule_transition_(const posix_rule_::when_& w, const int64_t year, const int32_t offset) noexcept {
+            int64_t day;
+            if (w.kind == 'M') {
+                const int64_t first = days_from_civil(year, w.month, 1);
+                const unsigned first_weekday = weekday_from_days(first);
+                day = first + static_cast<int64_t>((w.day + 7 - first_weekday) % 7) + 7 * (w.week - 1);
+
+                // Week 5 means the last one
+                static constexpr unsigned month_days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+                const unsigned length = month_days[w.month - 1] + (w.month == 2 && is_leap_year(year));
+                while (day >= first + length) day -= 7;
+            } else if (w.kind == 'J') {
+                day = days_from_civil(year, 1, 1) + w.day - 1 + (is_leap_year(year) && w.day >= 60);
+            } else {
+                day = days_from_civil(year, 1, 1) + w.day;
+            }
+            return day * 86400 + w.time - offset;
+        }
+
+        zone_offset from_type_(const uint8_t t) const noexcept {
+            const type_& ty = types_[t];
+            return { ty.offset, ty.dst, std::string_view(names_.c_str() + ty.abbreviation) };
+        }
+
+        zone_offset from_rule_(const int64_t seconds) const noexcept {
+            zone_offset std_off{ rule_.std_offset, false, rule_.std_name };
+            if (!rule_.has_dst) return std_off;
+
+            const int64_t year = civil_from_days(floor_days(seconds + rule_.std_offset)).year;
+            zone_offset dst_off{ rule_.dst_offset, true, rule_.dst_name };
+
+            // Look at this year's and the neighbours' transitions, in order
+            int64_t points[6];
+            bool to_dst[6];
+            unsigned n = 0;
+            for (int64_t y = year - 1; y <= year + 1; ++y) {
+                int64_t a = rule_transition_(rule_.start, y, rule_.std_offset);
+                int64_t b = rule_transition_(rule_.end, y, rule_.dst_offset);
+                if (a <= b) {
+                    points[n] = a; to_dst[n++] = true;
+                    points[n] = b; to_dst[n++] = false;
+                } else { // Southern hemisphere
+                    points[n] = b; to_dst[n++] = false;
+                    points[n] = a; to_dst[n++] = true;
+                }
+            }
+
+            unsigned i = 0;
+            while (i < n && points[i] <= seconds) ++i;
+            zone_offset out = i == 0 ? (to_dst[0] ? std_off : dst_off) : (to_dst[i - 1] ? dst_off : std_off);
+            out.begin = i == 0 ? INT64_MIN : points[i - 1];
+            out.end = i == n ? INT64_MAX : points[i];
+            return out;
+        }
+
+        static std::string root_() {
+            const char* dir = std::getenv("TZDIR");
+            return dir && *dir ? dir : "/usr/share/zoneinfo";
+        }
+
+        static std::unique_ptr<time_zone> load_(const std::string& name) {
+            std::string path;
+            if (name.empty() || name == "UTC" || name == "Etc/UTC") {
+                auto utc = std::unique_ptr<time_zone>(new time_zone());
+                utc->name_ = "UTC";
+                utc->types_.push_back({ 0, false, 0 });
+                utc->names_ = std::string("UTC", 4);
+                return utc;
+            }
+
+            path = name[0] == '/' ? name : root_() + "/" + name;
+            if (name.find("..") != std::string::npos) return nullptr;
+
+            std::ifstream in(path, std::ios::binary);
+            if (in) {
+                std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                auto zone = std::unique_ptr<time_zone>(new time_zone());
+                zone->name_ = name;
+                if (zone->parse_tzif_(data)) return zone;
+            }
+
+            // Maybe a POSIX TZ string itself, e.g., "EST5EDT,M3.2.0,M11.1.0"
+            auto zone = std::unique_ptr<time_zone>(new time_zone());
+            zone->name_ = name;
+            if (!parse_rule_(name, zone->rule_)) return nullptr;
+            zone->has_rule_ = true;
+            zone->types_.push_back({ zone->rule_.std_offset, false, 0 });
+            zone->names_ = zone->rule_.std_name + '\0';
+            return zone;
+        }
+
+        time_zone() = default;
+        #pragma endregion
+
+    public:
+
+        time_zone(const time_zone&) = delete;
+        time_zone& operator=(const time_zone&) = delete;
+
+
+
+
+
+        #pragma region Zones
+
+        // A zone by its tz database name (e.g., "Europe/Paris"), loaded once from `/usr/share/zoneinfo` (or `$TZDIR`)
+        // @note Also takes POSIX TZ strings
+        static const time_zone& get(const std::string_view name) {
+            static std::mutex lock;
+            static std::map<std::string, std::unique_ptr<time_zone>, std::less<>> zones;
+
+            std::lock_guard guard(lock);
+            if (auto it = zones.find(name); it != zones.end()) return *it->second;
+
+            auto zone = load_(std::string(name));
+            if (!zone)
+                throw std::runtime_error("asl::tm::time_zone::get(): Unknown time zone.");
+            return *zones.emplace(std::string(name), std::move(zone)).first->second;
+        }
+
+        static const time_zone& utc() {
+            static const time_zone& zone = get("UTC");
+            return zone;
+        }
+
+        // The system's zone: `$TZ`, else `/etc/localtime`, else UTC
+        static const time_zone& local() {
+            static const time_zone& zone = [] () -> const time_zone& {
+                const char* tz = std::getenv("TZ");
+                if (tz && *tz) {
+                    try {
+                        return get(tz[0] == ':' ? tz + 1 : tz);
+                    } catch (const std::runtime_error&) {}
+                }
+                try {
+                    return get("/etc/localtime");
+                } catch (const std::runtime_error&) {
+                    return utc();
+                }
+            }();
+            return zone;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Lookup
+
+        // The offset in effect at `seconds` (since the epoch, UTC)
+        // @note Binary search over the transitions; keep the result and reuse it while `covers()` holds
+        zone_offset at(const int64_t seconds) const noexcept {
+            if (transitions_.empty() || seconds < transitions_.front()) {
+                if (has_rule_ && transitions_.empty()) return from_rule_(seconds);
+
+                zone_offset out = from_type_(0);
+                if (!transitions_.empty()) out.end = transitions_.front();
+                return out;
+            }
+
+            const auto it = std::upper_bound(transitions_.begin(), transitions_.end(), seconds);
+            const std::size_t i = static_cast<std::size_t>(it - transitions_.begin()) - 1;
+
+            if (it == transitions_.end() && has_rule_) {
+                zone_offset out = from_rule_(seconds);
+                out.begin = std::max(out.begin, transitions_.back());
+                return out;
+            }
+
+            zone_offset out = from_type_(transition_types_[i]);
+            out.begin = transitions_[i];
+            out.end = it == transitions_.end() ? INT64_MAX : *it;
+            return out;
+        }
+
+        // Seconds east of UTC at `seconds`
+        int32_t offset_at(const int64_t seconds) const noexcept {
+            return at(seconds).offset;
+        }
+
+        // The name it was loaded by
+        const std::string& name() const noexcept {
+            return name_;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
@@ -0,0 +1,404 @@
+#ifndef TM_TIMER_WHEEL_HPP
+#define TM_TIMER_WHEEL_HPP
+
+#include "../types/object.hpp"
+#include "../rt/event.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace asl::tm {
+
+    // Handle of a scheduled timeout
+    // @note Stays safe to use after the timeout fired or was cancelled (it just does nothing)
+    struct timer_handle {
+        uint32_t index = ~uint32_t(0);
+        uint32_t generation = 0;
+    };
+
+
+
+    // Hierarchical hashed timer wheel
+    // @note 4 levels of 256 slots: O(1) schedule / cancel / reschedule, timeouts up to 2^32 ticks away
+    // @note Drive it with `advance_to()`, or `attach()` it to an `rt::event` loop (which then only wakes up when something is due)
+    class timer_wheel final : private types::object<timer_wheel> {
+    public:
+        using clock = std::chrono::steady_clock;
+        using callback = std::function<void()>;
+
+    private:
+        static constexpr uint32_t nil_ = ~uint32_t(0);
+        static constexpr unsigned levels_ = 4;
+        static constexpr unsigned slot_bits_ = 8;
+        static constexpr uint32_t slots_ = 1u << slot_bits_;
+        static constexpr uint32_t slot_mask_ = slots_ - 1;
+
+        struct node_ {
+            uint64_t expires = 0;
+            uint32_t prev = nil_;
+            uint32_t next = nil_;
+            uint32_t generation = 0;
+            uint32_t slot = nil_; // Index in `heads_`, `nil_` when free
+            callback fn;
+        };
+
+        std::vector<node_> nodes_;
+        uint32_t free_ = nil_; // Free list through `next`
+        uint32_t heads_[levels_ * slots_];
+        std::size_t level_sizes_[levels_] = {}; // Timers per level, to skip empty stretches
+
+        uint64_t now_ = 0; // Last processed tick
+        std::size_t size_ = 0;
+
+        std::chrono::nanoseconds resolution_;
+        clock::time_point origin_;
+
+        static constexpr uint64_t never_ = ~uint64_t(0);
+
+        rt::event* loop_ = nullptr;
+        std::weak_ptr<void> loop_alive_; // The loop may go first
+        rt::event::timer_id loop_timer_ = rt::event::no_timer; // One-shot, re-armed for `armed_`
+        uint64_t armed_ = never_; // Tick the loop timer is set for (`never_`: none, 0: just fired)
+
+        #pragma region Lists
+        void link_(const uint32_t i) noexcept {
+            node_& n = nodes_[i];
+            uint64_t delta = n.expires - now_;
+            if (delta >= (uint64_t(1) << (levels_ * slot_bits_)))
+                delta = (uint64_t(1) << (levels_ * slot_bits_)) - 1; // Too far: park it in the last level, it comes back on cascade
+
+            unsigned level = 0;
+            while (level + 1 < levels_ && delta >= (uint64_t(1) << ((level + 1) * slot_bits_)))
+                ++level;
+
+            const uint64_t at = level + 1 == levels_ && n.expires - now_ != delta ? now_ + delta : n.expires;
+            const uint32_t slot = level * slots_ + static_cast<uint32_t>((at >> (level * slot_bits_)) & slot_mask_);
+
+            n.slot = slot;
+            ++level_sizes_[level];
+            n.prev = nil_;
+            n.next = heads_[slot];
+            if (n.next != nil_) nodes_[n.next].prev = i;
+            heads_[slot] = i;
+        }
+
+        void unlink_(const uint32_t i) noexcept {
+            node_& n = nodes_[i];
+            if (n.prev != nil_) nodes_[n.prev].next = n.next;
+            else heads_[n.slot] = n.next;
+            if (n.next != nil_) nodes_[n.next].prev = n.prev;
+            n.prev = n.next = nil_;
+            --level_sizes_[n.slot / slots_];
+        }
+
+        void release_(const uint32_t i) noexcept {
+            node_& n = nodes_[i];
+            n.slot = nil_;
+            n.fn = nullptr;
+            ++n.generation;
+            n.next = free_;
+            free_ = i;
+            --size_;
+        }
+
+        bool valid_(const timer_handle h) const noexcept {
+            return h.index < nodes_.size() && nodes_[h.index].generation == h.generation && nodes_[h.index].slot != nil_;
+        }
+
+        // Re-distribute one slot of a higher level into lower ones
+        void cascade_(const unsigned level) noexcept {
+            const uint32_t slot = level * slots_ + static_cast<uint32_t>((now_ >> (level * slot_bits_)) & slot_mask_);
+            uint32_t i = heads_[slot];
+            heads_[slot] = nil_;
+
+            while (i != nil_) {
+                const uint32_t next = nodes_[i].next;
+                --level_sizes_[level];
+                link_(i);
+                i = next;
+            }
+        }
+
+        void tick_() {
+            ++now_;
+
+            // Level L wraps every 2^(8L) ticks. Cascade from the highest one that wrapped, so every timer lands where it belongs
+            unsigned wrapped = 0;
+            while (wrapped + 1 < levels_ && (now_ & ((uint64_t(1) << ((wrapped + 1) * slot_bits_)) - 1)) == 0)
+                ++wrapped;
+            for (unsigned level = wrapped; level >= 1; --level)
+                cascade_(level);
+
+            // Fire, one at a time (callbacks may schedule or cancel others)
+            const uint32_t slot = static_cast<uint32_t>(now_ & slot_mask_);
+            while (heads_[slot] != nil_) {
+                const uint32_t i = heads_[slot];
+                unlink_(i);
+
+                callback fn = std::move(nodes_[i].fn);
+                release_(i);
+                fn();
+            }
+        }
+        #pragma endregion
+
+        uint64_t to_ticks_(const std::chrono::nanoseconds d) const noexcept {
+            if (d.count() <= 0) return 1;
+            return static_cast<uint64_t>((d.count() + resolution_.count() - 1) / resolution_.count()); // Never early
+        }
+
+        // Where delays count from: the current time rounded up (the wheel may lag behind it, e.g., after idling),
+        // or the last processed tick if the wheel is ahead
+        uint64_t from_tick_() const noexcept {
+            const std::chrono::nanoseconds elapsed = clock::now() - origin_;
+            const uint64_t tick = elapsed.count() <= 0 ? 0 : static_cast<uint64_t>((elapsed.count() + resolution_.count() - 1) / resolution_.count());
+            return std::max(now_, tick);
+        }
+
+        timer_handle add_(const uint64_t expires, callback fn) {
+            uint32_t i = free_;
+            if (i != nil_) {
+                free_ = nodes_[i].next;
+            } else {
+                i = static_cast<uint32_t>(nodes_.size());
+                nodes_.emplace_back();
+            }
+
+            node_& n = nodes_[i];
+            n.expires = expires;
+            n.fn = std::move(fn);
+            link_(i);
+
+            ++size_;
+            if (expires < armed_) arm_();
+            return { i, n.generation };
+        }
+
+        bool move_(const timer_handle h, const uint64_t expires) noexcept {
+            if (!valid_(h)) return false;
+            unlink_(h.index);
+            nodes_[h.index].expires = expires;
+            link_(h.index);
+            if (expires < armed_) arm_();
+            return true;
+        }
+
+
+
+        #pragma region Loop
+        // The first tick at which something can happen (a timer fires, or a level cascades), `never_` if empty
+        // @note A lower bound: waking up then may just cascade
+        uint64_t next_tick_() const noexcept {
+            if (size_ == 0) return never_;
+
+            if (level_sizes_[0] != 0) {
+                const bool higher = size_ != level_sizes_[0];
+                for (uint64_t t = now_ + 1;; ++t) { // At most one lap
+                    if (heads_[t & slot_mask_] != nil_) return t;
+                    if (higher && (t & slot_mask_) == 0) return t;
+                }
+            }
+
+            unsigned busy = 1;
+            while (level_sizes_[busy] == 0) ++busy;
+            return (now_ | ((uint64_t(1) << (busy * slot_bits_)) - 1)) + 1;
+        }
+
+        // Set the loop timer for the next tick that matters, drop it when there is none
+        void arm_() noexcept {
+            if (!loop_) return;
+            if (loop_alive_.expired()) {
+                loop_ = nullptr; // Destroyed under us, its timer went with it
+                return;
+            }
+
+            const uint64_t tick = next_tick_();
+            if (tick == armed_) return;
+            armed_ = tick;
+
+            try {
+                if (tick == never_) {
+                    loop_->cancel_timer(loop_timer_);
+                    loop_timer_ = rt::event::no_timer;
+                    return;
+                }
+
+                const auto due = origin_ + std::chrono::nanoseconds(static_cast<int64_t>(tick) * resolution_.count());
+                const auto delay = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(due - clock::now()), std::chrono::nanoseconds(0));
+                if (loop_timer_ == rt::event::no_timer) loop_timer_ = loop_->add_timer(delay, [this](uint64_t) { on_loop_timer_(); });
+                else loop_->reset_timer(loop_timer_, delay);
+            } catch (...) {
+                armed_ = 0; // Try again next time
+            }
+        }
+
+        void on_loop_timer_() {
+            armed_ = 0; // Fired: re-armed below, or dropped by the loop
+            advance_to();
+            arm_();
+        }
+        #pragma endregion
+
+    public:
+
+        #pragma region Setups
+
+        // @param resolution Length of one tick (default: 1 ms)
+        // @param capacity Timers to preallocate room for (default: 1024)
+        explicit timer_wheel(const std::chrono::nanoseconds resolution = std::chrono::milliseconds(1), const std::size_t capacity = 1024) :
+            resolution_(resolution.count() > 0 ? resolution : std::chrono::nanoseconds(1)), origin_(clock::now()) {
+            for (auto& head : heads_) head = nil_;
+            nodes_.reserve(capacity);
+        }
+
+        timer_wheel(const timer_wheel&) = delete;
+        timer_wheel& operator=(const timer_wheel&) = delete;
+
+        ~timer_wheel() {
+            detach();
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Schedule
+
+        // Call `fn` after `delay_ticks` ticks (at least 1) past the last processed one
+        // @note For wheels driven with `advance_ticks_to()`. On the clock, use `schedule()`
+        timer_handle schedule_ticks(const uint64_t delay_ticks, callback fn) {
+            return add_(now_ + (delay_ticks ? delay_ticks : 1), std::move(fn));
+        }
+
+        // Call `fn` after `delay` from now (rounded up to the tick resolution)
+        template<typename Rep, typename Period>
+        timer_handle schedule(const std::chrono::duration<Rep, Period> delay, callback fn) {
+            return add_(from_tick_() + to_ticks_(std::chrono::duration_cast<std::chrono::nanoseconds>(delay)), std::move(fn));
+        }
+
+        // Cancel a timeout
+        // @return False if it already fired or was cancelled
+        bool cancel(const timer_handle h) noexcept {
+            if (!valid_(h)) return false;
+            unlink_(h.index);
+            release_(h.index);
+            return true;
+        }
+
+        // Move a pending timeout to `delay_ticks` past the last processed tick
+        // @return False if it already fired or was cancelled
+        bool reschedule_ticks(const timer_handle h, const uint64_t delay_ticks) noexcept {
+            return move_(h, now_ + (delay_ticks ? delay_ticks : 1));
+        }
+
+        // Move a pending timeout to `delay` from now
+        // @return False if it already fired or was cancelled
+        template<typename Rep, typename Period>
+        bool reschedule(const timer_handle h, const std::chrono::duration<Rep, Period> delay) noexcept {
+            return move_(h, from_tick_() + to_ticks_(std::chrono::duration_cast<std::chrono::nanoseconds>(delay)));
+        }
+
+        // Whether a timeout is still pending
+        bool pending(const timer_handle h) const noexcept {
+            return valid_(h);
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Drive
+
+        // Process ticks up to (and including) `tick`, firing what expired
+        // @return How many ticks were processed
+        uint64_t advance_ticks_to(const uint64_t tick) {
+            if (tick <= now_) return 0;
+            const uint64_t processed = tick - now_;
+
+            // Nothing to fire: jump
+            if (size_ == 0) {
+                now_ = tick;
+                return processed;
+            }
+
+            while (now_ < tick && size_ != 0) {
+                // Lower levels empty: nothing happens before the next wrap of the lowest busy level
+                unsigned busy = 0;
+                while (level_sizes_[busy] == 0) ++busy;
+
+                if (busy > 0) {
+                    const uint64_t before_wrap = now_ | ((uint64_t(1) << (busy * slot_bits_)) - 1);
+                    if (before_wrap >= tick) break;
+                    now_ = before_wrap;
+                }
+                tick_();
+            }
+            now_ = tick;
+            return processed;
+        }
+
+        // Process every tick elapsed until `when` (default: now)
+        uint64_t advance_to(const clock::time_point when = clock::now()) {
+            if (when <= origin_) return 0;
+            return advance_ticks_to(static_cast<uint64_t>((when - origin_) / resolution_));
+        }
+
+        // Drive this wheel from an event loop, with one timerfd armed for the next tick that matters (none while empty)
+        timer_wheel& attach(rt::event& loop) {
+            detach();
+            loop_ = &loop;
+            loop_alive_ = loop.lifetime();
+            armed_ = 0;
+            arm_();
+            return *this;
+        }
+
+        // Stop being driven by the event loop
+        // @note Fine after the loop was destroyed
+        timer_wheel& detach() {
+            if (loop_ && !loop_alive_.expired()) loop_->cancel_timer(loop_timer_);
+            loop_ = nullptr;
+            loop_alive_.reset();
+            loop_timer_ = rt::event::no_timer;
+            armed_ = never_;
+            return *this;
+        }
+
+        #pragma endregion
+
+
+
+
+
+        #pragma region Info
+
+        // Pending timeouts
+        std::size_t size() const noexcept {
+            return size_;
+        }
+
+        bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        // Last processed tick
+        uint64_t now_tick() const noexcept {
+            return now_;
+        }
+
+        std::chrono::nanoseconds resolution() const noexcept {
+            return resolution_;
+        }
+
+        #pragma endregion
+    };
+}
+
+#endif
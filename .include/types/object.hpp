@@ -15,23 +15,53 @@ The file you will see every objects inherit from.
 #ifndef TYPES_OBJECT_HPP
 #define TYPES_OBJECT_HPP
 
+#include <type_traits>
+
 inline namespace asl {
     namespace types {
 
         // Type inherited by all objects from this library
+        // @param Derived The inheriting class itself (CRTP), so two objects never share this base and it always takes no space
+        // @note Empty and non-virtual: no vptr, and it keeps the inheriting class trivially copyable / movable / destructible if its members are
+        template<typename Derived>
         class object {
-        public:
-            object() {
+        protected:
+            object() noexcept = default;
+            object(const object&) noexcept = default;
+            object(object&&) noexcept = default;
+            object& operator=(const object&) noexcept = default;
+            object& operator=(object&&) noexcept = default;
+            ~object() = default;
+        };
 
-            }
 
-            object operator=(object obj) noexcept {
 
-            }
+        // Whether `T` is an object from this library (accepted: statically type deduced, is base of object)
+        template<typename T>
+        concept an_object = std::is_class_v<T> && std::is_base_of_v<object<T>, T> && !std::is_polymorphic_v<T>;
 
-            virtual ~object() = default;
-        };
+
+
+        #pragma region Checks
+        namespace _checks {
+            struct probe_ final : private object<probe_> {
+                int value;
+            };
+
+            struct nested_ final : private object<nested_> {
+                probe_ inner; // Another object as the first member: still no padding
+            };
+
+            static_assert(std::is_empty_v<object<probe_>>);
+            static_assert(an_object<probe_> && an_object<nested_>);
+            static_assert(!std::is_polymorphic_v<probe_>);
+            static_assert(sizeof(probe_) == sizeof(int) && sizeof(nested_) == sizeof(int));
+            static_assert(std::is_standard_layout_v<probe_>);
+            static_assert(std::is_trivially_copyable_v<probe_> && std::is_trivially_destructible_v<probe_>);
+            static_assert(std::is_trivially_move_constructible_v<probe_> && std::is_trivially_move_assignable_v<probe_>);
+        }
+        #pragma endregion
     }
 }
 
-#endif
\ No newline at end of file
+#endif
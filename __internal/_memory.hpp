@@ -3,6 +3,7 @@ Internal memory utilities
 */
 
 #pragma once
+#include "../.include/types/object.hpp"
 #include <type_traits>
 #include <cstring>
 #include <memory>
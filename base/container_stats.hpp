@@ -0,0 +1,303 @@
+/*
+Allocation and copy accounting for containers
+
+Opt-in: define ASL_CONTAINER_STATS (or configure with -DASL_CONTAINER_STATS=ON) before including any container.
+Without it, every hook below is an empty inline function, and nothing is counted nor stored.
+*/
+
+#pragma once
+
+#include "../.include/types/object.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef ASL_CONTAINER_STATS
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+#include <cstdlib>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#endif
+
+namespace asl::base {
+    #ifdef ASL_CONTAINER_STATS
+    inline constexpr bool container_stats_enabled = true;
+    #else
+    inline constexpr bool container_stats_enabled = false;
+    #endif
+
+
+
+    // Counters of one container type, summed over every thread
+    // @note Bytes are counted in `sizeof(T)` units, memory owned by the elements themselves is not
+    struct container_stats {
+        std::string type;
+
+        uint64_t allocations = 0;   // First block of a container
+        uint64_t reallocations = 0; // Block replaced by another one (the realloc storms show up here)
+        uint64_t deallocations = 0; // Block given back
+        uint64_t bytes_moved = 0;   // Elements moved to a new block, or shifted by insert / erase
+        uint64_t bytes_copied = 0;  // Elements copied in (copies of containers, insert, push_back...)
+        uint64_t slack_bytes = 0;   // Unused slots (`slot() - size()`) of every block when it was replaced or given back
+        uint64_t peak_capacity = 0; // Largest block, in bytes
+        int64_t live_bytes = 0;     // Blocks currently held
+    };
+
+
+
+
+
+    #pragma region Internal
+    namespace _internal::stats {
+        #ifdef ASL_CONTAINER_STATS
+        // One thread's counters for one type
+        // @note Only the owning thread writes (plain load + store), others may read at any time
+        // @note Except `shared` ones (what exited threads left), written by any thread with atomic adds
+        struct counters {
+            std::atomic<uint64_t> allocations{ 0 }, reallocations{ 0 }, deallocations{ 0 };
+            std::atomic<uint64_t> bytes_moved{ 0 }, bytes_copied{ 0 }, slack_bytes{ 0 }, peak_capacity{ 0 };
+            std::atomic<int64_t> live_bytes{ 0 };
+            bool shared = false;
+
+            template<typename N>
+            void add(std::atomic<N>& c, const N n) const noexcept {
+                if (shared) c.fetch_add(n, std::memory_order_relaxed);
+                else c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            void raise_peak(const uint64_t bytes) noexcept {
+                uint64_t seen = peak_capacity.load(std::memory_order_relaxed);
+                if (!shared) {
+                    if (bytes > seen) peak_capacity.store(bytes, std::memory_order_relaxed);
+                    return;
+                }
+                while (bytes > seen && !peak_capacity.compare_exchange_weak(seen, bytes, std::memory_order_relaxed)) {}
+            }
+
+            // Move everything into `into` (a shared block)
+            void fold_into(counters& into) const noexcept {
+                into.add(into.allocations, allocations.load(std::memory_order_relaxed));
+                into.add(into.reallocations, reallocations.load(std::memory_order_relaxed));
+                into.add(into.deallocations, deallocations.load(std::memory_order_relaxed));
+                into.add(into.bytes_moved, bytes_moved.load(std::memory_order_relaxed));
+                into.add(into.bytes_copied, bytes_copied.load(std::memory_order_relaxed));
+                into.add(into.slack_bytes, slack_bytes.load(std::memory_order_relaxed));
+                into.add(into.live_bytes, live_bytes.load(std::memory_order_relaxed));
+                into.raise_peak(peak_capacity.load(std::memory_order_relaxed));
+            }
+
+            void add_to(container_stats& total) const noexcept {
+                total.allocations += allocations.load(std::memory_order_relaxed);
+                total.reallocations += reallocations.load(std::memory_order_relaxed);
+                total.deallocations += deallocations.load(std::memory_order_relaxed);
+                total.bytes_moved += bytes_moved.load(std::memory_order_relaxed);
+                total.bytes_copied += bytes_copied.load(std::memory_order_relaxed);
+                total.slack_bytes += slack_bytes.load(std::memory_order_relaxed);
+                total.peak_capacity = std::max(total.peak_capacity, peak_capacity.load(std::memory_order_relaxed));
+                total.live_bytes += live_bytes.load(std::memory_order_relaxed);
+            }
+
+            void reset() noexcept {
+                for (auto* c : { &allocations, &reallocations, &deallocations, &bytes_moved, &bytes_copied, &slack_bytes, &peak_capacity })
+                    c->store(0, std::memory_order_relaxed);
+            }
+        };
+
+        // Every running thread's counters for one type, and what the exited ones left
+        // @note Never freed: containers may still count after `main()` returns, or after their thread's `thread_local`s are gone
+        struct type_record {
+            std::string name;
+            std::mutex lock;
+            std::vector<counters*> threads;
+            counters retired; // `shared`
+        };
+
+        inline std::mutex registry_lock;
+        inline std::vector<type_record*> registry;
+
+        inline std::string demangle(const char* mangled) {
+            #if __has_include(<cxxabi.h>)
+            int status = 0;
+            char* readable = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+            if (status == 0 && readable) {
+                std::string name(readable);
+                std::free(readable);
+                return name;
+            }
+            #endif
+            return mangled;
+        }
+
+        template<typename Container>
+        type_record& record_of() {
+            static type_record* const record = [] {
+                auto* made = new type_record;
+                made->name = demangle(typeid(Container).name());
+                made->retired.shared = true;
+
+                const std::lock_guard guard(registry_lock);
+                registry.push_back(made);
+                return made;
+            }();
+            return *record;
+        }
+
+        // Folds a thread's counters into `retired` when the thread ends, and frees them
+        // @note The thread then counts straight into `retired`: its `thread_local`s are destroyed before its static containers (main thread)
+        struct retirer {
+            type_record& record;
+            counters*& local;
+
+            ~retirer() {
+                const std::lock_guard guard(record.lock);
+                std::erase(record.threads, local);
+                local->fold_into(record.retired);
+                delete local;
+                local = &record.retired;
+            }
+        };
+
+        // This thread's counters, registered on first use
+        // @note A plain pointer (nothing to destroy), still usable after `retirer` ran
+        template<typename Container>
+        counters& mine() {
+            thread_local counters* local = nullptr;
+            if (!local) [[unlikely]] {
+                type_record& r = record_of<Container>();
+                {
+                    const std::lock_guard guard(r.lock);
+                    local = new counters;
+                    r.threads.push_back(local);
+                }
+                thread_local const retirer retire{ r, local };
+            }
+            return *local;
+        }
+        #endif
+
+
+
+        // The hooks `contiguous_storage` calls
+        template<typename Container>
+        struct hooks {
+            // A block of `bytes` replaces one of `old_bytes` (0: none) holding `old_used_bytes`
+            static void realloc(const std::size_t old_bytes, const std::size_t old_used_bytes, const std::size_t bytes, const std::size_t moved_bytes) noexcept {
+                #ifdef ASL_CONTAINER_STATS
+                counters& c = mine<Container>();
+                c.add<uint64_t>(old_bytes ? c.reallocations : c.allocations, 1);
+                c.add<uint64_t>(c.bytes_moved, moved_bytes);
+                c.add<uint64_t>(c.slack_bytes, old_bytes - std::min(old_bytes, old_used_bytes));
+                c.add<int64_t>(c.live_bytes, static_cast<int64_t>(bytes) - static_cast<int64_t>(old_bytes));
+                c.raise_peak(bytes);
+                #else
+                (void)old_bytes, (void)old_used_bytes, (void)bytes, (void)moved_bytes;
+                #endif
+            }
+
+            // A block of `bytes` holding `used_bytes` is given back
+            static void release(const std::size_t bytes, const std::size_t used_bytes) noexcept {
+                #ifdef ASL_CONTAINER_STATS
+                if (bytes == 0) return;
+                counters& c = mine<Container>();
+                c.add<uint64_t>(c.deallocations, 1);
+                c.add<uint64_t>(c.slack_bytes, bytes - std::min(bytes, used_bytes));
+                c.add<int64_t>(c.live_bytes, -static_cast<int64_t>(bytes));
+                #else
+                (void)bytes, (void)used_bytes;
+                #endif
+            }
+
+            static void copied(const std::size_t bytes) noexcept {
+                #ifdef ASL_CONTAINER_STATS
+                if (bytes) {
+                    counters& c = mine<Container>();
+                    c.add<uint64_t>(c.bytes_copied, bytes);
+                }
+                #else
+                (void)bytes;
+                #endif
+            }
+
+            static void moved(const std::size_t bytes) noexcept {
+                #ifdef ASL_CONTAINER_STATS
+                if (bytes) {
+                    counters& c = mine<Container>();
+                    c.add<uint64_t>(c.bytes_moved, bytes);
+                }
+                #else
+                (void)bytes;
+                #endif
+            }
+        };
+    }
+    #pragma endregion
+
+
+
+
+
+    #pragma region API
+    // Counters of every container type used so far, most reallocations first
+    // @note Empty when ASL_CONTAINER_STATS is not defined
+    inline std::vector<container_stats> collect_container_stats() {
+        std::vector<container_stats> all;
+
+        #ifdef ASL_CONTAINER_STATS
+        namespace st = _internal::stats;
+        const std::lock_guard guard(st::registry_lock);
+        for (st::type_record* r : st::registry) {
+            const std::lock_guard type_guard(r->lock);
+            container_stats total;
+            total.type = r->name;
+            r->retired.add_to(total);
+            for (const st::counters* c : r->threads) c->add_to(total);
+            all.push_back(std::move(total));
+        }
+
+        std::sort(all.begin(), all.end(), [](const container_stats& a, const container_stats& b) {
+            return a.reallocations > b.reallocations;
+        });
+        #endif
+
+        return all;
+    }
+
+    // Zero the counters (except `live_bytes`, which stays true)
+    // @note A thread counting at the same time may keep a few of its counts
+    inline void reset_container_stats() {
+        #ifdef ASL_CONTAINER_STATS
+        namespace st = _internal::stats;
+        const std::lock_guard guard(st::registry_lock);
+        for (st::type_record* r : st::registry) {
+            const std::lock_guard type_guard(r->lock);
+            r->retired.reset();
+            for (st::counters* c : r->threads) c->reset();
+        }
+        #endif
+    }
+
+    // Print the counters as a table, one container type per line
+    // @param out Where to (default: stderr)
+    inline void dump_container_stats(std::FILE* out = stderr) {
+        if constexpr (!container_stats_enabled) {
+            std::fputs("asl: container stats are off (define ASL_CONTAINER_STATS)\n", out);
+            return;
+        }
+
+        std::fprintf(out, "%12s %12s %12s %14s %14s %14s %14s %14s  %s\n",
+            "allocs", "reallocs", "frees", "moved B", "copied B", "slack B", "peak cap B", "live B", "type");
+        for (const container_stats& s : collect_container_stats())
+            std::fprintf(out, "%12llu %12llu %12llu %14llu %14llu %14llu %14llu %14lld  %s\n",
+                static_cast<unsigned long long>(s.allocations), static_cast<unsigned long long>(s.reallocations),
+                static_cast<unsigned long long>(s.deallocations), static_cast<unsigned long long>(s.bytes_moved),
+                static_cast<unsigned long long>(s.bytes_copied), static_cast<unsigned long long>(s.slack_bytes),
+                static_cast<unsigned long long>(s.peak_capacity), static_cast<long long>(s.live_bytes), s.type.c_str());
+    }
+    #pragma endregion
+}
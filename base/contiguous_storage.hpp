@@ -1,17 +1,26 @@
 #pragma once
 
 #include "./custom_concepts.hpp"
+#include "./container_stats.hpp"
+#include "../.include/rt/trace_points.hpp"
 //#include "../__internal/_memory.hpp"
 #include <memory>
 #include <iterator>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <string>
 
 namespace asl::base {
     // Contiguous container engine
     // @note Provided common methods for contiguous containers
-    template<a_regular_value T>
+    // @param Container The inheriting container, which `container_stats` are counted under (default: this storage itself)
+    template<a_regular_value T, typename Container = void>
     requires storage_compatible<T>
     class contiguous_storage {
     protected:
+        using __l_stats = _internal::stats::hooks<std::conditional_t<std::is_void_v<Container>, contiguous_storage, Container>>;
+
         size_t used_slots_ = 0;
         size_t slots_ = 0;
 
@@ -19,14 +28,43 @@ namespace asl::base {
 
         inline contiguous_storage() = default;
 
+        // Takes the memory of `other`, which is left empty (so it never gets freed twice)
+        inline contiguous_storage(contiguous_storage&& other) noexcept :
+            used_slots_(std::exchange(other.used_slots_, 0)),
+            slots_(std::exchange(other.slots_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {}
+
+        inline contiguous_storage& operator=(contiguous_storage&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, used_slots_);
+                __l_stats::release(slots_ * sizeof(T), used_slots_ * sizeof(T));
+                ::operator delete(data_);
+                used_slots_ = std::exchange(other.used_slots_, 0);
+                slots_ = std::exchange(other.slots_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
         inline ~contiguous_storage() {
             std::destroy_n(data_, used_slots_);
+            __l_stats::release(slots_ * sizeof(T), used_slots_ * sizeof(T));
             ::operator delete(data_);
             data_ = nullptr;
         }
 
         void __l_fn_realloc(const size_t slots_number);
 
+        // Count `n` elements copied in by the inheriting container (see `container_stats`)
+        inline static void __l_fn_copied(const size_t n) noexcept {
+            __l_stats::copied(n * sizeof(T));
+        }
+
+        // Whether `p` points at one of the elements (which a reallocation would invalidate)
+        inline bool __l_fn_owns(const T* p) const noexcept {
+            return !std::less<const T*>{}(p, data_) && std::less<const T*>{}(p, data_ + used_slots_);
+        }
+
 
     public:
         using iterator = T*;
@@ -160,8 +198,15 @@ namespace asl::base {
         // @param first Start range of elements
         // @param last End range of elements
         // @note Will allocate more memory if insufficient (no extra growth)
+        // @note `first` and `last` must not point into this container
         iterator insert(iterator pos, const_iterator first, const_iterator last);
 
+        // Insert an element
+        // @param pos Where to insert
+        // @param val Value to add
+        // @note Will allocate more memory if insufficient (no extra growth)
+        iterator insert(iterator pos, const T& val);
+
         // Insert an element to the back
         // @param val Value to add
         // @param rep Repetition
@@ -169,12 +214,18 @@ namespace asl::base {
             if (rep < 1)
                 throw std::invalid_argument("asl::base::contiguous_storage<T>::push_back(...): Second parameter `rep` cannot be less than 1.");
 
-            if (used_slots_ + rep > slots_)
-                reserve(rep);
+            if (used_slots_ + rep > slots_) {
+                if (__l_fn_owns(&val)) { // `val` would not survive the reallocation
+                    const T kept = val;
+                    return push_back(kept, rep);
+                }
+                reserve(used_slots_ + rep - slots_);
+            }
 
-            const auto first_iterator = insert(end(), val);
-            for (; rep - 1 > 1; --rep)
-                insert(end(), val);
+            const iterator first_iterator = end();
+            std::uninitialized_fill_n(first_iterator, rep, val);
+            used_slots_ += rep;
+            __l_fn_copied(rep);
 
             return first_iterator;
         }
@@ -190,6 +241,7 @@ namespace asl::base {
             iterator mut_first = begin() + (first - begin());
             iterator mut_last = begin() + (last - begin());
 
+            __l_stats::moved((end() - mut_last) * sizeof(T));
             std::destroy(std::move(mut_last, end(), mut_first), end());
             used_slots_ -= (last - first);
         }
@@ -200,6 +252,13 @@ namespace asl::base {
             erase(end() - rep, end());
         }
 
+        // Exchange contents with `other` (no element is moved)
+        inline void swap(contiguous_storage& other) noexcept {
+            std::swap(used_slots_, other.used_slots_);
+            std::swap(slots_, other.slots_);
+            std::swap(data_, other.data_);
+        }
+
         // Clear elements
         // @note Doesn't reduce slots
         inline void clear() {
@@ -215,13 +274,15 @@ namespace asl::base {
 
 
 
-    template<a_regular_value T>
+    template<a_regular_value T, typename Container>
     requires storage_compatible<T>
-    void contiguous_storage<T>::__l_fn_realloc(const size_t slots_number) {
+    void contiguous_storage<T, Container>::__l_fn_realloc(const size_t slots_number) {
         // Does nothing if asked is the same as the current
         if (slots_number == slots_)
             return;
 
+        ASL_TRACE_SPAN("contiguous_storage::realloc");
+
         // This is smart (🗿)
         // - Transfers either amount of used slots or asked slots.
         const size_t elements_to_transfer = std::min(used_slots_, slots_number);
@@ -230,12 +291,14 @@ namespace asl::base {
             ::operator new(slots_number * sizeof(T)) // Here causes the problem
         );
 
-        if constexpr (std::is_move_constructible_v<T>) {
+        if constexpr (std::is_move_constructible_v<T>)
             std::uninitialized_move_n(data_, elements_to_transfer, new_memory);
-        } else {
+        else
             std::uninitialized_copy_n(data_, elements_to_transfer, new_memory);
-            std::destroy_n(data_, elements_to_transfer); // Only call dtors if copied.
-        }
+
+        __l_stats::realloc(slots_ * sizeof(T), used_slots_ * sizeof(T), slots_number * sizeof(T), elements_to_transfer * sizeof(T));
+
+        std::destroy_n(data_, used_slots_); // Moved-from ones, and whatever did not fit
         ::operator delete(data_);
 
         data_ = new_memory;
@@ -244,22 +307,62 @@ namespace asl::base {
     }
 
 
-    template<a_regular_value T>
+    template<a_regular_value T, typename Container>
     requires storage_compatible<T>
-    contiguous_storage<T>::iterator contiguous_storage<T>::insert(iterator pos, const_iterator first, const_iterator last) {
-        iterator mut_first = begin() + (first - begin());
-        iterator mut_last = begin() + (last - begin());
+    contiguous_storage<T, Container>::iterator contiguous_storage<T, Container>::insert(iterator pos, const_iterator first, const_iterator last) {
+        const size_t index = pos - data_;
         const size_t count = last - first;
 
-        if (used_slots_ + count > slots_) {
-            reserve(count);
-            pos = data_ + (pos - data_);
+        if (used_slots_ + count > slots_)
+            reserve(used_slots_ + count - slots_);
+        pos = data_ + index;
+
+        // Slots past `end()` are raw memory: those get constructed, the rest assigned
+        const size_t tail = used_slots_ - index;
+        if (count <= tail) {
+            std::uninitialized_move(end() - count, end(), end());
+            std::move_backward(pos, end() - count, end()); // Move everything rightward
+            std::copy(first, last, pos);
+        } else {
+            std::uninitialized_move(pos, end(), pos + count);
+            std::copy(first, first + tail, pos);
+            std::uninitialized_copy(first + tail, last, end());
         }
 
-        std::move_backward(pos, end(), end() + count); // Move everything rightward
-        std::uninitialized_copy(first, last, pos);
-        
+        __l_stats::moved(tail * sizeof(T));
+        __l_fn_copied(count);
+
         used_slots_ += count;
         return pos;
     }
+
+
+    template<a_regular_value T, typename Container>
+    requires storage_compatible<T>
+    contiguous_storage<T, Container>::iterator contiguous_storage<T, Container>::insert(iterator pos, const T& val) {
+        const size_t index = pos - data_;
+
+        if (used_slots_ == slots_) {
+            if (__l_fn_owns(&val)) { // `val` would not survive the reallocation
+                const T kept = val;
+                return insert(data_ + index, kept);
+            }
+            reserve(1);
+        }
+        pos = data_ + index;
+
+        if (pos == end()) {
+            std::construct_at(pos, val);
+        } else {
+            T kept = val; // Shifting may move `val` itself
+            std::construct_at(end(), std::move(back()));
+            std::move_backward(pos, end() - 1, end());
+            *pos = std::move(kept);
+        }
+        __l_stats::moved((end() - pos) * sizeof(T));
+        __l_fn_copied(1);
+
+        ++used_slots_;
+        return pos;
+    }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@ Just custom concepts
 
 #pragma once
 
+#include "../.include/types/object.hpp" // Opens `asl` as the inline namespace the `.include/` headers expect
 #include <type_traits>
 #include <concepts>
 #include <stdexcept>
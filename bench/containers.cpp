@@ -0,0 +1,309 @@
+// containers::vector, containers::basic_string and value_wrappers::nullable, next to their std:: counterparts
+
+#include "containers/string.hpp"
+#include "containers/vector.hpp"
+#include "value_wrappers/nullable.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+    using asl_string = asl::containers::string;
+
+    template<typename T> using asl_vector = asl::containers::vector<T>;
+
+
+
+    // The i-th element put in the containers below
+    template<typename T>
+    T element(const std::size_t i) {
+        if constexpr (std::is_same_v<T, std::string>) return "element #" + std::to_string(i);
+        else if constexpr (std::is_same_v<T, asl_string>) return asl_string(element<std::string>(i).c_str());
+        else return static_cast<T>(i);
+    }
+
+    template<typename V>
+    V filled(const std::size_t n) {
+        using T = std::ranges::range_value_t<V>;
+        V v;
+        for (std::size_t i = 0; i < n; ++i) v.push_back(element<T>(i));
+        return v;
+    }
+}
+
+
+
+
+
+#pragma region Vector
+
+// Grow from empty, one element at a time
+template<typename V>
+void vector_push_back(benchmark::State& state) {
+    using T = std::ranges::range_value_t<V>;
+    const std::size_t n = state.range(0);
+    const T value = element<T>(n);
+
+    for (auto _ : state) {
+        V v;
+        for (std::size_t i = 0; i < n; ++i) v.push_back(value);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Insert in the middle, which shifts half the elements each time
+template<typename V>
+void vector_insert_middle(benchmark::State& state) {
+    using T = std::ranges::range_value_t<V>;
+    const std::size_t n = state.range(0);
+    const T value = element<T>(n);
+
+    for (auto _ : state) {
+        V v;
+        for (std::size_t i = 0; i < n; ++i) v.insert(v.begin() + v.size() / 2, value);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Insert a whole range at the front
+template<typename V>
+void vector_insert_range(benchmark::State& state) {
+    using T = std::ranges::range_value_t<V>;
+    const std::size_t n = state.range(0);
+    const std::vector<T> source = filled<std::vector<T>>(n);
+    const V base = filled<V>(n);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        V v = base;
+        state.ResumeTiming();
+
+        v.insert(v.begin(), source.data(), source.data() + n);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Erase from the front until empty, one element at a time
+template<typename V>
+void vector_erase_front(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const V base = filled<V>(n);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        V v = base;
+        state.ResumeTiming();
+
+        while (!v.empty()) v.erase(v.begin(), v.begin() + 1);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename V>
+void vector_copy(benchmark::State& state) {
+    using T = std::ranges::range_value_t<V>;
+    const std::size_t n = state.range(0);
+    const V base = filled<V>(n);
+
+    for (auto _ : state) {
+        V v = base;
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+BENCHMARK(vector_push_back<asl_vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(vector_push_back<std::vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(vector_push_back<asl_vector<asl_string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_push_back<std::vector<std::string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+
+BENCHMARK(vector_insert_middle<asl_vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_insert_middle<std::vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_insert_middle<asl_vector<asl_string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_insert_middle<std::vector<std::string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+
+BENCHMARK(vector_insert_range<asl_vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(vector_insert_range<std::vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+
+BENCHMARK(vector_erase_front<asl_vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_erase_front<std::vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_erase_front<asl_vector<asl_string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+BENCHMARK(vector_erase_front<std::vector<std::string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 12);
+
+BENCHMARK(vector_copy<asl_vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 18);
+BENCHMARK(vector_copy<std::vector<std::uint64_t>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 18);
+BENCHMARK(vector_copy<asl_vector<asl_string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(vector_copy<std::vector<std::string>>)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+
+#pragma endregion
+
+
+
+
+
+#pragma region String
+
+// From a C string of `range(0)` characters
+template<typename S>
+void string_construct(benchmark::State& state) {
+    const std::string text(state.range(0), 'x');
+
+    for (auto _ : state) {
+        S s(text.c_str());
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+template<typename S>
+void string_copy(benchmark::State& state) {
+    const S base(std::string(state.range(0), 'x').c_str());
+
+    for (auto _ : state) {
+        S s(base);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Build a `range(0)` characters string from 16-character pieces
+template<typename S>
+void string_append(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const S piece("0123456789abcdef");
+
+    for (auto _ : state) {
+        S s;
+        while (s.size() < n) s += piece;
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+template<typename S>
+void string_append_char(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+
+    for (auto _ : state) {
+        S s;
+        for (std::size_t i = 0; i < n; ++i) s += char('a' + i % 26);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+// Equal strings of `range(0)` characters: the worst case, every character is looked at
+template<typename S>
+void string_compare(benchmark::State& state) {
+    const std::string text(state.range(0), 'x');
+    const S a(text.c_str()), b(text.c_str());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a == b);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+// Mixed-case text, lowered then uppered
+void string_case_folding(benchmark::State& state) {
+    std::string text(state.range(0), 'x');
+    for (std::size_t i = 0; i < text.size(); ++i) text[i] = "Hello, World! 0123"[i % 18];
+    asl_string s(text.c_str());
+
+    for (auto _ : state) {
+        s.to_lower(s.begin(), s.end());
+        s.to_upper(s.begin(), s.end());
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * text.size() * 2);
+}
+
+void std_string_case_folding(benchmark::State& state) {
+    std::string s(state.range(0), 'x');
+    for (std::size_t i = 0; i < s.size(); ++i) s[i] = "Hello, World! 0123"[i % 18];
+
+    for (auto _ : state) {
+        for (char& ch : s) ch = (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+        for (char& ch : s) ch = (ch >= 'a' && ch <= 'z') ? ch - ('a' - 'A') : ch;
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * s.size() * 2);
+}
+
+BENCHMARK(string_construct<asl_string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_construct<std::string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_copy<asl_string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_copy<std::string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_append<asl_string>)->RangeMultiplier(16)->Range(64, 1 << 14);
+BENCHMARK(string_append<std::string>)->RangeMultiplier(16)->Range(64, 1 << 14);
+BENCHMARK(string_append_char<asl_string>)->RangeMultiplier(16)->Range(64, 1 << 14);
+BENCHMARK(string_append_char<std::string>)->RangeMultiplier(16)->Range(64, 1 << 14);
+BENCHMARK(string_compare<asl_string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_compare<std::string>)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(string_case_folding)->RangeMultiplier(16)->Range(8, 1 << 16);
+BENCHMARK(std_string_case_folding)->RangeMultiplier(16)->Range(8, 1 << 16);
+
+#pragma endregion
+
+
+
+
+
+#pragma region Nullable
+
+namespace {
+    // Every third one is empty
+    template<typename N>
+    std::vector<N> nullables(const std::size_t n) {
+        std::vector<N> all;
+        all.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 3 == 0) all.emplace_back();
+            else all.emplace_back(static_cast<std::uint64_t>(i));
+        }
+        return all;
+    }
+}
+
+// Checked access: `has_value()` then `*`
+template<typename N>
+void nullable_access(benchmark::State& state) {
+    const std::vector<N> base = nullables<N>(1024);
+    std::vector<N> all = base;
+
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (N& each : all)
+            if (each.has_value()) sum += *each;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * all.size());
+}
+
+template<typename N>
+void nullable_value_or(benchmark::State& state) {
+    const std::vector<N> all = nullables<N>(1024);
+
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (const N& each : all) sum += each.value_or(7);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * all.size());
+}
+
+BENCHMARK(nullable_access<asl::value_wrappers::nullable<std::uint64_t>>);
+BENCHMARK(nullable_access<std::optional<std::uint64_t>>);
+BENCHMARK(nullable_value_or<asl::value_wrappers::nullable<std::uint64_t>>);
+BENCHMARK(nullable_value_or<std::optional<std::uint64_t>>);
+
+#pragma endregion
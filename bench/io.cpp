@@ -0,0 +1,168 @@
+// fs::directory enumeration / size(), and io::terminal write throughput
+
+#include ".include/fs/directory.hpp"
+#include ".include/io/terminal.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    namespace sfs = std::filesystem;
+
+
+
+    // A throwaway tree: `range(0)` sub-directories of `range(1)` small files each, removed at exit
+    const sfs::path& tree(const std::size_t dirs, const std::size_t files) {
+        struct trees {
+            std::map<std::pair<std::size_t, std::size_t>, sfs::path> made;
+            ~trees() {
+                std::error_code ignored;
+                for (const auto& [_, root] : made) sfs::remove_all(root, ignored);
+            }
+        };
+        static trees all;
+
+        auto& root = all.made[{ dirs, files }];
+        if (!root.empty()) return root;
+
+        root = sfs::temp_directory_path() / ("asl_bench_" + std::to_string(getpid()) + "_" + std::to_string(dirs) + "x" + std::to_string(files));
+        sfs::create_directories(root);
+        const std::string content(1000, 'x');
+        for (std::size_t d = 0; d < dirs; ++d) {
+            const sfs::path sub = root / ("dir" + std::to_string(d));
+            sfs::create_directory(sub);
+            for (std::size_t f = 0; f < files; ++f)
+                std::ofstream(sub / ("file" + std::to_string(f) + ".txt")) << content;
+        }
+        return root;
+    }
+
+
+
+    // Points stdout at /dev/null while alive, so the writes below do not end up in the report
+    class muted_stdout {
+        int saved_;
+
+    public:
+        muted_stdout() {
+            std::cout.flush();
+            std::fflush(stdout);
+            saved_ = dup(STDOUT_FILENO);
+
+            const int null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+            dup2(null, STDOUT_FILENO);
+            close(null);
+        }
+
+        ~muted_stdout() {
+            std::fflush(stdout);
+            dup2(saved_, STDOUT_FILENO);
+            close(saved_);
+        }
+    };
+}
+
+
+
+
+
+#pragma region Directory
+
+// Recursive listing done by the constructor
+void directory_construct(benchmark::State& state) {
+    const sfs::path& root = tree(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        asl::fs::directory d(root);
+        benchmark::DoNotOptimize(d.list().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(1) + 1));
+}
+
+// `entries()`: one `statx` per entry, recursive
+void directory_entries(benchmark::State& state) {
+    const sfs::path& root = tree(state.range(0), state.range(1));
+    const asl::fs::directory d(root);
+
+    for (auto _ : state) {
+        const auto found = d.entries(asl::fs::field_all, true);
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(1) + 1));
+}
+
+void directory_size(benchmark::State& state) {
+    const sfs::path& root = tree(state.range(0), state.range(1));
+    const asl::fs::directory d(root);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(d.size(asl::fs::B));
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(1) + 1));
+}
+
+// What `size()` replaces: a recursive_directory_iterator with a stat per file
+void std_filesystem_size(benchmark::State& state) {
+    const sfs::path& root = tree(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        std::uintmax_t bytes = 0;
+        for (const auto& each : sfs::recursive_directory_iterator(root))
+            if (each.is_regular_file()) bytes += each.file_size();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(1) + 1));
+}
+
+BENCHMARK(directory_construct)->Args({ 4, 64 })->Args({ 16, 256 });
+BENCHMARK(directory_entries)->Args({ 4, 64 })->Args({ 16, 256 });
+BENCHMARK(directory_size)->Args({ 4, 64 })->Args({ 16, 256 });
+BENCHMARK(std_filesystem_size)->Args({ 4, 64 })->Args({ 16, 256 });
+
+#pragma endregion
+
+
+
+
+
+#pragma region Terminal
+
+// Lines of `range(0)` characters, straight through stdio
+void terminal_write(benchmark::State& state) {
+    asl::io::terminal term;
+    const std::string line(state.range(0) - 1, 'x');
+    const muted_stdout muted;
+
+    for (auto _ : state) {
+        term.write(line).write("\n");
+    }
+    term.flush();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Frames of 64 lines of `range(0)` characters, with a cursor move each: collected, then one `write(2)` per frame
+void terminal_deferred_frame(benchmark::State& state) {
+    asl::io::terminal term;
+    const std::string line(state.range(0) - 1, 'x');
+    const muted_stdout muted;
+    term.defer();
+
+    for (auto _ : state) {
+        for (uint16_t row = 1; row <= 64; ++row)
+            term.cursor_pos(row, 1).write(line).write("\n");
+        term.commit();
+    }
+    term.defer(false);
+    state.SetBytesProcessed(state.iterations() * 64 * state.range(0));
+}
+
+BENCHMARK(terminal_write)->Arg(16)->Arg(80)->Arg(1024);
+BENCHMARK(terminal_deferred_frame)->Arg(16)->Arg(80)->Arg(1024);
+
+#pragma endregion
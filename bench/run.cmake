@@ -0,0 +1,37 @@
+# Runs the benchmarks, with the JSON results named after the commit they measured
+# @note Called by the `bench` target: BENCH, SOURCE_DIR and OUTPUT_DIR are passed by it
+
+set(commit "unknown")
+
+find_program(GIT git)
+if(GIT)
+    execute_process(COMMAND ${GIT} rev-parse --short=12 HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR} OUTPUT_VARIABLE head OUTPUT_STRIP_TRAILING_WHITESPACE ERROR_QUIET RESULT_VARIABLE failed)
+
+    if(NOT failed AND head)
+        set(commit ${head})
+
+        # Uncommitted changes are measured too, the name says so
+        execute_process(COMMAND ${GIT} status --porcelain --untracked-files=no
+            WORKING_DIRECTORY ${SOURCE_DIR} OUTPUT_VARIABLE changes ERROR_QUIET)
+        if(changes)
+            string(APPEND commit "-dirty")
+        endif()
+    endif()
+endif()
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+set(output ${OUTPUT_DIR}/${commit}.json)
+
+set(args --benchmark_out=${output} --benchmark_out_format=json --benchmark_context=commit=${commit})
+if(DEFINED ENV{ASL_BENCH_ARGS})
+    separate_arguments(extra UNIX_COMMAND "$ENV{ASL_BENCH_ARGS}")
+    list(APPEND args ${extra})
+endif()
+
+execute_process(COMMAND ${BENCH} ${args} RESULT_VARIABLE failed)
+if(failed)
+    message(FATAL_ERROR "asl_bench failed: ${failed}")
+endif()
+
+message(STATUS "Results: ${output}")
@@ -0,0 +1,110 @@
+// algorithms::sort against std::sort, on containers::vector batches of 1M elements and up
+// @note The largest batch is ASL_BENCH_SORT_MAX (a CMake cache variable): 1 << 30 for the whole 1M - 1B sweep, which needs ~16 GiB
+
+#include ".include/algorithms/sort.hpp"
+#include "containers/string.hpp"
+#include "containers/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#ifndef ASL_BENCH_SORT_MAX
+#define ASL_BENCH_SORT_MAX (1 << 24)
+#endif
+
+namespace {
+    namespace sort = asl::algorithms::sort;
+
+    template<typename T> using asl_vector = asl::containers::vector<T>;
+
+
+
+    asl_vector<std::uint64_t> random_keys(const std::size_t n) {
+        std::mt19937_64 rng(n);
+        asl_vector<std::uint64_t> keys(n);
+        for (std::size_t i = 0; i < n; ++i) keys.push_back(rng());
+        return keys;
+    }
+
+    // Like file paths or identifiers: long shared prefixes, then a random tail
+    asl_vector<asl::containers::string> random_strings(const std::size_t n) {
+        static constexpr const char* prefixes[] = { "", "user/", "user/profile/", "assets/textures/terrain/" };
+        std::mt19937_64 rng(n);
+        asl_vector<asl::containers::string> strings(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::string s = prefixes[rng() % 4];
+            for (std::size_t len = 4 + rng() % 16; len > 0; --len) s += char('a' + rng() % 26);
+            strings.push_back(asl::containers::string(s.c_str()));
+        }
+        return strings;
+    }
+
+
+
+    // Sorts a fresh copy of the batch each iteration, the copy is not timed
+    template<typename V, typename Sort>
+    void run(benchmark::State& state, const V& batch, Sort&& sort_it) {
+        V work;
+        for (auto _ : state) {
+            state.PauseTiming();
+            work = batch;
+            state.ResumeTiming();
+
+            sort_it(work);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * batch.size());
+    }
+}
+
+
+
+
+
+#pragma region Integers
+
+void sort_radix_u64(benchmark::State& state) {
+    run(state, random_keys(state.range(0)), [](auto& v) { sort::radix(v); });
+}
+
+void sort_sample_u64(benchmark::State& state) {
+    run(state, random_keys(state.range(0)), [](auto& v) { sort::sample(v); });
+}
+
+void std_sort_u64(benchmark::State& state) {
+    run(state, random_keys(state.range(0)), [](auto& v) { std::sort(v.begin(), v.end()); });
+}
+
+BENCHMARK(sort_radix_u64)->RangeMultiplier(8)->Range(1 << 20, ASL_BENCH_SORT_MAX)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(sort_sample_u64)->RangeMultiplier(8)->Range(1 << 20, ASL_BENCH_SORT_MAX)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(std_sort_u64)->RangeMultiplier(8)->Range(1 << 20, ASL_BENCH_SORT_MAX)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+#pragma endregion
+
+
+
+
+
+#pragma region Strings
+
+void sort_strings(benchmark::State& state) {
+    run(state, random_strings(state.range(0)), [](auto& v) { sort::strings(v); });
+}
+
+void std_sort_strings(benchmark::State& state) {
+    run(state, random_strings(state.range(0)), [](auto& v) {
+        std::sort(v.begin(), v.end(), [](const asl::containers::string& a, const asl::containers::string& b) {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](const char x, const char y) {
+                return static_cast<unsigned char>(x) < static_cast<unsigned char>(y);
+            });
+        });
+    });
+}
+
+// Strings are ~40 bytes each with their key, so they stop a step before the integers
+BENCHMARK(sort_strings)->RangeMultiplier(8)->Range(1 << 20, ASL_BENCH_SORT_MAX / 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(std_sort_strings)->RangeMultiplier(8)->Range(1 << 20, ASL_BENCH_SORT_MAX / 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+#pragma endregion
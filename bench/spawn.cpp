@@ -0,0 +1,60 @@
+// rt::process_starter spawn rate against fork + exec, from a parent holding `range(0)` MiB of touched memory
+
+#include ".include/rt/process_starter.hpp"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+#include <sys/wait.h>
+
+namespace {
+    // Resident memory the parent holds while spawning (fork copies its page tables, posix_spawn does not)
+    class ballast {
+        std::unique_ptr<char[]> bytes_;
+
+    public:
+        explicit ballast(const std::size_t mib) : bytes_(mib ? new char[mib << 20] : nullptr) {
+            if (mib) std::memset(bytes_.get(), 1, mib << 20);
+            benchmark::DoNotOptimize(bytes_.get());
+        }
+    };
+
+    constexpr const char* program = "/bin/true";
+}
+
+void process_starter_spawn(benchmark::State& state) {
+    const ballast held(state.range(0));
+    asl::rt::process_starter starter(program);
+    starter.redirect_stdout(asl::rt::redirect_null);
+
+    for (auto _ : state) {
+        if (!starter.run().success()) {
+            state.SkipWithError("child failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void fork_exec_spawn(benchmark::State& state) {
+    const ballast held(state.range(0));
+    char* const argv[] = { const_cast<char*>(program), nullptr };
+
+    for (auto _ : state) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            execv(program, argv);
+            _exit(127);
+        }
+
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || status != 0) {
+            state.SkipWithError("child failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(process_starter_spawn)->ArgName("rss_mib")->Arg(0)->Arg(512)->UseRealTime();
+BENCHMARK(fork_exec_spawn)->ArgName("rss_mib")->Arg(0)->Arg(512)->UseRealTime();
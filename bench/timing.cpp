@@ -0,0 +1,140 @@
+// tm::real_clock per-call cost against std::chrono, and tm::timer_wheel with 1M concurrent timers
+
+#include ".include/tm/real_clock.hpp"
+#include ".include/tm/timer_wheel.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#pragma region Clock
+
+void real_clock_now(benchmark::State& state) {
+    asl::tm::real_clock::now(); // Calibrates on first use
+    for (auto _ : state)
+        benchmark::DoNotOptimize(asl::tm::real_clock::now());
+    state.counters["uses_tsc"] = asl::tm::real_clock::uses_tsc();
+}
+
+void real_clock_coarse_now(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(asl::tm::real_clock::coarse_now());
+}
+
+void real_clock_cycles(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(asl::tm::real_clock::cycles());
+}
+
+void steady_clock_now(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+}
+
+BENCHMARK(real_clock_now);
+BENCHMARK(real_clock_coarse_now);
+BENCHMARK(real_clock_cycles);
+BENCHMARK(steady_clock_now);
+
+#pragma endregion
+
+
+
+
+
+#pragma region Timer wheel
+
+namespace {
+    constexpr std::size_t timers = 1'000'000;
+
+    // Per-connection style timeouts: 1 tick to ~1 minute at 1 ms
+    std::vector<uint64_t> delays() {
+        std::mt19937_64 rng(7);
+        std::vector<uint64_t> all(timers);
+        for (auto& each : all) each = 1 + rng() % 60'000;
+        return all;
+    }
+
+    // Which timers get cancelled: `percent` of them, spread out
+    std::vector<bool> cancelled(const int percent) {
+        std::mt19937_64 rng(11);
+        std::vector<bool> all(timers);
+        for (std::size_t i = 0; i < timers; ++i) all[i] = static_cast<int>(rng() % 100) < percent;
+        return all;
+    }
+}
+
+// Schedule 1M timers, cancel `range(0)` percent of them, fire the rest
+void timer_wheel_churn(benchmark::State& state) {
+    const std::vector<uint64_t> delay = delays();
+    const std::vector<bool> cancel = cancelled(state.range(0));
+    std::vector<asl::tm::timer_handle> handles(timers);
+    std::size_t fired = 0;
+
+    for (auto _ : state) {
+        asl::tm::timer_wheel wheel(std::chrono::milliseconds(1), timers);
+
+        for (std::size_t i = 0; i < timers; ++i)
+            handles[i] = wheel.schedule_ticks(delay[i], [&fired] { ++fired; });
+        for (std::size_t i = 0; i < timers; ++i)
+            if (cancel[i]) wheel.cancel(handles[i]);
+        wheel.advance_ticks_to(60'001);
+    }
+    state.SetItemsProcessed(state.iterations() * timers);
+    state.counters["fired"] = benchmark::Counter(static_cast<double>(fired), benchmark::Counter::kAvgIterations);
+}
+
+// Every timer pushed back once, like a keep-alive refreshed on traffic
+void timer_wheel_reschedule(benchmark::State& state) {
+    const std::vector<uint64_t> delay = delays();
+    std::vector<asl::tm::timer_handle> handles(timers);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        asl::tm::timer_wheel wheel(std::chrono::milliseconds(1), timers);
+        for (std::size_t i = 0; i < timers; ++i)
+            handles[i] = wheel.schedule_ticks(delay[i], [] {});
+        state.ResumeTiming();
+
+        for (std::size_t i = 0; i < timers; ++i)
+            wheel.reschedule_ticks(handles[i], delay[timers - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations() * timers);
+}
+
+// What the wheel replaces: a binary heap of deadlines, cancelled entries skipped when they come up
+void timer_heap_churn(benchmark::State& state) {
+    const std::vector<uint64_t> delay = delays();
+    const std::vector<bool> cancel = cancelled(state.range(0));
+    std::vector<std::function<void()>> callbacks(timers);
+    std::size_t fired = 0;
+
+    using entry = std::pair<uint64_t, uint32_t>; // Deadline, index
+    for (auto _ : state) {
+        std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+
+        for (std::size_t i = 0; i < timers; ++i) {
+            callbacks[i] = [&fired] { ++fired; };
+            heap.emplace(delay[i], static_cast<uint32_t>(i));
+        }
+        for (std::size_t i = 0; i < timers; ++i)
+            if (cancel[i]) callbacks[i] = nullptr;
+        while (!heap.empty()) {
+            const uint32_t i = heap.top().second;
+            heap.pop();
+            if (callbacks[i]) callbacks[i]();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * timers);
+    state.counters["fired"] = benchmark::Counter(static_cast<double>(fired), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(timer_wheel_churn)->ArgName("cancel%")->Arg(50)->Arg(90)->Unit(benchmark::kMillisecond);
+BENCHMARK(timer_heap_churn)->ArgName("cancel%")->Arg(50)->Arg(90)->Unit(benchmark::kMillisecond);
+BENCHMARK(timer_wheel_reschedule)->Unit(benchmark::kMillisecond);
+
+#pragma endregion
@@ -0,0 +1,51 @@
+// rt::trace per-event cost: compiled out, compiled in but not recording, and recording (configure with -DASL_TRACE=ON for the last two)
+
+#include ".include/rt/trace.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+
+void trace_span_idle(benchmark::State& state) {
+    for (auto _ : state) {
+        ASL_TRACE_SPAN("bench::idle");
+        benchmark::ClobberMemory();
+    }
+    state.counters["compiled_in"] = asl::rt::trace::enabled;
+}
+
+void trace_span_recording(benchmark::State& state) {
+    const auto ring = std::filesystem::temp_directory_path() / "asl_bench_trace.ring";
+    if (!asl::rt::trace::start(ring.string())) {
+        state.SkipWithError("built without ASL_TRACE");
+        return;
+    }
+
+    for (auto _ : state) {
+        ASL_TRACE_SPAN("bench::span");
+        benchmark::ClobberMemory();
+    }
+
+    asl::rt::trace::stop();
+    std::filesystem::remove(ring);
+}
+
+void trace_counter_recording(benchmark::State& state) {
+    const auto ring = std::filesystem::temp_directory_path() / "asl_bench_trace.ring";
+    if (!asl::rt::trace::start(ring.string())) {
+        state.SkipWithError("built without ASL_TRACE");
+        return;
+    }
+
+    int64_t value = 0;
+    for (auto _ : state) {
+        ASL_TRACE_COUNTER("bench::counter", ++value);
+        benchmark::ClobberMemory();
+    }
+
+    asl::rt::trace::stop();
+    std::filesystem::remove(ring);
+}
+
+BENCHMARK(trace_span_idle);
+BENCHMARK(trace_span_recording);
+BENCHMARK(trace_counter_recording);
@@ -0,0 +1,198 @@
+// math::trig batch functions: throughput per element, against libm one call at a time
+// @note Each benchmark also reports `max_ulp` and `max_rel`, the largest errors over its inputs against a long double reference
+//       (the fast tier is specified in relative error, so its `max_ulp` is large for double)
+
+#include ".include/math/trigonometry.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    namespace trig = asl::math::trig;
+
+    enum function_ { f_sin, f_cos, f_tan, f_exp, f_log, f_atan2 };
+
+    constexpr std::size_t batch = 1 << 14;
+
+
+
+    // Inputs where each function is mostly used: a few periods for sin / cos / tan, the whole range for exp / log
+    template<typename T>
+    void inputs(const function_ f, std::vector<T>& x, std::vector<T>& y) {
+        std::mt19937_64 rng(f);
+        x.resize(batch);
+        y.resize(batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+            switch (f) {
+                case f_exp: x[i] = std::uniform_real_distribution<T>(sizeof(T) == 4 ? -87 : -708, sizeof(T) == 4 ? 88 : 709)(rng); break;
+                case f_log: x[i] = std::exp(std::uniform_real_distribution<T>(-80, 80)(rng)); break;
+                default: x[i] = std::uniform_real_distribution<T>(-100, 100)(rng); break;
+            }
+            y[i] = std::uniform_real_distribution<T>(-100, 100)(rng);
+        }
+    }
+
+    // atan2 near the limits: both operands in the top binades (where a naive `a * 16` or `a + b` overflows), a quarter with a tiny ratio
+    template<typename T>
+    void limit_inputs(std::vector<T>& x, std::vector<T>& y) {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<T> unit(-1, 1);
+        constexpr T top = std::numeric_limits<T>::max();
+        x.resize(batch);
+        y.resize(batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+            x[i] = top * unit(rng);
+            y[i] = top * unit(rng);
+            if (i % 4 == 0) y[i] = std::ldexp(y[i], -40);
+        }
+    }
+
+    template<typename T>
+    void batch_call(const function_ f, const std::vector<T>& x, const std::vector<T>& y, std::vector<T>& out, const trig::accuracy_ accuracy) {
+        switch (f) {
+            case f_sin: trig::sin(x, out, accuracy); break;
+            case f_cos: trig::cos(x, out, accuracy); break;
+            case f_tan: trig::tan(x, out, accuracy); break;
+            case f_exp: trig::exp(x, out, accuracy); break;
+            case f_log: trig::log(x, out, accuracy); break;
+            case f_atan2: trig::atan2(y, x, out, accuracy); break;
+        }
+    }
+
+    template<typename T>
+    T libm(const function_ f, const T x, const T y) {
+        switch (f) {
+            case f_sin: return std::sin(x);
+            case f_cos: return std::cos(x);
+            case f_tan: return std::tan(x);
+            case f_exp: return std::exp(x);
+            case f_log: return std::log(x);
+            case f_atan2: return std::atan2(y, x);
+        }
+        return 0;
+    }
+
+    long double reference(const function_ f, const long double x, const long double y) {
+        switch (f) {
+            case f_sin: return sinl(x);
+            case f_cos: return cosl(x);
+            case f_tan: return tanl(x);
+            case f_exp: return expl(x);
+            case f_log: return logl(x);
+            case f_atan2: return atan2l(y, x);
+        }
+        return 0;
+    }
+
+    // Distance to `exact` in units of the last place of T
+    template<typename T>
+    double ulp_error(const T got, const long double exact) {
+        if (!std::isfinite(exact) || !std::isfinite(static_cast<T>(exact)))
+            return got == static_cast<T>(exact) || (std::isnan(got) && std::isnan(exact)) ? 0 : std::numeric_limits<double>::infinity();
+
+        int e;
+        std::frexp(exact == 0 ? std::numeric_limits<T>::min() : static_cast<T>(exact), &e);
+        const int digits = std::numeric_limits<T>::digits;
+        const long double ulp = std::ldexp(1.0L, std::max(e - digits, std::numeric_limits<T>::min_exponent - digits));
+        return static_cast<double>(std::fabs(static_cast<long double>(got) - exact) / ulp);
+    }
+
+    template<typename T>
+    void worst_errors(const function_ f, const std::vector<T>& x, const std::vector<T>& y, const std::vector<T>& out, double& worst_ulp, double& worst_rel) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            const long double exact = reference(f, x[i], y[i]);
+            worst_ulp = std::max(worst_ulp, ulp_error(out[i], exact));
+            if (exact != 0 && std::isfinite(exact))
+                worst_rel = std::max(worst_rel, static_cast<double>(std::fabs((out[i] - exact) / exact)));
+        }
+    }
+
+    template<typename T>
+    void report_errors(benchmark::State& state, const function_ f, const std::vector<T>& x, const std::vector<T>& y, const std::vector<T>& out) {
+        double worst_ulp = 0, worst_rel = 0;
+        worst_errors(f, x, y, out, worst_ulp, worst_rel);
+        state.counters["max_ulp"] = worst_ulp;
+        state.counters["max_rel"] = worst_rel;
+    }
+}
+
+
+
+
+
+template<typename T>
+void trig_batch(benchmark::State& state, const function_ f, const trig::accuracy_ accuracy, const bool limits) {
+    std::vector<T> x, y, out(batch);
+    if (limits) limit_inputs(x, y);
+    else inputs(f, x, y);
+
+    for (auto _ : state) {
+        batch_call(f, x, y, out, accuracy);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+
+    report_errors(state, f, x, y, out);
+}
+
+// Both outputs checked, the errors are the worst of the two
+template<typename T>
+void trig_sincos(benchmark::State& state, const trig::accuracy_ accuracy) {
+    std::vector<T> x, y, s(batch), c(batch);
+    inputs(f_sin, x, y);
+
+    for (auto _ : state) {
+        trig::sincos(x, s, c, accuracy);
+        benchmark::DoNotOptimize(s.data());
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+
+    double worst_ulp = 0, worst_rel = 0;
+    worst_errors(f_sin, x, y, s, worst_ulp, worst_rel);
+    worst_errors(f_cos, x, y, c, worst_ulp, worst_rel);
+    state.counters["max_ulp"] = worst_ulp;
+    state.counters["max_rel"] = worst_rel;
+}
+
+template<typename T>
+void trig_libm(benchmark::State& state, const function_ f) {
+    std::vector<T> x, y, out(batch);
+    inputs(f, x, y);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) out[i] = libm(f, x[i], y[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+
+    report_errors(state, f, x, y, out);
+}
+
+// trig_sin<float>/4ulp, trig_sin<float>/libm..., trig_atan2<float>/4ulp/limits, trig_sincos<float>/4ulp
+const bool registered = [] {
+    static constexpr const char* functions[] = { "sin", "cos", "tan", "exp", "log", "atan2" };
+    static constexpr const char* tiers[] = { "fast", "4ulp", "1ulp" };
+
+    for (const function_ f : { f_sin, f_cos, f_tan, f_exp, f_log, f_atan2 }) {
+        const std::string name = std::string("trig_") + functions[f];
+        for (const trig::accuracy_ a : { trig::accuracy_fast, trig::accuracy_4ulp, trig::accuracy_1ulp }) {
+            benchmark::RegisterBenchmark((name + "<float>/" + tiers[a]).c_str(), trig_batch<float>, f, a, false);
+            benchmark::RegisterBenchmark((name + "<double>/" + tiers[a]).c_str(), trig_batch<double>, f, a, false);
+        }
+        benchmark::RegisterBenchmark((name + "<float>/libm").c_str(), trig_libm<float>, f);
+        benchmark::RegisterBenchmark((name + "<double>/libm").c_str(), trig_libm<double>, f);
+    }
+
+    for (const trig::accuracy_ a : { trig::accuracy_fast, trig::accuracy_4ulp, trig::accuracy_1ulp }) {
+        benchmark::RegisterBenchmark((std::string("trig_atan2<float>/") + tiers[a] + "/limits").c_str(), trig_batch<float>, f_atan2, a, true);
+        benchmark::RegisterBenchmark((std::string("trig_atan2<double>/") + tiers[a] + "/limits").c_str(), trig_batch<double>, f_atan2, a, true);
+        benchmark::RegisterBenchmark((std::string("trig_sincos<float>/") + tiers[a]).c_str(), trig_sincos<float>, a);
+        benchmark::RegisterBenchmark((std::string("trig_sincos<double>/") + tiers[a]).c_str(), trig_sincos<double>, a);
+    }
+    return true;
+}();
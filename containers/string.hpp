@@ -7,9 +7,9 @@ namespace asl::containers {
     #pragma region Basic string
     // String
     template<base::char_like _char_type>
-    class basic_string final : public base::contiguous_storage<_char_type> {
+    class basic_string final : public base::contiguous_storage<_char_type, basic_string<_char_type>> {
     private:
-        using __l_base_type = base::contiguous_storage<_char_type>;
+        using __l_base_type = base::contiguous_storage<_char_type, basic_string<_char_type>>;
         using __l_self_type = basic_string<_char_type>;
         using __l_self_rtype = __l_self_type&;
         using __l_self_crtype = const __l_self_type&;
@@ -24,7 +24,7 @@ namespace asl::containers {
         #pragma region Setup
         basic_string() {
             this->__l_fn_realloc(1);
-            this->used_slots_ = 1;
+            this->used_slots_ = 0;
             this->data_[0] = _char_type{}; // Null-termination
         }
 
@@ -40,6 +40,7 @@ namespace asl::containers {
             std::copy_n(c_str, n, this->data_);
             this->used_slots_ = n;
             this->data_[n] = _char_type{};
+            this->__l_fn_copied(n);
         }
 
         // You know what this does if you know `std::string::operator=()`
@@ -49,6 +50,7 @@ namespace asl::containers {
             std::copy_n(c_str, n, this->data_);
             this->used_slots_ = n;
             this->data_[n] = _char_type{};
+            this->__l_fn_copied(n);
             return *this;
         }
 
@@ -69,15 +71,22 @@ namespace asl::containers {
 
 
         // Construct.
-        basic_string(__l_self_crtype other) {
-            this->__l_fn_realloc(other.used_slots_);
-            std::copy_n(other.data_, other.used_slots_, this->data_);
+        basic_string(__l_self_crtype other) : __l_base_type() {
+            this->__l_fn_realloc(other.used_slots_ + 1);
+            std::copy_n(other.data_, other.used_slots_ + 1, this->data_); // With the null-terminator
+            this->used_slots_ = other.used_slots_;
+            this->__l_fn_copied(other.used_slots_);
         }
 
         // You know what this does if you know `std::string::operator=()`
         __l_self_rtype operator=(__l_self_crtype other) {
-            this->__l_fn_realloc(other.used_slots_);
-            std::copy_n(other.data_, other.used_slots_, this->data_);
+            if (this == &other)
+                return *this;
+
+            this->__l_fn_realloc(other.used_slots_ + 1);
+            std::copy_n(other.data_, other.used_slots_ + 1, this->data_); // With the null-terminator
+            this->used_slots_ = other.used_slots_;
+            this->__l_fn_copied(other.used_slots_);
             return *this;
         }
 
@@ -90,9 +99,11 @@ namespace asl::containers {
         // @param end End iterator (.end)
         basic_string(const_iterator start, const_iterator end) {
             const size_t count = end - start;
-            this->__l_fn_realloc(count);
+            this->__l_fn_realloc(count + 1);
             std::copy(start, end, this->data_);
             this->used_slots_ = count;
+            this->__l_fn_copied(count);
+            this->data_[count] = _char_type{};
         }
 
 
@@ -107,6 +118,7 @@ namespace asl::containers {
             this->__l_fn_realloc(count + 1);
             std::uninitialized_fill_n(this->data_, count, one_char);            
             this->used_slots_ = count;
+            this->__l_fn_copied(count);
             this->data_[count] = _char_type{};
         }
         #pragma endregion
@@ -119,7 +131,7 @@ namespace asl::containers {
                 return false;
 
             for (size_t i = 0; i < this->used_slots_; ++i) {
-                if (this->memory_[i] != other.memory_[i])
+                if (this->data_[i] != other.data_[i])
                     return false;
             }
 
@@ -133,7 +145,26 @@ namespace asl::containers {
         #pragma region Mutators
         // Append / Concatenate string
         inline iterator append(__l_self_crtype other) {
-            return this->insert(this->end(), other.begin(), other.end());
+            const size_t needed = this->used_slots_ + other.used_slots_ + 1; // With the null-terminator
+            if (needed > this->slots_)
+                this->reserve(needed - this->slots_);
+
+            const iterator first_iterator = this->insert(this->end(), other.begin(), other.end());
+            this->data_[this->used_slots_] = _char_type{};
+            return first_iterator;
+        }
+
+        // Append character
+        // @param ch Character to add
+        // @param rep Repetition
+        inline iterator push_back(const _char_type ch, const size_t rep = 1) {
+            const size_t needed = this->used_slots_ + rep + 1; // With the null-terminator
+            if (needed > this->slots_)
+                this->reserve(needed - this->slots_);
+
+            const iterator first_iterator = __l_base_type::push_back(ch, rep);
+            this->data_[this->used_slots_] = _char_type{};
+            return first_iterator;
         }
 
 
@@ -157,15 +188,15 @@ namespace asl::containers {
 
 
         // Append / Concatenate string (temporarily)
-        inline __l_self_type operator+(__l_self_crtype other) {
-            __l_self_type tmp(this->data_);
+        inline __l_self_type operator+(__l_self_crtype other) const {
+            __l_self_type tmp(*this);
             tmp.append(other);
             return tmp;
         }
 
         // Append character (temporarily)
-        inline __l_self_type operator+(const _char_type ch) {
-            __l_self_type tmp(this->data_);
+        inline __l_self_type operator+(const _char_type ch) const {
+            __l_self_type tmp(*this);
             tmp.push_back(ch);
             return tmp;
         }
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "../base/contiguous_storage.hpp"
+#include <algorithm>
+#include <initializer_list>
 
 namespace asl::containers {
     // Vector / Dynamic array
     template<typename T>
-    class vector final : public base::contiguous_storage<T> {
+    class vector final : public base::contiguous_storage<T, vector<T>> {
     private:
-        using __l_base_type = base::contiguous_storage<T>;
+        using __l_base_type = base::contiguous_storage<T, vector<T>>;
         using __l_self_type = vector<T>;
         using __l_self_rtype = __l_self_type&;
         using __l_self_crtype = const __l_self_type&;
@@ -47,16 +49,24 @@ namespace asl::containers {
 
 
         // Construct by another one
-        vector(__l_self_crtype other) {
+        vector(__l_self_crtype other) : __l_base_type() {
             this->__l_fn_realloc(other.used_slots_);
-            std::copy_n(other.data_, other.used_slots_, this->data_);
+            std::uninitialized_copy_n(other.data_, other.used_slots_, this->data_);
+            this->used_slots_ = other.used_slots_;
+            this->__l_fn_copied(other.used_slots_);
         }
 
 
         // Assign by another one
-        __l_self_rtype operator=(__l_self_rtype other) {
+        __l_self_rtype operator=(__l_self_crtype other) {
+            if (this == &other)
+                return *this;
+
+            this->clear();
             this->__l_fn_realloc(other.used_slots_);
-            std::copy_n(other.data_, other.used_slots_, this->data_);
+            std::uninitialized_copy_n(other.data_, other.used_slots_, this->data_);
+            this->used_slots_ = other.used_slots_;
+            this->__l_fn_copied(other.used_slots_);
             return *this;
         }
 
@@ -70,10 +80,11 @@ namespace asl::containers {
         // @param start Start iterator (.begin)
         // @param end End iterator (.end)
         explicit vector(const_iterator first, const_iterator last) {
-            const size_t count = first - last;
+            const size_t count = last - first;
             this->__l_fn_realloc(count);
             std::uninitialized_copy(first, last, this->data_);
             this->used_slots_ = count;
+            this->__l_fn_copied(count);
         }
 
 
@@ -83,10 +94,12 @@ namespace asl::containers {
         // Fill in with `one_element`
         // @param one_element The element to spawn in this container
         // @param count How many times to spawn it
-        vector(const T& one_element, const size_t count = 1) {
+        // @note `count` has no default, `vector(n)` reserves instead
+        vector(const T& one_element, const size_t count) {
             this->__l_fn_realloc(count);
             std::uninitialized_fill_n(this->data_, count, one_element);
             this->used_slots_ = count;
+            this->__l_fn_copied(count);
         }
 
 
@@ -99,13 +112,16 @@ namespace asl::containers {
             this->__l_fn_realloc(il.size());
             std::uninitialized_copy(il.begin(), il.end(), this->data_);
             this->used_slots_ = il.size();
+            this->__l_fn_copied(il.size());
         }
 
         // Assign by initializer-list
         __l_self_rtype operator=(const std::initializer_list<T>& il) {
+            this->clear();
             this->__l_fn_realloc(il.size());
             std::uninitialized_copy(il.begin(), il.end(), this->data_);
             this->used_slots_ = il.size();
+            this->__l_fn_copied(il.size());
             return *this;
         }
 